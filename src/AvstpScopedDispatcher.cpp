@@ -0,0 +1,90 @@
+/*****************************************************************************
+
+        AvstpScopedDispatcher.cpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "AvstpScopedDispatcher.h"
+#include "AvstpWrapper.h"
+
+#include <stdexcept>
+
+#include <cassert>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Throws: std::runtime_error if the dispatcher cannot be created.
+AvstpScopedDispatcher::AvstpScopedDispatcher (AvstpWrapper &avstp)
+:	_avstp (avstp)
+,	_td_ptr (avstp.create_dispatcher ())
+{
+	if (_td_ptr == 0)
+	{
+		throw std::runtime_error (
+			"AvstpScopedDispatcher: cannot create a task dispatcher."
+		);
+	}
+}
+
+
+
+AvstpScopedDispatcher::~AvstpScopedDispatcher ()
+{
+	// Does nothing if the completion has already been waited for.
+	try
+	{
+		_avstp.wait_completion (_td_ptr);
+	}
+	catch (...)
+	{
+		// Nothing
+	}
+
+	_avstp.destroy_dispatcher (_td_ptr);
+	_td_ptr = 0;
+}
+
+
+
+avstp_TaskDispatcher *	AvstpScopedDispatcher::get_ptr () const
+{
+	assert (_td_ptr != 0);
+
+	return (_td_ptr);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,101 @@
+/*****************************************************************************
+
+        AvstpScopedDispatcher.h
+        Author: agent, 2026
+
+Creates an AVSTP task dispatcher and destroys it when leaving the scope.
+
+Before destroying the dispatcher, the destructor waits for the completion of
+the tasks, if not done yet. Therefore it is safe to leave the scope with an
+exception, for example when wait_completion() rethrows the exception of a
+task: the tasks using data from the scope are finished and the dispatcher is
+not leaked. Exceptions thrown by the tasks are discarded at this point.
+
+The object must be declared after the data used by the tasks, so it is
+destroyed first.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (AvstpScopedDispatcher_HEADER_INCLUDED)
+#define	AvstpScopedDispatcher_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma once
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "avstp.h"
+
+
+
+class AvstpWrapper;
+
+class AvstpScopedDispatcher
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	explicit       AvstpScopedDispatcher (AvstpWrapper &avstp);
+	               ~AvstpScopedDispatcher ();
+
+	avstp_TaskDispatcher *
+	               get_ptr () const;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	AvstpWrapper & _avstp;
+	avstp_TaskDispatcher *
+	               _td_ptr;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               AvstpScopedDispatcher ()                                   = delete;
+	               AvstpScopedDispatcher (const AvstpScopedDispatcher &other) = delete;
+	AvstpScopedDispatcher &
+	               operator = (const AvstpScopedDispatcher &other)            = delete;
+	bool           operator == (const AvstpScopedDispatcher &other) const     = delete;
+	bool           operator != (const AvstpScopedDispatcher &other) const     = delete;
+
+};	// class AvstpScopedDispatcher
+
+
+
+//#include "AvstpScopedDispatcher.hpp"
+
+
+
+#endif	// AvstpScopedDispatcher_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,105 @@
+/*****************************************************************************
+
+        AvstpStats.cpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "AvstpStats.h"
+
+#include <cassert>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	AvstpStats::clear ()
+{
+	_nbr_tasks  = 0;
+	_nbr_steals = 0;
+	_wait_ns    = 0;
+	_run_ns     = 0;
+	_run_hist.fill (0);
+}
+
+
+
+void	AvstpStats::add (const AvstpStats &other)
+{
+	_nbr_tasks  += other._nbr_tasks;
+	_nbr_steals += other._nbr_steals;
+	_wait_ns    += other._wait_ns;
+	_run_ns     += other._run_ns;
+	for (int bin = 0; bin < NBR_HIST_BINS; ++bin)
+	{
+		_run_hist [bin] += other._run_hist [bin];
+	}
+}
+
+
+
+// Counts a completed task. _nbr_tasks is not updated, it is counted when
+// the task is enqueued.
+void	AvstpStats::add_task (int64_t wait_ns, int64_t run_ns, bool steal_flag)
+{
+	assert (wait_ns >= 0);
+	assert (run_ns >= 0);
+
+	_wait_ns += wait_ns;
+	_run_ns  += run_ns;
+	++ _run_hist [find_hist_bin (run_ns)];
+	if (steal_flag)
+	{
+		++ _nbr_steals;
+	}
+}
+
+
+
+int	AvstpStats::find_hist_bin (int64_t dur_ns)
+{
+	assert (dur_ns >= 0);
+
+	int64_t        dur_us = dur_ns / 1000;
+	int            bin    = 0;
+	while (dur_us >= 2 && bin < NBR_HIST_BINS - 1)
+	{
+		dur_us >>= 1;
+		++ bin;
+	}
+
+	return (bin);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,99 @@
+/*****************************************************************************
+
+        AvstpStats.h
+        Author: agent, 2026
+
+Scheduling counters collected by the built-in thread pool for a task
+dispatcher, when enabled with AvstpWrapper::add_stats_user().
+
+Times are in nanoseconds. The histogram of the task run times has
+logarithmic bins: bin 0 counts the tasks shorter than 2 us, bin k the tasks
+in [2^k ; 2^(k+1)[ us, and the last bin everything above.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (AvstpStats_HEADER_INCLUDED)
+#define	AvstpStats_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma once
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <array>
+
+#include <cstdint>
+
+
+
+class AvstpStats
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static const int  NBR_HIST_BINS = 16;
+
+	typedef std::array <int64_t, NBR_HIST_BINS> Histogram;
+
+	void           clear ();
+	void           add (const AvstpStats &other);
+	void           add_task (int64_t wait_ns, int64_t run_ns, bool steal_flag);
+
+	static int     find_hist_bin (int64_t dur_ns);
+
+	int64_t        _nbr_tasks  = 0;  // Enqueued tasks
+	int64_t        _nbr_steals = 0;  // Tasks run by a worker from another queue than its own
+	int64_t        _wait_ns    = 0;  // Total time spent by the tasks in the queues
+	int64_t        _run_ns     = 0;  // Total run time of the tasks
+	Histogram      _run_hist   = Histogram ();
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	bool           operator == (const AvstpStats &other) const = delete;
+	bool           operator != (const AvstpStats &other) const = delete;
+
+};	// class AvstpStats
+
+
+
+//#include "AvstpStats.hpp"
+
+
+
+#endif	// AvstpStats_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
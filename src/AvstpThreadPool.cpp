@@ -0,0 +1,553 @@
+/*****************************************************************************
+
+        AvstpThreadPool.cpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "conc/ObjFactoryDef.h"
+#include "AvstpThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <cassert>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*
+==============================================================================
+Name: ctor
+Description:
+	Creates the pool and starts the worker threads.
+Input parameters:
+	- nbr_threads: total number of threads working on the tasks, including
+		the thread waiting for the completion. 0 = as many threads as logical
+		processors, or as processors in the list for CpuTopology::Policy_LIST.
+	- policy: placement of the worker threads on the logical processors.
+	- cpu_list: processors for CpuTopology::Policy_LIST, in the placement
+		order.
+Throws: std::system_error if a thread cannot be started, memory allocation
+	exceptions.
+==============================================================================
+*/
+
+AvstpThreadPool::AvstpThreadPool (int nbr_threads, CpuTopology::Policy policy, const std::vector <int> &cpu_list)
+:	_nbr_threads (nbr_threads)
+,	_task_pool ()
+,	_queue_arr ()
+,	_place_arr ()
+,	_worker_arr ()
+,	_disp_pool ()
+,	_nbr_queued (0)
+,	_nbr_sleepers (0)
+,	_queue_rr (0)
+,	_quit_flag (0)
+,	_sleep_mutex ()
+,	_sleep_cond ()
+,	_stats_flag (0)
+,	_stats_mutex ()
+,	_idle_arr ()
+{
+	assert (nbr_threads >= 0);
+
+	assert (policy >= 0);
+	assert (policy < CpuTopology::Policy_NBR_ELT);
+
+	if (_nbr_threads <= 0)
+	{
+		if (policy == CpuTopology::Policy_LIST && ! cpu_list.empty ())
+		{
+			_nbr_threads = int (cpu_list.size ());
+		}
+		else
+		{
+			_nbr_threads = int (std::thread::hardware_concurrency ());
+		}
+	}
+	_nbr_threads = std::max (_nbr_threads, 1);
+
+	const int      nbr_workers = _nbr_threads - 1;
+	const int      nbr_queues  = std::max (nbr_workers, 1);
+
+	CpuTopology::use_instance ().build_placement (
+		_place_arr, nbr_queues, policy, cpu_list
+	);
+
+	_task_pool.expand_to (1024);
+	_disp_pool.set_factory (conc::ObjFactoryDef <Dispatcher>::_fact);
+
+	for (int q = 0; q < nbr_queues; ++q)
+	{
+		_queue_arr.push_back (TaskQueueUPtr (new TaskQueue));
+	}
+	_idle_arr.resize (nbr_workers, 0);
+
+	try
+	{
+		for (int w = 0; w < nbr_workers; ++w)
+		{
+			_worker_arr.push_back (std::thread (&AvstpThreadPool::worker_loop, this, w));
+		}
+	}
+	catch (...)
+	{
+		_quit_flag = 1;
+		{
+			std::lock_guard <std::mutex>   lock (_sleep_mutex);
+			_sleep_cond.notify_all ();
+		}
+		for (auto &thread : _worker_arr)
+		{
+			thread.join ();
+		}
+
+		throw;
+	}
+}
+
+
+
+AvstpThreadPool::~AvstpThreadPool ()
+{
+	_quit_flag = 1;
+	{
+		std::lock_guard <std::mutex>   lock (_sleep_mutex);
+		_sleep_cond.notify_all ();
+	}
+	for (auto &thread : _worker_arr)
+	{
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
+	}
+}
+
+
+
+int	AvstpThreadPool::get_nbr_threads () const
+{
+	return (_nbr_threads);
+}
+
+
+
+avstp_TaskDispatcher *	AvstpThreadPool::create_dispatcher ()
+{
+	Dispatcher *   disp_ptr = _disp_pool.take_obj ();
+	if (disp_ptr == 0)
+	{
+		throw std::runtime_error (
+			"AvstpThreadPool: cannot allocate a task dispatcher."
+		);
+	}
+	assert (disp_ptr->_nbr_pending == 0);
+
+	disp_ptr->_stats_flag = (_stats_flag != 0);
+	disp_ptr->_stats.clear ();
+
+	return (reinterpret_cast <avstp_TaskDispatcher *> (disp_ptr));
+}
+
+
+
+void	AvstpThreadPool::destroy_dispatcher (avstp_TaskDispatcher *td_ptr)
+{
+	Dispatcher &   disp = use_dispatcher (td_ptr);
+	assert (disp._nbr_pending == 0);
+
+	_disp_pool.return_obj (disp);
+}
+
+
+
+int	AvstpThreadPool::enqueue_task (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr)
+{
+	if (td_ptr == 0 || task_ptr == 0)
+	{
+		return (avstp_Err_INVALID_ARG);
+	}
+
+	TaskCell *     cell_ptr = 0;
+	try
+	{
+		cell_ptr = _task_pool.take_cell (true);
+	}
+	catch (...)
+	{
+		cell_ptr = 0;
+	}
+	if (cell_ptr == 0)
+	{
+		// Not fatal, the task is run inline like in the mono-threaded
+		// fallback. We just lose some parallelism.
+		task_ptr (td_ptr, user_data_ptr);
+		return (avstp_Err_OK);
+	}
+
+	Dispatcher &   disp = use_dispatcher (td_ptr);
+	cell_ptr->_val._disp_ptr      = &disp;
+	cell_ptr->_val._task_ptr      = task_ptr;
+	cell_ptr->_val._user_data_ptr = user_data_ptr;
+	cell_ptr->_val._enq_ns        = 0;
+	if (disp._stats_flag)
+	{
+		cell_ptr->_val._enq_ns = get_time_ns ();
+		std::lock_guard <std::mutex>   lock (disp._mutex);
+		++ disp._stats._nbr_tasks;
+	}
+
+	// The dispatcher count must be updated before the task becomes visible
+	++ disp._nbr_pending;
+
+	const int      queue_index = find_queue_for_current_thread ();
+	_queue_arr [queue_index]->enqueue (*cell_ptr);
+	++ _nbr_queued;
+
+	// Wakes up a worker if any is sleeping. The sleeper count is incremented
+	// by the workers before checking _nbr_queued, so at least one side sees
+	// the other's modification.
+	if (_nbr_sleepers > 0)
+	{
+		std::lock_guard <std::mutex>   lock (_sleep_mutex);
+		_sleep_cond.notify_one ();
+	}
+
+	return (avstp_Err_OK);
+}
+
+
+
+/*
+==============================================================================
+Name: wait_completion
+Description:
+	Waits for all the tasks enqueued on the dispatcher to be completed. In the
+	meantime, the calling thread processes the queued tasks, whatever their
+	dispatcher.
+	If one of the dispatcher tasks has thrown an exception, it is rethrown
+	here once all the tasks are finished.
+Input parameters:
+	- td_ptr: the dispatcher
+Returns: avstp_Err_OK
+Throws: any exception thrown by a task of the dispatcher.
+==============================================================================
+*/
+
+int	AvstpThreadPool::wait_completion (avstp_TaskDispatcher *td_ptr)
+{
+	if (td_ptr == 0)
+	{
+		return (avstp_Err_INVALID_ARG);
+	}
+
+	Dispatcher &   disp = use_dispatcher (td_ptr);
+	const int      queue_start = find_queue_for_current_thread ();
+	const std::chrono::microseconds  poll_dur (+WAIT_POLL_US);
+
+	while (disp._nbr_pending > 0)
+	{
+		if (! run_one_task (queue_start))
+		{
+			// All the remaining tasks are being processed by other threads.
+			// Tasks could still be added by the running ones, so we don't
+			// block indefinitely.
+			std::unique_lock <std::mutex>   lock (disp._mutex);
+			if (disp._nbr_pending > 0)
+			{
+				disp._cond.wait_for (lock, poll_dur);
+			}
+		}
+	}
+
+	std::exception_ptr   exc_ptr;
+	{
+		std::lock_guard <std::mutex>   lock (disp._mutex);
+		std::swap (exc_ptr, disp._exc_ptr);
+	}
+	if (exc_ptr)
+	{
+		std::rethrow_exception (exc_ptr);
+	}
+
+	return (avstp_Err_OK);
+}
+
+
+
+// The flag is taken into account by the dispatchers created afterwards.
+// Clears the worker idle times when enabling the stats.
+void	AvstpThreadPool::set_stats_flag (bool flag)
+{
+	if (flag && _stats_flag == 0)
+	{
+		std::lock_guard <std::mutex>   lock (_stats_mutex);
+		std::fill (_idle_arr.begin (), _idle_arr.end (), int64_t (0));
+	}
+	_stats_flag = (flag) ? 1 : 0;
+}
+
+
+
+bool	AvstpThreadPool::get_stats_flag () const
+{
+	return (_stats_flag != 0);
+}
+
+
+
+// Must be called before destroying the dispatcher. The statistics are
+// complete only once wait_completion() has returned.
+void	AvstpThreadPool::get_dispatcher_stats (avstp_TaskDispatcher *td_ptr, AvstpStats &stats) const
+{
+	assert (td_ptr != 0);
+
+	Dispatcher &   disp = use_dispatcher (td_ptr);
+	std::lock_guard <std::mutex>   lock (disp._mutex);
+	stats = disp._stats;
+}
+
+
+
+// One value per worker thread, in nanoseconds. The thread waiting for the
+// completion is not a worker and is not listed.
+void	AvstpThreadPool::get_worker_idle_times (std::vector <int64_t> &idle_ns_arr) const
+{
+	std::lock_guard <std::mutex>   lock (_stats_mutex);
+	idle_ns_arr = _idle_arr;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	AvstpThreadPool::worker_loop (int index)
+{
+	assert (index >= 0);
+	assert (index < int (_queue_arr.size ()));
+
+	_cur_pool_ptr     = this;
+	_cur_worker_index = index;
+
+	// Pinning failures are not critical, the worker just runs unpinned.
+	if (_place_arr [index] >= 0)
+	{
+		CpuTopology::set_cur_thread_affinity (_place_arr [index]);
+	}
+
+	int            nbr_fails = 0;
+	int64_t        idle_beg  = -1;   // Start of the current idle period, -1 if working or not collecting stats
+	while (_quit_flag == 0)
+	{
+		if (run_one_task (index))
+		{
+			nbr_fails = 0;
+			if (idle_beg >= 0)
+			{
+				add_idle_time (index, get_time_ns () - idle_beg);
+				idle_beg = -1;
+			}
+		}
+		else
+		{
+			if (idle_beg < 0 && _stats_flag != 0)
+			{
+				idle_beg = get_time_ns ();
+			}
+
+			if (nbr_fails < SPIN_COUNT)
+			{
+				++ nbr_fails;
+				std::this_thread::yield ();
+			}
+			else
+			{
+				std::unique_lock <std::mutex>   lock (_sleep_mutex);
+				++ _nbr_sleepers;
+				while (_nbr_queued <= 0 && _quit_flag == 0)
+				{
+					_sleep_cond.wait (lock);
+				}
+				-- _nbr_sleepers;
+				nbr_fails = 0;
+			}
+		}
+	}
+
+	_cur_pool_ptr     = 0;
+	_cur_worker_index = -1;
+}
+
+
+
+// Returns false if no task could be found in the queues.
+bool	AvstpThreadPool::run_one_task (int queue_start)
+{
+	bool           steal_flag = false;
+	TaskCell *     cell_ptr   = pop_task (queue_start, steal_flag);
+	if (cell_ptr == 0)
+	{
+		return (false);
+	}
+	-- _nbr_queued;
+
+	const Task     task = cell_ptr->_val;
+	_task_pool.return_cell (*cell_ptr);
+	cell_ptr = 0;
+
+	Dispatcher &   disp = *task._disp_ptr;
+	const int64_t  beg_ns = (disp._stats_flag) ? get_time_ns () : 0;
+	try
+	{
+		task._task_ptr (
+			reinterpret_cast <avstp_TaskDispatcher *> (&disp),
+			task._user_data_ptr
+		);
+	}
+	catch (...)
+	{
+		std::lock_guard <std::mutex>   lock (disp._mutex);
+		if (! disp._exc_ptr)
+		{
+			disp._exc_ptr = std::current_exception ();
+		}
+	}
+
+	// Must be done before the pending count is updated, the dispatcher may
+	// not exist anymore after that.
+	if (disp._stats_flag)
+	{
+		const int64_t  end_ns = get_time_ns ();
+		std::lock_guard <std::mutex>   lock (disp._mutex);
+		disp._stats.add_task (
+			std::max (beg_ns - task._enq_ns, int64_t (0)),
+			end_ns - beg_ns,
+			steal_flag
+		);
+	}
+
+	conc::AioSub <int>   ftor_dec (1);
+	const int      nbr_left =
+		conc::AtomicIntOp::exec_new (disp._nbr_pending, ftor_dec);
+	assert (nbr_left >= 0);
+	if (nbr_left == 0)
+	{
+		// The dispatcher may be returned to the pool as soon as the waiting
+		// thread gets the lock, so this is the last access.
+		std::lock_guard <std::mutex>   lock (disp._mutex);
+		disp._cond.notify_all ();
+	}
+
+	return (true);
+}
+
+
+
+// Tries the given queue first, then steals from the other ones.
+// steal_flag is set if the task comes from another queue.
+AvstpThreadPool::TaskCell *	AvstpThreadPool::pop_task (int queue_start, bool &steal_flag)
+{
+	const int      nbr_queues = int (_queue_arr.size ());
+	assert (queue_start >= 0);
+	assert (queue_start < nbr_queues);
+
+	TaskCell *     cell_ptr = 0;
+	int            queue_index = queue_start;
+	for (int cnt = 0; cnt < nbr_queues && cell_ptr == 0; ++cnt)
+	{
+		cell_ptr   = _queue_arr [queue_index]->dequeue ();
+		steal_flag = (queue_index != queue_start);
+		++ queue_index;
+		if (queue_index >= nbr_queues)
+		{
+			queue_index = 0;
+		}
+	}
+
+	return (cell_ptr);
+}
+
+
+
+int	AvstpThreadPool::find_queue_for_current_thread ()
+{
+	if (_cur_pool_ptr == this)
+	{
+		return (_cur_worker_index);
+	}
+
+	const int      nbr_queues = int (_queue_arr.size ());
+	const int      rr = (_queue_rr ++) & 0x7FFFFFFF;
+
+	return (rr % nbr_queues);
+}
+
+
+
+void	AvstpThreadPool::add_idle_time (int index, int64_t dur_ns)
+{
+	assert (index >= 0);
+	assert (index < int (_idle_arr.size ()));
+	assert (dur_ns >= 0);
+
+	std::lock_guard <std::mutex>   lock (_stats_mutex);
+	_idle_arr [index] += dur_ns;
+}
+
+
+
+int64_t	AvstpThreadPool::get_time_ns ()
+{
+	return (int64_t (std::chrono::duration_cast <std::chrono::nanoseconds> (
+		Clock::now ().time_since_epoch ()
+	).count ()));
+}
+
+
+
+AvstpThreadPool::Dispatcher &	AvstpThreadPool::use_dispatcher (avstp_TaskDispatcher *td_ptr)
+{
+	assert (td_ptr != 0);
+
+	return (*reinterpret_cast <Dispatcher *> (td_ptr));
+}
+
+
+
+thread_local const AvstpThreadPool *	AvstpThreadPool::_cur_pool_ptr = 0;
+thread_local int	AvstpThreadPool::_cur_worker_index = -1;
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
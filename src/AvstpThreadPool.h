@@ -0,0 +1,214 @@
+/*****************************************************************************
+
+        AvstpThreadPool.h
+        Author: agent, 2026
+
+Private class used by AvstpWrapper when the AVSTP library is not available.
+Built-in implementation of the AVSTP task dispatching API on top of a pool
+of worker threads.
+
+Each worker owns a task queue. Tasks enqueued from a worker are pushed on
+its own queue, tasks coming from other threads are distributed on the
+queues in a round-robin fashion. Idle workers steal tasks from the other
+queues before going to sleep.
+
+The thread calling wait_completion() is not blocked while there are tasks
+waiting in the queues: it helps the workers by processing them. Therefore
+nested dispatchers (tasks creating and waiting for their own sub-tasks) are
+allowed.
+
+An exception thrown by a task is caught by the worker and rethrown by
+wait_completion() on the dispatcher it belongs to, so the behaviour is
+identical to the mono-threaded fallback, where tasks are run inline.
+
+The workers can be pinned to logical processors, following one of the
+CpuTopology placement policies. Only the workers are pinned, the threads
+calling wait_completion() are left untouched.
+
+Scheduling statistics can be collected for each dispatcher (see AvstpStats)
+and for the workers idle times. They are disabled by default, because the
+timestamps and the dispatcher locking have a cost on small tasks.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (AvstpThreadPool_HEADER_INCLUDED)
+#define	AvstpThreadPool_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma once
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "conc/AtomicInt.h"
+#include "conc/CellPool.h"
+#include "conc/LockFreeQueue.h"
+#include "conc/ObjPool.h"
+#include "avstp.h"
+#include "AvstpStats.h"
+#include "CpuTopology.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+class AvstpThreadPool
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	explicit       AvstpThreadPool (int nbr_threads = 0, CpuTopology::Policy policy = CpuTopology::Policy_NONE, const std::vector <int> &cpu_list = std::vector <int> ());
+	virtual        ~AvstpThreadPool ();
+
+	int            get_nbr_threads () const;
+	avstp_TaskDispatcher *
+	               create_dispatcher ();
+	void           destroy_dispatcher (avstp_TaskDispatcher *td_ptr);
+	int            enqueue_task (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr);
+	int            wait_completion (avstp_TaskDispatcher *td_ptr);
+
+	void           set_stats_flag (bool flag);
+	bool           get_stats_flag () const;
+	void           get_dispatcher_stats (avstp_TaskDispatcher *td_ptr, AvstpStats &stats) const;
+	void           get_worker_idle_times (std::vector <int64_t> &idle_ns_arr) const;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	// Number of unsuccessful queue scans before a worker goes to sleep
+	static const int  SPIN_COUNT   = 64;
+
+	// Maximum time a waiting thread stays blocked before scanning the queues
+	// again, in microseconds.
+	static const int  WAIT_POLL_US = 1000;
+
+	class Dispatcher
+	{
+	public:
+		conc::AtomicInt <int>         // Tasks enqueued and not finished yet
+		               _nbr_pending;
+		std::mutex     _mutex;
+		std::condition_variable
+		               _cond;
+		std::exception_ptr            // First exception thrown by a task
+		               _exc_ptr;
+		bool           _stats_flag;   // Set at creation time
+		AvstpStats     _stats;        // Protected by _mutex
+	};
+
+	class Task
+	{
+	public:
+		Dispatcher *   _disp_ptr;
+		avstp_TaskPtr  _task_ptr;
+		void *         _user_data_ptr;
+		int64_t        _enq_ns;       // Enqueue timestamp, only when collecting stats
+	};
+
+	typedef conc::CellPool <Task> TaskPool;
+	typedef TaskPool::CellType TaskCell;
+	typedef conc::LockFreeQueue <Task> TaskQueue;
+	typedef std::unique_ptr <TaskQueue> TaskQueueUPtr;
+	typedef std::vector <TaskQueueUPtr> TaskQueueArray;
+	typedef std::vector <std::thread> ThreadArray;
+	typedef std::chrono::steady_clock Clock;
+
+	void           worker_loop (int index);
+	bool           run_one_task (int queue_start);
+	TaskCell *     pop_task (int queue_start, bool &steal_flag);
+	int            find_queue_for_current_thread ();
+	void           add_idle_time (int index, int64_t dur_ns);
+
+	static int64_t get_time_ns ();
+
+	static Dispatcher &
+	               use_dispatcher (avstp_TaskDispatcher *td_ptr);
+
+	int            _nbr_threads;     // Workers + the thread waiting for completion
+	TaskPool       _task_pool;
+	TaskQueueArray _queue_arr;       // One queue per worker, at least one
+	std::vector <int>                // Logical processor for each worker, -1 = not pinned
+	               _place_arr;
+	ThreadArray    _worker_arr;
+	conc::ObjPool <Dispatcher>
+	               _disp_pool;
+
+	conc::AtomicInt <int>            // Number of tasks currently in the queues. Can be temporarily negative.
+	               _nbr_queued;
+	conc::AtomicInt <int>
+	               _nbr_sleepers;
+	conc::AtomicInt <int>            // For the round-robin distribution
+	               _queue_rr;
+	conc::AtomicInt <int>
+	               _quit_flag;
+	std::mutex     _sleep_mutex;
+	std::condition_variable
+	               _sleep_cond;
+
+	conc::AtomicInt <int>
+	               _stats_flag;
+	mutable std::mutex               // Protects _idle_arr
+	               _stats_mutex;
+	std::vector <int64_t>            // Total idle time for each worker, ns
+	               _idle_arr;
+
+	static thread_local const AvstpThreadPool *
+	               _cur_pool_ptr;    // Pool owning the current thread, 0 if not a worker
+	static thread_local int
+	               _cur_worker_index;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               AvstpThreadPool (const AvstpThreadPool &other)   = delete;
+	AvstpThreadPool &
+	               operator = (const AvstpThreadPool &other)        = delete;
+	bool           operator == (const AvstpThreadPool &other) const = delete;
+	bool           operator != (const AvstpThreadPool &other) const = delete;
+
+};	// class AvstpThreadPool
+
+
+
+//#include "AvstpThreadPool.hpp"
+
+
+
+#endif	// AvstpThreadPool_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
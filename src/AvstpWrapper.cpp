@@ -33,15 +33,20 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #if defined (_MSC_VER)
  #include "AvstpFinder.h"
 #endif
+#include "AvstpStats.h"
+#include "AvstpThreadPool.h"
 #include "AvstpWrapper.h"
+#include "CpuTopology.h"
 
 #if defined (_MSC_VER)
  #include "Windows.h"
 #endif
 
 #include <stdexcept>
+#include <vector>
 
 #include <cassert>
+#include <cstdlib>
 
 
 
@@ -54,6 +59,9 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 Name: dtor
 	Please do not destroy directly the object. This will be done automatically
 	at the end of the process.
+	The built-in thread pool is not destroyed here, it should have been
+	stopped by the last user. If users are still alive, the pool is leaked:
+	the OS terminates its threads at the end of the process.
 ==============================================================================
 */
 
@@ -138,6 +146,157 @@ int	AvstpWrapper::wait_completion (avstp_TaskDispatcher *td_ptr)
 
 
 
+int	AvstpWrapper::get_nbr_nodes () const
+{
+	return (CpuTopology::use_instance ().get_nbr_nodes ());
+}
+
+
+
+// Returns the NUMA node of the processor running the calling thread, in
+// [0 ; get_nbr_nodes () - 1]
+int	AvstpWrapper::get_cur_node () const
+{
+	return (CpuTopology::use_instance ().get_cur_node ());
+}
+
+
+
+/*
+==============================================================================
+Name: add_user
+Description:
+	Registers an object using the task dispatchers. The first user starts the
+	built-in thread pool, if the AVSTP library is not used. Until then, tasks
+	are run by the mono-threaded fallback.
+	Must be balanced with a call to remove_user().
+Throws: Nothing, the mono-threaded fallback is kept if the pool cannot be
+	started.
+==============================================================================
+*/
+
+void	AvstpWrapper::add_user ()
+{
+	std::lock_guard <std::mutex>  lock (_user_mutex);
+
+	++ _nbr_users;
+	if (_nbr_users == 1 && _dll_hnd == 0)
+	{
+		assert (_pool_ptr == 0);
+		assign_native ();
+	}
+}
+
+
+
+/*
+==============================================================================
+Name: remove_user
+Description:
+	Unregisters an object previously registered with add_user(). The last
+	user stops the built-in thread pool and waits for its worker threads to
+	terminate. Therefore this function should not be called from a task, nor
+	from a DLL entry point.
+	There should not be any dispatcher still alive at this point.
+==============================================================================
+*/
+
+void	AvstpWrapper::remove_user ()
+{
+	std::lock_guard <std::mutex>  lock (_user_mutex);
+	assert (_nbr_users > 0);
+
+	-- _nbr_users;
+	if (_nbr_users == 0 && _pool_ptr != 0)
+	{
+		assign_fallback ();
+		delete _pool_ptr;
+		_pool_ptr = 0;
+	}
+}
+
+
+
+// The scheduling statistics are collected by the whole thread pool, for
+// the dispatchers created afterwards, as long as at least one object needs
+// them. The worker idle times are reset when the collection starts.
+// Must be called by an object registered with add_user(). Has no effect if
+// the built-in thread pool is not used.
+void	AvstpWrapper::add_stats_user ()
+{
+	std::lock_guard <std::mutex>  lock (_user_mutex);
+	assert (_nbr_users > 0);
+
+	++ _nbr_stats_users;
+	if (_nbr_stats_users == 1 && _pool_ptr != 0)
+	{
+		_pool_ptr->set_stats_flag (true);
+	}
+}
+
+
+
+// Must be balanced with add_stats_user(), before remove_user(). The last
+// user stops the collection.
+void	AvstpWrapper::remove_stats_user ()
+{
+	std::lock_guard <std::mutex>  lock (_user_mutex);
+	assert (_nbr_stats_users > 0);
+
+	-- _nbr_stats_users;
+	if (_nbr_stats_users == 0 && _pool_ptr != 0)
+	{
+		_pool_ptr->set_stats_flag (false);
+	}
+}
+
+
+
+// Reads the statistics of a dispatcher, after wait_completion() and before
+// destroy_dispatcher().
+// Returns false if no statistics are available (external AVSTP library,
+// mono-threaded fallback or collection disabled). stats is cleared then.
+bool	AvstpWrapper::get_stats (avstp_TaskDispatcher *td_ptr, AvstpStats &stats) const
+{
+	assert (td_ptr != 0);
+
+	bool           ok_flag = false;
+	if (_pool_ptr != 0 && _pool_ptr->get_stats_flag ())
+	{
+		_pool_ptr->get_dispatcher_stats (td_ptr, stats);
+		ok_flag = true;
+	}
+	else
+	{
+		stats.clear ();
+	}
+
+	return (ok_flag);
+}
+
+
+
+// Total idle time of each worker thread since the statistics have been
+// enabled, in nanoseconds. The workers are shared by all the users, so this
+// is not specific to the caller.
+bool	AvstpWrapper::get_worker_idle_times (std::vector <int64_t> &idle_ns_arr) const
+{
+	bool           ok_flag = false;
+	if (_pool_ptr != 0 && _pool_ptr->get_stats_flag ())
+	{
+		_pool_ptr->get_worker_idle_times (idle_ns_arr);
+		ok_flag = true;
+	}
+	else
+	{
+		idle_ns_arr.clear ();
+	}
+
+	return (ok_flag);
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -156,16 +315,21 @@ AvstpWrapper::AvstpWrapper ()
 		0
 #endif
 	)
+,	_user_mutex ()
+,	_nbr_users (0)
+,	_nbr_stats_users (0)
+,	_pool_ptr (0)
 {
 #if defined (_MSC_VER)
 	if (_dll_hnd == 0)
 	{
 		::OutputDebugStringW (
-			L"AvstpWrapper: cannot find avstp.dll."
-			L"Usage restricted to single threading.\n"
+			L"AvstpWrapper: cannot find avstp.dll. "
+			L"Using the built-in thread pool.\n"
 		);
 //		throw std::runtime_error ("Cannot find avstp.dll.");
 #endif
+		// The built-in thread pool is started by the first user
 		assign_fallback ();
 #if defined (_MSC_VER)
 	}
@@ -217,6 +381,45 @@ void	AvstpWrapper::assign_normal ()
 
 
 
+// The placement of the worker threads is read from the FMTCONV_AFFINITY
+// environment variable. See CpuTopology::parse_policy() for the format.
+// Invalid values are ignored.
+void	AvstpWrapper::assign_native ()
+{
+	try
+	{
+		CpuTopology::Policy  policy = CpuTopology::Policy_NONE;
+		std::vector <int>    cpu_list;
+		const char *   env_0 = std::getenv ("FMTCONV_AFFINITY");
+		if (env_0 != 0)
+		{
+			CpuTopology::parse_policy (policy, cpu_list, env_0);
+		}
+
+		_pool_ptr = new AvstpThreadPool (0, policy, cpu_list);
+	}
+	catch (...)
+	{
+		_pool_ptr = 0;
+	}
+
+	if (_pool_ptr == 0)
+	{
+		assign_fallback ();
+	}
+	else
+	{
+		_avstp_get_interface_version_ptr = &native_get_interface_version_ptr;
+		_avstp_create_dispatcher_ptr     = &native_create_dispatcher_ptr;
+		_avstp_destroy_dispatcher_ptr    = &native_destroy_dispatcher_ptr;
+		_avstp_get_nbr_threads_ptr       = &native_get_nbr_threads_ptr;
+		_avstp_enqueue_task_ptr          = &native_enqueue_task_ptr;
+		_avstp_wait_completion_ptr       = &native_wait_completion_ptr;
+	}
+}
+
+
+
 void	AvstpWrapper::assign_fallback ()
 {
 	_avstp_get_interface_version_ptr = &fallback_get_interface_version_ptr;
@@ -229,6 +432,51 @@ void	AvstpWrapper::assign_fallback ()
 
 
 
+int	AvstpWrapper::native_get_interface_version_ptr ()
+{
+	return (avstp_INTERFACE_VERSION);
+}
+
+
+
+avstp_TaskDispatcher *	AvstpWrapper::native_create_dispatcher_ptr ()
+{
+	return (use_instance ()._pool_ptr->create_dispatcher ());
+}
+
+
+
+void	AvstpWrapper::native_destroy_dispatcher_ptr (avstp_TaskDispatcher *td_ptr)
+{
+	use_instance ()._pool_ptr->destroy_dispatcher (td_ptr);
+}
+
+
+
+int	AvstpWrapper::native_get_nbr_threads_ptr ()
+{
+	return (use_instance ()._pool_ptr->get_nbr_threads ());
+}
+
+
+
+int	AvstpWrapper::native_enqueue_task_ptr (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr)
+{
+	return (use_instance ()._pool_ptr->enqueue_task (
+		td_ptr, task_ptr, user_data_ptr
+	));
+}
+
+
+
+// Contrary to the library, rethrows the exceptions thrown by the tasks.
+int	AvstpWrapper::native_wait_completion_ptr (avstp_TaskDispatcher *td_ptr)
+{
+	return (use_instance ()._pool_ptr->wait_completion (td_ptr));
+}
+
+
+
 int	AvstpWrapper::fallback_get_interface_version_ptr ()
 {
 	return (avstp_INTERFACE_VERSION);
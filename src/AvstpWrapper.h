@@ -6,7 +6,16 @@
 A convenient wrapper on top of the AVSTP low-level API.
 Take care of:
 - Library discovery and initialisation
-- Fallback to mono-threaded mode if not found
+- Fallback to the built-in thread pool if not found (always the case on
+  platforms other than Windows)
+- Fallback to mono-threaded mode if the thread pool cannot be created
+
+The built-in thread pool only runs while the wrapper has users, registered
+with add_user() and remove_user(). The mono-threaded fallback is used the
+rest of the time. This way, the pool is stopped when the last user goes
+away, instead of during the static deinitialisation. Joining the worker
+threads from there could deadlock on Windows, where it happens during the
+DLL unloading, under the loader lock.
 
 This is a singleton, you cannot construct it directly. Use use_instance()
 to access it from anywhere.
@@ -40,6 +49,15 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "avstp.h"
 
+#include <mutex>
+#include <vector>
+
+#include <cstdint>
+
+
+
+class AvstpStats;
+class AvstpThreadPool;
 
 
 class AvstpWrapper
@@ -63,6 +81,20 @@ public:
 	int            enqueue_task (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr);
 	int            wait_completion (avstp_TaskDispatcher *td_ptr);
 
+	// Lifetime of the built-in thread pool
+	void           add_user ();
+	void           remove_user ();
+
+	// NUMA information, whatever the dispatcher implementation
+	int            get_nbr_nodes () const;
+	int            get_cur_node () const;
+
+	// Scheduling statistics, only with the built-in thread pool
+	void           add_stats_user ();
+	void           remove_stats_user ();
+	bool           get_stats (avstp_TaskDispatcher *td_ptr, AvstpStats &stats) const;
+	bool           get_worker_idle_times (std::vector <int64_t> &idle_ns_arr) const;
+
 
 
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -81,8 +113,17 @@ private:
 	void           resolve_name (T &fnc_ptr, const char *name_0);
 
 	void           assign_normal ();
+	void           assign_native ();
 	void           assign_fallback ();
 
+	static int     native_get_interface_version_ptr ();
+	static avstp_TaskDispatcher *
+	               native_create_dispatcher_ptr ();
+	static void    native_destroy_dispatcher_ptr (avstp_TaskDispatcher *td_ptr);
+	static int     native_get_nbr_threads_ptr ();
+	static int     native_enqueue_task_ptr (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr);
+	static int     native_wait_completion_ptr (avstp_TaskDispatcher *td_ptr);
+
 	static int     fallback_get_interface_version_ptr ();
 	static avstp_TaskDispatcher *
 	               fallback_create_dispatcher_ptr ();
@@ -100,6 +141,11 @@ private:
 	int            (*_avstp_wait_completion_ptr) (avstp_TaskDispatcher *td_ptr);
 
 	void *         _dll_hnd;	// Avoids loading windows.h just for HMODULE
+	std::mutex     _user_mutex;      // Protects the user counts and the thread pool creation and destruction
+	int            _nbr_users;
+	int            _nbr_stats_users;
+	AvstpThreadPool *                // 0 if not used. Owned by the users, never destroyed with the wrapper.
+	               _pool_ptr;
 
 	static int     _dummy_dispatcher;
 
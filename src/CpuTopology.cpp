@@ -0,0 +1,535 @@
+/*****************************************************************************
+
+        CpuTopology.cpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#if defined (_MSC_VER)
+ #define NOGDI
+ #define NOMINMAX
+ #define WIN32_LEAN_AND_MEAN
+#endif
+
+#include "fstb/fnc.h"
+#include "CpuTopology.h"
+
+#if defined (_MSC_VER)
+ #include "Windows.h"
+#elif defined (__linux__)
+ #include <dirent.h>
+ #include <pthread.h>
+ #include <sched.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+#include <cassert>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+const CpuTopology &	CpuTopology::use_instance ()
+{
+	static const CpuTopology   instance;
+
+	return (instance);
+}
+
+
+
+int	CpuTopology::get_nbr_cpus () const
+{
+	return (int (_cpu_arr.size ()));
+}
+
+
+
+int	CpuTopology::get_nbr_nodes () const
+{
+	return (int (_cpu_of_node_arr.size ()));
+}
+
+
+
+// Returns 0 if the processor is unknown.
+int	CpuTopology::get_node (int cpu) const
+{
+	int            node = 0;
+	if (cpu >= 0 && cpu < int (_node_of_cpu_arr.size ()))
+	{
+		node = std::max (_node_of_cpu_arr [cpu], 0);
+	}
+
+	return (node);
+}
+
+
+
+// Node of the processor running the calling thread, 0 if it cannot be
+// found. The result may be outdated if the thread is not pinned.
+int	CpuTopology::get_cur_node () const
+{
+	int            cpu = -1;
+	if (get_nbr_nodes () > 1)
+	{
+#if defined (_MSC_VER)
+		cpu = int (::GetCurrentProcessorNumber ());
+#elif defined (__linux__)
+		cpu = ::sched_getcpu ();
+#endif
+	}
+
+	return (get_node (cpu));
+}
+
+
+
+/*
+==============================================================================
+Name: build_placement
+Description:
+	Computes the logical processor on which each thread should be pinned.
+	Processors are reused if there are more threads than processors.
+Input parameters:
+	- nbr_threads: number of threads to place, > 0.
+	- policy: placement policy.
+	- cpu_list: processors for Policy_LIST, in the placement order. Unusable
+		processors are ignored.
+Output parameters:
+	- place_arr: processor for each thread, -1 if the thread should not be
+		pinned.
+Throws: memory allocation exceptions
+==============================================================================
+*/
+
+void	CpuTopology::build_placement (std::vector <int> &place_arr, int nbr_threads, Policy policy, const std::vector <int> &cpu_list) const
+{
+	assert (nbr_threads > 0);
+	assert (policy >= 0);
+	assert (policy < Policy_NBR_ELT);
+
+	std::vector <int> seq;
+	switch (policy)
+	{
+	case Policy_COMPACT:
+		for (const auto &node_cpu_arr : _cpu_of_node_arr)
+		{
+			seq.insert (seq.end (), node_cpu_arr.begin (), node_cpu_arr.end ());
+		}
+		break;
+
+	case Policy_SCATTER:
+		{
+			size_t         max_len = 0;
+			for (const auto &node_cpu_arr : _cpu_of_node_arr)
+			{
+				max_len = std::max (max_len, node_cpu_arr.size ());
+			}
+			for (size_t pos = 0; pos < max_len; ++pos)
+			{
+				for (const auto &node_cpu_arr : _cpu_of_node_arr)
+				{
+					if (pos < node_cpu_arr.size ())
+					{
+						seq.push_back (node_cpu_arr [pos]);
+					}
+				}
+			}
+		}
+		break;
+
+	case Policy_LIST:
+		for (int cpu : cpu_list)
+		{
+			if (   cpu >= 0 && cpu < int (_node_of_cpu_arr.size ())
+			    && _node_of_cpu_arr [cpu] >= 0)
+			{
+				seq.push_back (cpu);
+			}
+		}
+		break;
+
+	default:
+		// Nothing
+		break;
+	}
+
+	place_arr.assign (nbr_threads, -1);
+	if (! seq.empty ())
+	{
+		for (int t = 0; t < nbr_threads; ++t)
+		{
+			place_arr [t] = seq [t % seq.size ()];
+		}
+	}
+}
+
+
+
+/*
+==============================================================================
+Name: parse_policy
+Description:
+	Decodes a placement policy given as text: "none", "compact", "scatter" or
+	a list of logical processors like "0-7,16,18". An empty string is
+	equivalent to "none".
+Input parameters:
+	- txt: string to decode, case-insensitive.
+Output parameters:
+	- policy: decoded policy. Not modified in case of error.
+	- cpu_list: processor list for Policy_LIST, empty otherwise. Not modified
+		in case of error.
+Returns: true if the string is valid.
+Throws: memory allocation exceptions
+==============================================================================
+*/
+
+bool	CpuTopology::parse_policy (Policy &policy, std::vector <int> &cpu_list, std::string txt)
+{
+	fstb::conv_to_lower_case (txt);
+
+	bool           ok_flag = true;
+	std::vector <int> cpu_list_tmp;
+	Policy         policy_tmp  = Policy_NONE;
+	if (txt.empty () || txt == "none")
+	{
+		policy_tmp = Policy_NONE;
+	}
+	else if (txt == "compact")
+	{
+		policy_tmp = Policy_COMPACT;
+	}
+	else if (txt == "scatter")
+	{
+		policy_tmp = Policy_SCATTER;
+	}
+	else
+	{
+		policy_tmp = Policy_LIST;
+		ok_flag    = parse_cpu_list (cpu_list_tmp, txt);
+	}
+
+	if (ok_flag)
+	{
+		policy = policy_tmp;
+		cpu_list.swap (cpu_list_tmp);
+	}
+
+	return (ok_flag);
+}
+
+
+
+// Returns false if the thread could not be pinned.
+bool	CpuTopology::set_cur_thread_affinity (int cpu)
+{
+	assert (cpu >= 0);
+
+	bool           ok_flag = false;
+
+#if defined (_MSC_VER)
+
+	if (cpu < int (sizeof (::DWORD_PTR) * CHAR_BIT))
+	{
+		const ::DWORD_PTR mask = ::DWORD_PTR (1) << cpu;
+		ok_flag = (::SetThreadAffinityMask (::GetCurrentThread (), mask) != 0);
+	}
+
+#elif defined (__linux__)
+
+	if (cpu < CPU_SETSIZE)
+	{
+		::cpu_set_t    cpu_set;
+		CPU_ZERO (&cpu_set);
+		CPU_SET (cpu, &cpu_set);
+		ok_flag = (::pthread_setaffinity_np (
+			::pthread_self (), sizeof (cpu_set), &cpu_set
+		) == 0);
+	}
+
+#endif
+
+	return (ok_flag);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+CpuTopology::CpuTopology ()
+:	_cpu_arr ()
+,	_node_of_cpu_arr ()
+,	_cpu_of_node_arr ()
+{
+	read_topology ();
+
+	// Fallback: all the processors on a single node
+	if (_cpu_arr.empty ())
+	{
+		const int      nbr_cpus = std::min (
+			std::max (int (std::thread::hardware_concurrency ()), 1),
+			int (MAX_NBR_CPUS)
+		);
+		for (int cpu = 0; cpu < nbr_cpus; ++cpu)
+		{
+			_cpu_arr.push_back (cpu);
+		}
+		_node_of_cpu_arr.assign (nbr_cpus, -1);
+		_cpu_of_node_arr.clear ();
+	}
+
+	// Usable processors not found in any node go to the first one.
+	std::vector <int> orphan_arr;
+	for (int cpu : _cpu_arr)
+	{
+		if (_node_of_cpu_arr [cpu] < 0)
+		{
+			orphan_arr.push_back (cpu);
+		}
+	}
+	if (! orphan_arr.empty ())
+	{
+		if (_cpu_of_node_arr.empty ())
+		{
+			_cpu_of_node_arr.resize (1);
+		}
+		std::vector <int> & node_cpu_arr = _cpu_of_node_arr.front ();
+		for (int cpu : orphan_arr)
+		{
+			_node_of_cpu_arr [cpu] = 0;
+			node_cpu_arr.push_back (cpu);
+		}
+		std::sort (node_cpu_arr.begin (), node_cpu_arr.end ());
+	}
+
+	assert (! _cpu_arr.empty ());
+	assert (! _cpu_of_node_arr.empty ());
+}
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Fills _cpu_arr and the nodes. _node_of_cpu_arr must be sized to cover
+// all the usable processors. Processors found in no node are handled by
+// the caller.
+void	CpuTopology::read_topology ()
+{
+#if defined (_MSC_VER)
+
+	::DWORD_PTR    proc_mask = 0;
+	::DWORD_PTR    sys_mask  = 0;
+	if (::GetProcessAffinityMask (::GetCurrentProcess (), &proc_mask, &sys_mask))
+	{
+		const int      nbr_bits = int (sizeof (proc_mask) * CHAR_BIT);
+		_node_of_cpu_arr.assign (nbr_bits, -1);
+		for (int cpu = 0; cpu < nbr_bits; ++cpu)
+		{
+			if ((proc_mask & (::DWORD_PTR (1) << cpu)) != 0)
+			{
+				_cpu_arr.push_back (cpu);
+			}
+		}
+
+		::ULONG        highest = 0;
+		if (::GetNumaHighestNodeNumber (&highest))
+		{
+			for (::ULONG node = 0; node <= highest; ++node)
+			{
+				::ULONGLONG    node_mask = 0;
+				if (::GetNumaNodeProcessorMask (::UCHAR (node), &node_mask))
+				{
+					std::vector <int> cpu_list;
+					for (int cpu = 0; cpu < nbr_bits; ++cpu)
+					{
+						if ((node_mask & (::ULONGLONG (1) << cpu)) != 0)
+						{
+							cpu_list.push_back (cpu);
+						}
+					}
+					add_node (int (node), cpu_list);
+				}
+			}
+		}
+	}
+
+#elif defined (__linux__)
+
+	::cpu_set_t    cpu_set;
+	CPU_ZERO (&cpu_set);
+	if (::sched_getaffinity (0, sizeof (cpu_set), &cpu_set) == 0)
+	{
+		const int      nbr_bits = std::min (int (CPU_SETSIZE), int (MAX_NBR_CPUS));
+		_node_of_cpu_arr.assign (nbr_bits, -1);
+		for (int cpu = 0; cpu < nbr_bits; ++cpu)
+		{
+			if (CPU_ISSET (cpu, &cpu_set))
+			{
+				_cpu_arr.push_back (cpu);
+			}
+		}
+
+		const std::string base_path = "/sys/devices/system/node/";
+		::DIR *        dir_ptr   = ::opendir (base_path.c_str ());
+		if (dir_ptr != 0)
+		{
+			std::vector <int> node_id_arr;
+			const ::dirent *  entry_ptr = 0;
+			while ((entry_ptr = ::readdir (dir_ptr)) != 0)
+			{
+				const std::string name (entry_ptr->d_name);
+				if (   name.size () > 4
+				    && name.compare (0, 4, "node") == 0
+				    && isdigit (name [4]))
+				{
+					node_id_arr.push_back (atoi (name.c_str () + 4));
+				}
+			}
+			::closedir (dir_ptr);
+
+			// Keeps the system order for the renumbered nodes
+			std::sort (node_id_arr.begin (), node_id_arr.end ());
+			for (int node : node_id_arr)
+			{
+				const std::string pathname =
+					base_path + "node" + std::to_string (node) + "/cpulist";
+				std::ifstream  f (pathname.c_str ());
+				std::string    line;
+				std::vector <int> cpu_list;
+				if (   std::getline (f, line)
+				    && parse_cpu_list (cpu_list, line))
+				{
+					add_node (node, cpu_list);
+				}
+			}
+		}
+	}
+
+#endif
+}
+
+
+
+// Keeps only the usable processors not assigned yet. Empty nodes are
+// discarded.
+void	CpuTopology::add_node (int node, const std::vector <int> &cpu_list)
+{
+	assert (node >= 0);
+
+	std::vector <int> usable_arr;
+	for (int cpu : cpu_list)
+	{
+		if (   cpu >= 0 && cpu < int (_node_of_cpu_arr.size ())
+		    && _node_of_cpu_arr [cpu] < 0
+		    && std::binary_search (_cpu_arr.begin (), _cpu_arr.end (), cpu))
+		{
+			usable_arr.push_back (cpu);
+		}
+	}
+
+	if (! usable_arr.empty ())
+	{
+		std::sort (usable_arr.begin (), usable_arr.end ());
+		usable_arr.erase (
+			std::unique (usable_arr.begin (), usable_arr.end ()),
+			usable_arr.end ()
+		);
+		const int      node_index = int (_cpu_of_node_arr.size ());
+		for (int cpu : usable_arr)
+		{
+			_node_of_cpu_arr [cpu] = node_index;
+		}
+		_cpu_of_node_arr.push_back (usable_arr);
+	}
+}
+
+
+
+// Format: comma-separated processor numbers or ranges, like "0-3,8,10-11".
+// Spaces are ignored. The order is kept.
+bool	CpuTopology::parse_cpu_list (std::vector <int> &cpu_list, const std::string &txt)
+{
+	cpu_list.clear ();
+
+	std::string    str;
+	for (char c : txt)
+	{
+		if (! isspace (static_cast <unsigned char> (c)))
+		{
+			str += c;
+		}
+	}
+
+	bool           ok_flag = ! str.empty ();
+	size_t         pos     = 0;
+	while (ok_flag && pos < str.size ())
+	{
+		size_t         end = str.find (',', pos);
+		if (end == std::string::npos)
+		{
+			end = str.size ();
+		}
+		const std::string item = str.substr (pos, end - pos);
+		const size_t   dash = item.find ('-');
+		const std::string beg_str = item.substr (0, dash);
+		const std::string end_str =
+			(dash == std::string::npos) ? beg_str : item.substr (dash + 1);
+
+		ok_flag = (
+			   ! beg_str.empty () && ! end_str.empty ()
+			&& beg_str.find_first_not_of ("0123456789") == std::string::npos
+			&& end_str.find_first_not_of ("0123456789") == std::string::npos
+			&& beg_str.size () <= 6 && end_str.size () <= 6
+		);
+		if (ok_flag)
+		{
+			const int      cpu_beg = atoi (beg_str.c_str ());
+			const int      cpu_end = atoi (end_str.c_str ());
+			ok_flag = (cpu_beg <= cpu_end && cpu_end < MAX_NBR_CPUS);
+			for (int cpu = cpu_beg; ok_flag && cpu <= cpu_end; ++cpu)
+			{
+				cpu_list.push_back (cpu);
+			}
+		}
+
+		pos = end + 1;
+	}
+
+	return (ok_flag);
+}
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
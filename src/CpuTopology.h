@@ -0,0 +1,137 @@
+/*****************************************************************************
+
+        CpuTopology.h
+        Author: agent, 2026
+
+Private class used by AvstpWrapper and AvstpThreadPool.
+Lists the logical processors available to the process and the NUMA node
+they belong to, and pins threads to processors.
+
+The topology is read once, at the first call to use_instance(). On systems
+where it cannot be read, all the processors are considered as belonging to
+a single node and the threads cannot be pinned.
+
+Placement policies:
+- NONE: no pinning, the system is free to move the threads.
+- COMPACT: fills the processors of the first node before going to the next
+	one. Minimises the cross-node traffic when there are few threads.
+- SCATTER: distributes the threads on the nodes in a round-robin fashion.
+	Maximises the available memory bandwidth.
+- LIST: user-given list of processors.
+
+On Windows, only the first processor group (64 logical processors) is
+handled.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (CpuTopology_HEADER_INCLUDED)
+#define	CpuTopology_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma once
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <string>
+#include <vector>
+
+
+
+class CpuTopology
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	enum Policy
+	{
+		Policy_NONE = 0,
+		Policy_COMPACT,
+		Policy_SCATTER,
+		Policy_LIST,
+
+		Policy_NBR_ELT
+	};
+
+	static const int  MAX_NBR_CPUS = 4096;
+
+	virtual        ~CpuTopology () {}
+
+	static const CpuTopology &
+	               use_instance ();
+
+	int            get_nbr_cpus () const;
+	int            get_nbr_nodes () const;
+	int            get_node (int cpu) const;
+	int            get_cur_node () const;
+
+	void           build_placement (std::vector <int> &place_arr, int nbr_threads, Policy policy, const std::vector <int> &cpu_list) const;
+
+	static bool    parse_policy (Policy &policy, std::vector <int> &cpu_list, std::string txt);
+	static bool    set_cur_thread_affinity (int cpu);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+	               CpuTopology ();
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	void           read_topology ();
+	void           add_node (int node, const std::vector <int> &cpu_list);
+
+	static bool    parse_cpu_list (std::vector <int> &cpu_list, const std::string &txt);
+
+	std::vector <int>                // Logical processors usable by the process, ascending order
+	               _cpu_arr;
+	std::vector <int>                // Node index for each logical processor, -1 if not usable. Indexed by processor number.
+	               _node_of_cpu_arr;
+	std::vector <std::vector <int> > // Usable logical processors for each node. Nodes are renumbered and never empty.
+	               _cpu_of_node_arr;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               CpuTopology (const CpuTopology &other)       = delete;
+	CpuTopology &  operator = (const CpuTopology &other)        = delete;
+	bool           operator == (const CpuTopology &other) const = delete;
+	bool           operator != (const CpuTopology &other) const = delete;
+
+};	// class CpuTopology
+
+
+
+//#include "CpuTopology.hpp"
+
+
+
+#endif	// CpuTopology_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
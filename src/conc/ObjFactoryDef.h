@@ -40,7 +40,7 @@ namespace conc
 
 template <class T>
 class ObjFactoryDef
-:	public ObjFactoryInterface
+:	public ObjFactoryInterface <T>
 {
 
 /*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
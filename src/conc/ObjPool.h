@@ -12,6 +12,15 @@ control the instantiation details and provide additional parameters), see the
 ObjFactoryInterface template class. Use ObjFactoryDef<T>::_fact if it doesn't
 need anything more than the constructor without argument.
 
+Each thread has a small magazine of free objects in front of the shared
+stack, so objects taken and returned by the same thread don't touch the
+shared stack in the steady state. Magazines are refilled from and flushed
+to the shared stack by batches. Threads are assigned to the magazines in a
+round-robin fashion on their first access, so when there are more than
+NBR_MAGS threads, a few of them share a magazine. If it is already in use,
+the shared stack is accessed directly. A thread may keep up to MAG_SIZE free
+objects for itself, this should be taken into account for big objects.
+
 Template parameters:
 
 - T: your class of stored objects. Requires:
@@ -41,11 +50,14 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
+#include "conc/AtomicInt.h"
 #include "conc/CellPool.h"
 #include "conc/LockFreeStack.h"
 #include "conc/ObjFactoryInterface.h"
 #include "fstb/SingleObj.h"
 
+#include <array>
+
 
 
 namespace conc
@@ -90,13 +102,36 @@ private:
 	typedef	typename PtrPool::CellType	PtrCell;
 	typedef	LockFreeStack <ObjType *>	PtrStack;
 
+	static const int  MAG_SIZE  = 4;             // Maximum number of objects in a magazine
+	static const int  MAG_BATCH = MAG_SIZE / 2;  // Objects moved at once between a magazine and the shared stack
+	static const int  NBR_MAGS  = 64;            // Must be a power of 2
+
+	class Magazine
+	{
+	public:
+		AtomicInt <int>                  // 0 = free, 1 = in use by a thread
+		               _lock;
+		int            _nbr_obj = 0;
+		std::array <ObjType *, MAG_SIZE>
+		               _obj_arr;
+		char           _pad [64];        // Avoids false sharing between the magazines
+	};
+	typedef std::array <Magazine, NBR_MAGS> MagArray;
+
+	T *            take_obj_shared ();
+	bool           push_obj_shared (ObjType &obj);
+	void           refill_mag (Magazine &mag);
+	void           flush_mag (Magazine &mag, int nbr_obj);
 	int            delete_obj_stack (PtrStack &ptr_stack, bool destroy_flag);
 
+	static int     get_mag_index ();
+
 	Factory *      _factory_ptr = 0;    // 0 = not set
 	PtrStack       _stack_free;
 	PtrStack       _stack_all;
 	fstb::SingleObj <PtrPool>
 	               _obj_cell_pool_ptr;
+	MagArray       _mag_arr;
 
 
 
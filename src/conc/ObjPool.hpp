@@ -52,6 +52,7 @@ ObjPool <T>::ObjPool ()
 ,	_stack_free ()
 ,	_stack_all ()
 ,	_obj_cell_pool_ptr ()
+,	_mag_arr ()
 {
 	_obj_cell_pool_ptr->expand_to (1024);
 }
@@ -124,40 +125,24 @@ T *	ObjPool <T>::take_obj ()
 
 	ObjType *      obj_ptr = 0;
 
-	PtrCell *      cell_ptr = _stack_free.pop ();
-	if (cell_ptr == 0)
+	Magazine &     mag = _mag_arr [get_mag_index ()];
+	if (mag._lock.cas (1, 0) == 0)
 	{
-		obj_ptr = _factory_ptr->create ();
-
-		if (obj_ptr != 0)
+		if (mag._nbr_obj == 0)
 		{
-			bool        ok_flag = false;
-			try
-			{
-				cell_ptr = _obj_cell_pool_ptr->take_cell (true);
-				if (cell_ptr != 0)
-				{
-					cell_ptr->_val = obj_ptr;
-					_stack_all.push (*cell_ptr);
-					ok_flag = true;
-				}
-			}
-			catch (...)
-			{
-				// Nothing
-			}
-
-			if (! ok_flag)
-			{
-				delete obj_ptr;
-				obj_ptr = 0;
-			}
+			refill_mag (mag);
 		}
+		if (mag._nbr_obj > 0)
+		{
+			-- mag._nbr_obj;
+			obj_ptr = mag._obj_arr [mag._nbr_obj];
+		}
+		mag._lock = 0;
 	}
-	else
+
+	if (obj_ptr == 0)
 	{
-		obj_ptr = cell_ptr->_val;
-		_obj_cell_pool_ptr->return_cell (*cell_ptr);
+		obj_ptr = take_obj_shared ();
 	}
 
 	return (obj_ptr);
@@ -182,24 +167,30 @@ Throws: Nothing
 template <class T>
 void	ObjPool <T>::return_obj (T &obj)
 {
-	PtrCell *      cell_ptr = 0;
-	try
-	{
-		cell_ptr = _obj_cell_pool_ptr->take_cell (true);
-	}
-	catch (...)
-	{
-		// Nothing
-	}
+	bool           done_flag = false;
 
-	if (cell_ptr == 0)
+	Magazine &     mag = _mag_arr [get_mag_index ()];
+	if (mag._lock.cas (1, 0) == 0)
 	{
-		throw std::runtime_error ("return_obj(): cannot allocate a new cell.");
+		if (mag._nbr_obj >= MAG_SIZE)
+		{
+			flush_mag (mag, MAG_BATCH);
+		}
+		if (mag._nbr_obj < MAG_SIZE)
+		{
+			mag._obj_arr [mag._nbr_obj] = &obj;
+			++ mag._nbr_obj;
+			done_flag = true;
+		}
+		mag._lock = 0;
 	}
-	else
+
+	if (! done_flag)
 	{
-		cell_ptr->_val = &obj;
-		_stack_free.push (*cell_ptr);
+		if (! push_obj_shared (obj))
+		{
+			throw std::runtime_error ("return_obj(): cannot allocate a new cell.");
+		}
 	}
 }
 
@@ -220,6 +211,13 @@ Throws: Nothing
 template <class T>
 void	ObjPool <T>::cleanup ()
 {
+	for (auto &mag : _mag_arr)
+	{
+		assert (mag._lock == 0);
+		flush_mag (mag, mag._nbr_obj);
+		assert (mag._nbr_obj == 0);
+	}
+
 #if ! defined (NDEBUG)
 	const int      count_free =
 #endif
@@ -243,6 +241,115 @@ void	ObjPool <T>::cleanup ()
 
 
 
+// Takes an object from the shared stack, or creates a new one.
+template <class T>
+T *	ObjPool <T>::take_obj_shared ()
+{
+	ObjType *      obj_ptr = 0;
+
+	PtrCell *      cell_ptr = _stack_free.pop ();
+	if (cell_ptr == 0)
+	{
+		obj_ptr = _factory_ptr->create ();
+
+		if (obj_ptr != 0)
+		{
+			bool        ok_flag = false;
+			try
+			{
+				cell_ptr = _obj_cell_pool_ptr->take_cell (true);
+				if (cell_ptr != 0)
+				{
+					cell_ptr->_val = obj_ptr;
+					_stack_all.push (*cell_ptr);
+					ok_flag = true;
+				}
+			}
+			catch (...)
+			{
+				// Nothing
+			}
+
+			if (! ok_flag)
+			{
+				delete obj_ptr;
+				obj_ptr = 0;
+			}
+		}
+	}
+	else
+	{
+		obj_ptr = cell_ptr->_val;
+		_obj_cell_pool_ptr->return_cell (*cell_ptr);
+	}
+
+	return (obj_ptr);
+}
+
+
+
+// Returns false if a cell cannot be allocated
+template <class T>
+bool	ObjPool <T>::push_obj_shared (ObjType &obj)
+{
+	PtrCell *      cell_ptr = 0;
+	try
+	{
+		cell_ptr = _obj_cell_pool_ptr->take_cell (true);
+	}
+	catch (...)
+	{
+		// Nothing
+	}
+
+	if (cell_ptr != 0)
+	{
+		cell_ptr->_val = &obj;
+		_stack_free.push (*cell_ptr);
+	}
+
+	return (cell_ptr != 0);
+}
+
+
+
+// The magazine must be locked or not in use by any other thread.
+template <class T>
+void	ObjPool <T>::refill_mag (Magazine &mag)
+{
+	PtrCell *      cell_ptr = 0;
+	while (mag._nbr_obj < MAG_BATCH && (cell_ptr = _stack_free.pop ()) != 0)
+	{
+		mag._obj_arr [mag._nbr_obj] = cell_ptr->_val;
+		++ mag._nbr_obj;
+		_obj_cell_pool_ptr->return_cell (*cell_ptr);
+	}
+}
+
+
+
+// Moves the nbr_obj last objects of the magazine to the shared stack.
+// Stops prematurely if a cell cannot be allocated.
+// The magazine must be locked or not in use by any other thread.
+template <class T>
+void	ObjPool <T>::flush_mag (Magazine &mag, int nbr_obj)
+{
+	assert (nbr_obj >= 0);
+	assert (nbr_obj <= mag._nbr_obj);
+
+	bool           ok_flag = true;
+	for (int cnt = 0; cnt < nbr_obj && ok_flag; ++cnt)
+	{
+		ok_flag = push_obj_shared (*mag._obj_arr [mag._nbr_obj - 1]);
+		if (ok_flag)
+		{
+			-- mag._nbr_obj;
+		}
+	}
+}
+
+
+
 template <class T>
 int	ObjPool <T>::delete_obj_stack (PtrStack &ptr_stack, bool destroy_flag)
 {
@@ -271,6 +378,24 @@ int	ObjPool <T>::delete_obj_stack (PtrStack &ptr_stack, bool destroy_flag)
 
 
 
+// The threads are assigned to the magazines in a round-robin fashion, on
+// their first access to any pool of the same type.
+template <class T>
+int	ObjPool <T>::get_mag_index ()
+{
+	static AtomicInt <int>  thread_cnt (0);
+	static thread_local int mag_index = -1;
+
+	if (mag_index < 0)
+	{
+		mag_index = (thread_cnt ++) & (NBR_MAGS - 1);
+	}
+
+	return (mag_index);
+}
+
+
+
 }	// namespace conc
 
 
@@ -26,6 +26,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fstb/def.h"
 #include "fmtc/Bitdepth.h"
+#include "fmtc/Bitdepth_macro.h"
 #include "fmtc/SplFmtUtl.h"
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	#include "fmtcl/ProxyRwSse2.h"
@@ -39,6 +40,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include <stdexcept>
 
 #include <cassert>
+#include <cstdlib>
 
 
 namespace fmtc
@@ -62,6 +64,7 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 ,	_upconv_flag (false)
 ,	_sse2_flag (false)
 ,	_avx2_flag (false)
+,	_fma_flag (false)
 ,	_full_range_in_flag (false)
 ,	_full_range_out_flag (false)
 ,	_dmode (get_arg_int (in, out, "dmode", DMode_FILTERLITE))
@@ -78,13 +81,17 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 ,	_errdif_flag (false)
 ,	_simple_flag (false)
 ,	_dither_pat_arr ()
+,	_rnd_grp_len (0)
+,	_rnd_grp_nbr (0)
 ,	_buf_factory_uptr ()
 ,	_process_seg_int_int_ptr (0)
 ,	_process_seg_flt_int_ptr (0)
+,	_stripe_scheduler ()
 {
 	vsutl::CpuOpt  cpu_opt (*this, in, out);
 	_sse2_flag = cpu_opt.has_sse2 ();
 	_avx2_flag = cpu_opt.has_avx2 ();
+	_fma_flag  = (cpu_opt.has_fma3 () && get_arg_int (in, out, "fma", 1) != 0);
 
 	// Checks the input clip
 	if (_vi_in.format == 0)
@@ -258,6 +265,13 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 	{
 		init_fnc_ordered ();
 	}
+
+	// Error diffusion cannot be split within a plane, so by default we
+	// process the planes concurrently to reduce the frame latency.
+	const bool     mt_planes_def_flag = (_errdif_flag && ! _upconv_flag);
+	_plane_processor.set_mt_planes (
+		get_arg_int (in, out, "mtplanes", (mt_planes_def_flag) ? 1 : 0) != 0
+	);
 }
 
 
@@ -328,55 +342,13 @@ int	Bitdepth::do_process_plane (::VSFrameRef &dst, int n, int plane_index, void
 			_vsapi.getFrameFilter (n, src_node1_sptr.get (), &frame_ctx),
 			_vsapi
 		);
-		const ::VSFrameRef & src = *src_sptr;
 
-		const int      w = _vsapi.getFrameWidth (&src, plane_index);
-		const int      h = _vsapi.getFrameHeight (&src, plane_index);
-
-		const uint8_t* data_src_ptr = _vsapi.getReadPtr (&src, plane_index);
-		const int      stride_src   = _vsapi.getStride (&src, plane_index);
-		uint8_t *      data_dst_ptr = _vsapi.getWritePtr (&dst, plane_index);
-		const int      stride_dst   = _vsapi.getStride (&dst, plane_index);
+		PlaneBuf       buf;
+		_plane_processor.get_plane_buf (buf, dst, src_sptr.get (), plane_index);
 
 		try
 		{
-			if (_upconv_flag)
-			{
-				fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag);
-				blitter.bitblt (
-					_splfmt_dst, _vi_out.format->bitsPerSample,
-					data_dst_ptr, 0, stride_dst,
-					_splfmt_src, _vi_in.format->bitsPerSample,
-					data_src_ptr, 0, stride_src,
-					w, h,
-					_scale_info_arr [plane_index]._ptr
-				);
-			}
-			else
-			{
-				uint32_t       rnd_state = plane_index << 16;
-				if (_static_noise_flag)
-				{
-					rnd_state += 55555;
-				}
-				else
-				{
-					rnd_state += n;
-				}
-
-				const int      pat_index = (n + plane_index) & (PAT_PERIOD - 1);
-				const PatData& pattern = _dither_pat_arr [pat_index];
-
-				dither_plane (
-					_splfmt_dst, _vi_out.format->bitsPerSample,
-					data_dst_ptr, stride_dst,
-					_splfmt_src, _vi_in.format->bitsPerSample,
-					data_src_ptr, stride_src,
-					w, h,
-					_scale_info_arr [plane_index]._info,
-					pattern, rnd_state
-				);
-			}
+			ret_val = do_process_plane_buf (buf, n, plane_index, frame_data_ptr);
 		}
 
 		catch (std::exception &e)
@@ -396,6 +368,54 @@ int	Bitdepth::do_process_plane (::VSFrameRef &dst, int n, int plane_index, void
 
 
 
+int	Bitdepth::do_process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void * /*frame_data_ptr*/)
+{
+	const int      w = buf._src_w;
+	const int      h = buf._src_h;
+
+	if (_upconv_flag)
+	{
+		fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, _fma_flag);
+		blitter.bitblt (
+			_splfmt_dst, _vi_out.format->bitsPerSample,
+			buf._dst_ptr, 0, buf._dst_stride,
+			_splfmt_src, _vi_in.format->bitsPerSample,
+			buf._src_ptr, 0, buf._src_stride,
+			w, h,
+			_scale_info_arr [plane_index]._ptr
+		);
+	}
+	else
+	{
+		uint32_t       rnd_state = plane_index << 16;
+		if (_static_noise_flag)
+		{
+			rnd_state += 55555;
+		}
+		else
+		{
+			rnd_state += n;
+		}
+
+		const int      pat_index = (n + plane_index) & (PAT_PERIOD - 1);
+		const PatData& pattern = _dither_pat_arr [pat_index];
+
+		dither_plane (
+			_splfmt_dst, _vi_out.format->bitsPerSample,
+			buf._dst_ptr, buf._dst_stride,
+			_splfmt_src, _vi_in.format->bitsPerSample,
+			buf._src_ptr, buf._src_stride,
+			w, h,
+			_scale_info_arr [plane_index]._info,
+			pattern, rnd_state
+		);
+	}
+
+	return (0);
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -642,79 +662,6 @@ void	Bitdepth::copy_dither_pat_rotate (PatData &dst, const PatData &src, int ang
 
 
 
-// All possible combinations
-#define fmtc_Bitdepth_SPAN_INT(SETP, NAMP, NAMF, simple_flag, dst_res, dst_fmt, src_res, src_fmt) \
-	switch (  ((simple_flag) << 30) \
-	        + ((dst_res) << 24) + ((dst_fmt) << 16) \
-	        + ((src_res) <<  8) +  (src_fmt)) \
-	{ \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	}
-
-// All possible combinations using float as intermediary data
-#define fmtc_Bitdepth_SPAN_FLT(SETP, NAMP, NAMF, simple_flag, dst_res, dst_fmt, src_res, src_fmt) \
-	switch (  ((simple_flag) << 30) \
-	        + ((dst_res) << 24) + ((dst_fmt) << 16) \
-	        + ((src_res) <<  8) +  (src_fmt)) \
-	{ \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT8 , uint8_t ,  8, fmtcl::SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t,  9, fmtcl::SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 10, fmtcl::SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 12, fmtcl::SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, fmtcl::SplFmt_INT16, uint16_t, 16, fmtcl::SplFmt_FLOAT, float   , 32) \
-	}
-
 #define fmtc_Bitdepth_SET_FNC_INT(NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
 	case (false << 30) + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
 		_process_seg_int_int_ptr = \
@@ -805,6 +752,10 @@ void	Bitdepth::init_fnc_fast ()
 			dst_res, dst_fmt, src_res, src_fmt
 		)
 	}
+	if (_avx2_flag)
+	{
+		init_fnc_fast_avx2 ();
+	}
 #endif
 }
 
@@ -827,6 +778,8 @@ void	Bitdepth::init_fnc_ordered ()
 		fmtc_Bitdepth_SET_FNC_FLT, ord, ord, _simple_flag,
 		dst_res, dst_fmt, src_res, src_fmt
 	)
+	_rnd_grp_len = 1;
+	_rnd_grp_nbr = 1;
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	if (_sse2_flag)
@@ -839,8 +792,22 @@ void	Bitdepth::init_fnc_ordered ()
 			fmtc_Bitdepth_SET_FNC_FLT_SSE2, ord, ord, _simple_flag,
 			dst_res, dst_fmt, src_res, src_fmt
 		)
+		_rnd_grp_len = 8;
+		_rnd_grp_nbr = 2;
+	}
+	if (_avx2_flag)
+	{
+		// Same random sequence as the SSE2 code
+		init_fnc_ordered_avx2 ();
+		_rnd_grp_len = 8;
+		_rnd_grp_nbr = 2;
 	}
 #endif
+
+	if (_simple_flag)
+	{
+		_rnd_grp_len = 0;
+	}
 }
 
 
@@ -921,8 +888,6 @@ void	Bitdepth::init_fnc_errdiff ()
 
 #undef fmtc_Bitdepth_SET_FNC_INT
 #undef fmtc_Bitdepth_SET_FNC_FLT
-#undef fmtc_Bitdepth_SPAN_INT
-#undef fmtc_Bitdepth_SPAN_FLT
 
 
 
@@ -991,14 +956,64 @@ void	Bitdepth::dither_plane (fmtcl::SplFmt dst_fmt, int dst_res, uint8_t *dst_pt
 		break;
 	}
 
-	for (int y = 0; y < h; ++y)
+	// Error diffusion: the error and the random generator state are carried
+	// from one pixel to the next, including at the line ends of the
+	// serpentine scan. The whole plane is a single dependency chain: a row
+	// cannot start before the previous one is complete, because an odd row
+	// starts on the right edge, which depends on the last pixels of the even
+	// row above. A wavefront or a SIMD processing of diagonally offset rows
+	// would need a unidirectional scan and would change the result. Only the
+	// planes can be processed concurrently.
+	if (_errdif_flag)
 	{
-		ctx._y = y;
+		for (int y = 0; y < h; ++y)
+		{
+			ctx._y = y;
 
-		(this->*process_ptr) (dst_ptr, src_ptr, w, ctx);
+			(this->*process_ptr) (dst_ptr, src_ptr, w, ctx);
+
+			src_ptr += src_stride;
+			dst_ptr += dst_stride;
+		}
+	}
+
+	// Other modes: the rows are only linked by the random generator state.
+	// We compute its value at the beginning of each row, so the bands can
+	// be processed independently and the result is exactly the same as a
+	// sequential processing, whatever the number of threads.
+	else
+	{
+		std::vector <uint32_t>  rnd_state_arr;
+		if (_rnd_grp_len > 0)
+		{
+			const int      nbr_grp = (w + _rnd_grp_len - 1) / _rnd_grp_len;
+			uint32_t       rnd_mul;
+			uint32_t       rnd_add;
+			compute_rnd_jump (rnd_mul, rnd_add, nbr_grp * _rnd_grp_nbr);
+
+			rnd_state_arr.resize (h);
+			for (int y = 0; y < h; ++y)
+			{
+				rnd_state_arr [y] = rnd_state;
+				rnd_state = rnd_state * rnd_mul + rnd_add;
+				generate_rnd_eol (rnd_state);
+			}
+		}
 
-		src_ptr += src_stride;
-		dst_ptr += dst_stride;
+		BandContext    bc;
+		bc._this_ptr      = this;
+		bc._process_ptr   = process_ptr;
+		bc._ctx           = ctx;
+		bc._dst_ptr       = dst_ptr;
+		bc._src_ptr       = src_ptr;
+		bc._dst_stride    = dst_stride;
+		bc._src_stride    = src_stride;
+		bc._w             = w;
+		bc._rnd_state_ptr = (rnd_state_arr.empty ()) ? 0 : &rnd_state_arr [0];
+
+		_stripe_scheduler.process (
+			&redirect_band, &bc, h, std::abs (dst_stride) + std::abs (src_stride)
+		);
 	}
 
 	if (ed_buf_ptr != 0)
@@ -1458,6 +1473,7 @@ void	Bitdepth::process_seg_ord_flt_int_sse2 (uint8_t *dst_ptr, const uint8_t *sr
 
 
 
+// There is no SIMD version of the error diffusion, see dither_plane().
 template <bool S_FLAG, class ERRDIF>
 void	Bitdepth::process_seg_errdif_int_int_cpp (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const
 {
@@ -1631,42 +1647,58 @@ void	Bitdepth::process_seg_errdif_flt_int_cpp (uint8_t *dst_ptr, const uint8_t *
 
 
 
-void	Bitdepth::generate_rnd (uint32_t &state)
+// Finds mul and add so that state * mul + add is equivalent to nbr_steps
+// calls to generate_rnd().
+void	Bitdepth::compute_rnd_jump (uint32_t &mul, uint32_t &add, int nbr_steps)
 {
-	state = state * uint32_t (1664525) + 1013904223;
-}
-
-
-
-void	Bitdepth::generate_rnd_eol (uint32_t &state)
-{
-	state = state * uint32_t (1103515245) + 12345;
-	if ((state & 0x2000000) != 0)
+	assert (nbr_steps >= 0);
+
+	// Coefficients of a single step
+	uint32_t       step_add = 0;
+	generate_rnd (step_add);
+	uint32_t       step_mul = 1;
+	generate_rnd (step_mul);
+	step_mul -= step_add;
+
+	mul = 1;
+	add = 0;
+	while (nbr_steps > 0)
 	{
-		state = state * uint32_t (134775813) + 1;
+		if ((nbr_steps & 1) != 0)
+		{
+			mul  = mul * step_mul;
+			add  = add * step_mul + step_add;
+		}
+		step_add  = step_add * step_mul + step_add;
+		step_mul *= step_mul;
+		nbr_steps >>= 1;
 	}
 }
 
 
 
-Bitdepth::SegContext::SegContext ()
-:	_pattern_ptr (0)
-,	_rnd_state (0)
-,	_scale_info_ptr (0)
-,	_ed_buf_ptr (0)
-,	_y (-1)
+void	Bitdepth::redirect_band (void *user_data_ptr, int y_beg, int y_end)
 {
-	// Nothing
-}
+	const BandContext &  bc =
+		*reinterpret_cast <const BandContext *> (user_data_ptr);
 
+	SegContext     ctx (bc._ctx);
+	if (bc._rnd_state_ptr != 0)
+	{
+		ctx._rnd_state = bc._rnd_state_ptr [y_beg];
+	}
 
+	const uint8_t* src_ptr = bc._src_ptr + y_beg * bc._src_stride;
+	uint8_t *      dst_ptr = bc._dst_ptr + y_beg * bc._dst_stride;
+	for (int y = y_beg; y < y_end; ++y)
+	{
+		ctx._y = y;
 
-const Bitdepth::PatRow &	Bitdepth::SegContext::extract_pattern_row () const
-{
-	assert (_pattern_ptr != 0);
-	assert (_y >= 0);
+		(bc._this_ptr->*bc._process_ptr) (dst_ptr, src_ptr, bc._w, ctx);
 
-	return ((*_pattern_ptr) [_y & (PAT_WIDTH - 1)]);
+		src_ptr += bc._src_stride;
+		dst_ptr += bc._dst_stride;
+	}
 }
 
 
@@ -37,6 +37,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "vsutl/NodeRefSPtr.h"
 #include "vsutl/PlaneProcCbInterface.h"
 #include "vsutl/PlaneProcessor.h"
+#include "vsutl/StripeScheduler.h"
 #include "VapourSynth.h"
 
 #include <array>
@@ -77,6 +78,7 @@ protected:
 
 	// vsutl::PlaneProcCbInterface
 	virtual int    do_process_plane (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr, const vsutl::NodeRefSPtr &src_node2_sptr, const vsutl::NodeRefSPtr &src_node3_sptr);
+	virtual int    do_process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void *frame_data_ptr);
 
 
 
@@ -135,6 +137,25 @@ private:
 		int            _y;                     // Ordered dithering and error diffusion
 	};
 
+	// Ordered and fast dithering, processed by horizontal bands
+	class BandContext
+	{
+	public:
+		const Bitdepth *
+		               _this_ptr;
+		void (ThisType::*
+		               _process_ptr) (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
+		SegContext     _ctx;                   // Copied for each band
+		uint8_t *      _dst_ptr;
+		const uint8_t *
+		               _src_ptr;
+		int            _dst_stride;
+		int            _src_stride;
+		int            _w;
+		const uint32_t *                       // Random generator state at the beginning of each row, 0 if not used
+		               _rnd_state_ptr;
+	};
+
 	const ::VSFormat &
 	               get_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSCore &core, const ::VSFormat &fmt_src) const;
 
@@ -147,6 +168,10 @@ private:
 	void           init_fnc_fast ();
 	void           init_fnc_ordered ();
 	void           init_fnc_errdiff ();
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	void           init_fnc_fast_avx2 ();
+	void           init_fnc_ordered_avx2 ();
+#endif
 
 	void           dither_plane (fmtcl::SplFmt dst_fmt, int dst_res, uint8_t *dst_ptr, int dst_stride, fmtcl::SplFmt src_fmt, int src_res, const uint8_t *src_ptr, int src_stride, int w, int h, const fmtcl::BitBltConv::ScaleInfo &scale_info, const PatData &pattern, uint32_t rnd_state);
 
@@ -160,6 +185,10 @@ private:
 	void           process_seg_fast_int_int_sse2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &/*ctx*/) const;
 	template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT>
 	void           process_seg_fast_flt_int_sse2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
+	template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT, int SRC_BITS>
+	void           process_seg_fast_int_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &/*ctx*/) const;
+	template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT>
+	void           process_seg_fast_flt_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
 #endif
 
 	template <bool S_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
@@ -172,6 +201,10 @@ private:
 	void           process_seg_ord_int_int_sse2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
 	template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT>
 	void           process_seg_ord_flt_int_sse2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
+	template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT, int SRC_BITS>
+	void           process_seg_ord_int_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
+	template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT>
+	void           process_seg_ord_flt_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
 #endif
 
 	template <bool S_FLAG, class ERRDIF>
@@ -183,6 +216,8 @@ private:
 	               generate_rnd (uint32_t &state);
 	static inline void
 	               generate_rnd_eol (uint32_t &state);
+	static void    compute_rnd_jump (uint32_t &mul, uint32_t &add, int nbr_steps);
+	static void    redirect_band (void *user_data_ptr, int y_beg, int y_end);
 
 	template <bool S_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
 	static inline void
@@ -350,6 +385,7 @@ private:
 	bool           _upconv_flag;
 	bool           _sse2_flag;
 	bool           _avx2_flag;
+	bool           _fma_flag;              // Not bit-exact with the non-FMA code
 	bool           _full_range_in_flag;
 	bool           _full_range_out_flag;
 
@@ -368,6 +404,8 @@ private:
 	bool           _errdif_flag;     // Indicates a dithering method using error diffusion.
 	bool           _simple_flag;     // Simplified implementation for ampo == 1 and ampn == 0
 	PatDataArray   _dither_pat_arr;  // Contains levels for ordered dithering
+	int            _rnd_grp_len;     // Ordered dithering: generate_rnd() is called _rnd_grp_nbr times for each group of _rnd_grp_len pixels. 0 = no random number used.
+	int            _rnd_grp_nbr;
 
 	conc::ObjPool <fmtcl::ErrDifBuf>
 						_buf_pool;
@@ -379,6 +417,9 @@ private:
 	void (ThisType::*
 	               _process_seg_flt_int_ptr) (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const;
 
+	vsutl::StripeScheduler
+	               _stripe_scheduler;
+
 
 
 /*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -399,7 +440,7 @@ private:
 
 
 
-//#include "fmtc/Bitdepth.hpp"
+#include "fmtc/Bitdepth.hpp"
 
 
 
@@ -0,0 +1,94 @@
+/*****************************************************************************
+
+        Bitdepth.hpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtc_Bitdepth_CODEHEADER_INCLUDED)
+#define	fmtc_Bitdepth_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+
+
+
+namespace fmtc
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+Bitdepth::SegContext::SegContext ()
+:	_pattern_ptr (0)
+,	_rnd_state (0)
+,	_scale_info_ptr (0)
+,	_ed_buf_ptr (0)
+,	_y (-1)
+{
+	// Nothing
+}
+
+
+
+const Bitdepth::PatRow &	Bitdepth::SegContext::extract_pattern_row () const
+{
+	assert (_pattern_ptr != 0);
+	assert (_y >= 0);
+
+	return ((*_pattern_ptr) [_y & (PAT_WIDTH - 1)]);
+}
+
+
+
+void	Bitdepth::generate_rnd (uint32_t &state)
+{
+	state = state * uint32_t (1664525) + 1013904223;
+}
+
+
+
+void	Bitdepth::generate_rnd_eol (uint32_t &state)
+{
+	state = state * uint32_t (1103515245) + 12345;
+	if ((state & 0x2000000) != 0)
+	{
+		state = state * uint32_t (134775813) + 1;
+	}
+}
+
+
+
+}	// namespace fmtc
+
+
+
+#endif	// fmtc_Bitdepth_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,508 @@
+/*****************************************************************************
+
+        Bitdepth_avx2.cpp
+        Author: agent, 2026
+
+To be compiled with /arch:AVX2 in order to avoid SSE/AVX state switch
+slowdown.
+
+The functions process 16 pixels at once but must give exactly the same
+result as the SSE2 ones. For the ordered dithering, this includes the random
+sequence: the generator is called twice for each group of 8 pixels, and
+only for the groups containing at least one pixel.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fmtc/Bitdepth.h"
+#include "fmtc/Bitdepth_macro.h"
+#include "fmtcl/ProxyRwAvx2.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtc
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+#define fmtc_Bitdepth_SET_FNC_INT_AVX2(NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
+	case (false << 30) + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
+		_process_seg_int_int_ptr = \
+			&ThisType::process_seg_##NAMF##_int_int_avx2 <false, DF, DP, SF, SP>; \
+		break; \
+	case (true  << 30) + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
+		_process_seg_int_int_ptr = \
+			&ThisType::process_seg_##NAMF##_int_int_avx2 <true, DF, DP, SF, SP>; \
+		break;
+
+#define fmtc_Bitdepth_SET_FNC_FLT_AVX2(NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
+	case (false << 30) + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
+		_process_seg_flt_int_ptr = \
+			&ThisType::process_seg_##NAMF##_flt_int_avx2 <false, DF, DP, SF>; \
+		break; \
+	case (true  << 30) + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
+		_process_seg_flt_int_ptr = \
+			&ThisType::process_seg_##NAMF##_flt_int_avx2 <true, DF, DP, SF>; \
+		break;
+
+
+
+void	Bitdepth::init_fnc_fast_avx2 ()
+{
+	const fmtcl::SplFmt  dst_fmt = _splfmt_dst;
+	const int            dst_res = _vi_out.format->bitsPerSample;
+	const fmtcl::SplFmt  src_fmt = _splfmt_src;
+	const int            src_res = _vi_in.format->bitsPerSample;
+
+	fmtc_Bitdepth_SPAN_INT (
+		fmtc_Bitdepth_SET_FNC_INT_AVX2, fast, fast, false,
+		dst_res, dst_fmt, src_res, src_fmt
+	)
+	fmtc_Bitdepth_SPAN_FLT (
+		fmtc_Bitdepth_SET_FNC_FLT_AVX2, fast, fast, false,
+		dst_res, dst_fmt, src_res, src_fmt
+	)
+}
+
+
+
+void	Bitdepth::init_fnc_ordered_avx2 ()
+{
+	assert (! _errdif_flag);
+
+	const fmtcl::SplFmt  dst_fmt = _splfmt_dst;
+	const int            dst_res = _vi_out.format->bitsPerSample;
+	const fmtcl::SplFmt  src_fmt = _splfmt_src;
+	const int            src_res = _vi_in.format->bitsPerSample;
+
+	fmtc_Bitdepth_SPAN_INT (
+		fmtc_Bitdepth_SET_FNC_INT_AVX2, ord, ord, _simple_flag,
+		dst_res, dst_fmt, src_res, src_fmt
+	)
+	fmtc_Bitdepth_SPAN_FLT (
+		fmtc_Bitdepth_SET_FNC_FLT_AVX2, ord, ord, _simple_flag,
+		dst_res, dst_fmt, src_res, src_fmt
+	)
+}
+
+
+
+#undef fmtc_Bitdepth_SET_FNC_INT_AVX2
+#undef fmtc_Bitdepth_SET_FNC_FLT_AVX2
+
+
+
+template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT, int SRC_BITS>
+void	Bitdepth::process_seg_fast_int_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &/*ctx*/) const
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (w > 0);
+
+	enum {         DIF_BITS = SRC_BITS - DST_BITS };
+	static_assert (DIF_BITS >= 0, "This function cannot increase bidepth.");
+
+	typedef typename  fmtcl::ProxyRwAvx2 <SRC_FMT>::PtrConst::Type SrcPtr;
+	typedef typename  fmtcl::ProxyRwAvx2 <DST_FMT>::Ptr::Type      DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+	const __m256i  zero      = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb  = _mm256_set1_epi16 (0x00FF);
+
+	const int      w16 = w & -16;
+	for (int pos = 0; pos < w16; pos += 16)
+	{
+		const __m256i  s   =
+			fmtcl::ProxyRwAvx2 <SRC_FMT>::read_i16 (src_n_ptr + pos, zero);
+		const __m256i  pix = _mm256_srli_epi16 (s, DIF_BITS);
+		fmtcl::ProxyRwAvx2 <DST_FMT>::write_i16 (dst_n_ptr + pos, pix, mask_lsb);
+	}
+
+	const int      len = w - w16;
+	if (len > 0)
+	{
+		const __m256i  s   = fmtcl::ProxyRwAvx2 <SRC_FMT>::read_i16_partial (
+			src_n_ptr + w16, zero, len
+		);
+		const __m256i  pix = _mm256_srli_epi16 (s, DIF_BITS);
+		fmtcl::ProxyRwAvx2 <DST_FMT>::write_i16_partial (
+			dst_n_ptr + w16, pix, mask_lsb, len
+		);
+	}
+}
+
+
+
+// The 8-bit output goes through ProxyRwAvx2 <SplFmt_INT8>::write_flt(),
+// which reorders the lanes after packing. The values are clipped before,
+// so the saturating packs cannot alter them.
+template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT>
+void	Bitdepth::process_seg_fast_flt_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (ctx._scale_info_ptr != 0);
+
+	typedef typename  fmtcl::ProxyRwAvx2 <SRC_FMT>::PtrConst::Type  SrcPtr;
+	typedef typename  fmtcl::ProxyRwAvx2 <DST_FMT>::Ptr::Type       DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+
+	const __m256   mul      = _mm256_set1_ps (float (ctx._scale_info_ptr->_gain));
+	const __m256   add      = _mm256_set1_ps (float (ctx._scale_info_ptr->_add_cst));
+	const __m256   vmax     = _mm256_set1_ps (float ((1 << DST_BITS) - 1));
+	const __m256   zero_f   = _mm256_setzero_ps ();
+	const __m256i  zero_i   = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256   offset   = _mm256_set1_ps (-32768);
+
+	for (int pos = 0; pos < w; pos += 16)
+	{
+		const int      len = w - pos;
+
+		__m256         s0;
+		__m256         s1;
+		if (len >= 16)
+		{
+			fmtcl::ProxyRwAvx2 <SRC_FMT>::read_flt (
+				src_n_ptr + pos, s0, s1, zero_i
+			);
+		}
+		else
+		{
+			fmtcl::ProxyRwAvx2 <SRC_FMT>::read_flt_partial (
+				src_n_ptr + pos, s0, s1, zero_i, len
+			);
+		}
+		s0 = _mm256_add_ps (_mm256_mul_ps (s0, mul), add);
+		s1 = _mm256_add_ps (_mm256_mul_ps (s1, mul), add);
+		s0 = _mm256_max_ps (_mm256_min_ps (s0, vmax), zero_f);
+		s1 = _mm256_max_ps (_mm256_min_ps (s1, vmax), zero_f);
+
+		if (len >= 16)
+		{
+			fmtcl::ProxyRwAvx2 <DST_FMT>::write_flt (
+				dst_n_ptr + pos, s0, s1, mask_lsb, sign_bit, offset
+			);
+		}
+		else
+		{
+			fmtcl::ProxyRwAvx2 <DST_FMT>::write_flt_partial (
+				dst_n_ptr + pos, s0, s1, mask_lsb, sign_bit, offset, len
+			);
+		}
+	}
+}
+
+
+
+template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT, int SRC_BITS>
+void	Bitdepth::process_seg_ord_int_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (w > 0);
+
+	enum {         DIF_BITS = SRC_BITS - DST_BITS };
+	static_assert (DIF_BITS >= 0, "This function cannot increase bidepth.");
+
+	const PatRow & pattern   = ctx.extract_pattern_row ();
+	uint32_t &     rnd_state = ctx._rnd_state;
+
+	typedef typename  fmtcl::ProxyRwAvx2 <SRC_FMT>::PtrConst::Type SrcPtr;
+	typedef typename  fmtcl::ProxyRwAvx2 <DST_FMT>::Ptr::Type      DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+	const __m256i  zero      = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb  = _mm256_set1_epi16 (0x00FF);
+	const __m256i  c128_16   = _mm256_set1_epi16 (0x80);
+	const __m256i  sign_bit  = _mm256_set1_epi16 (-0x8000);
+	const __m256i  rcst      = _mm256_set1_epi16 (1 << (DIF_BITS - 1));
+	const __m256i  vmax      = _mm256_set1_epi16 ((1 << DST_BITS) - 1);
+
+	const __m256i  ampo_i    = _mm256_set1_epi16 (_ampo_i);  // 16 ?16 [0 ; 255]
+	const __m256i  ampn_i    = _mm256_set1_epi16 (_ampn_i);  // 16 ?16 [0 ; 255]
+
+	for (int pos = 0; pos < w; pos += 16)
+	{
+		const int      len = w - pos;
+
+		const __m256i  s =	// 16 u16
+			  (len >= 16)
+			? fmtcl::ProxyRwAvx2 <SRC_FMT>::read_i16 (src_n_ptr + pos, zero)
+			: fmtcl::ProxyRwAvx2 <SRC_FMT>::read_i16_partial (src_n_ptr + pos, zero, len);
+
+		__m256i        dith_o =
+			_mm256_loadu_si256 (reinterpret_cast <const __m256i *> (
+				&pattern [pos & (PAT_WIDTH - 1)]
+			)
+		);
+
+		__m256i        dither;
+		if (S_FLAG)
+		{
+			enum {         DIT_SHFT = 8 - DIF_BITS };
+			dither = _mm256_srai_epi16 (dith_o, DIT_SHFT);
+		}
+		else
+		{
+			// Random generation. Lane 0 gets the pixels 0-7, lane 1 8-15.
+			generate_rnd (rnd_state);
+			const uint32_t rnd_03  = rnd_state;
+			generate_rnd (rnd_state);
+			const uint32_t rnd_47  = rnd_state;
+			uint32_t       rnd_8b  = 0;
+			uint32_t       rnd_cf  = 0;
+			if (len > 8)
+			{
+				generate_rnd (rnd_state);
+				rnd_8b = rnd_state;
+				generate_rnd (rnd_state);
+				rnd_cf = rnd_state;
+			}
+			const __m256i  rnd_val = _mm256_set_epi32 (
+				0, 0, rnd_cf, rnd_8b, 0, 0, rnd_47, rnd_03
+			);
+
+			__m256i			dith_n =
+				_mm256_unpacklo_epi8 (rnd_val, zero);        // 16 ?16 [0 ; 255]
+			dith_n = _mm256_sub_epi16 (dith_n, c128_16);    // 16 s16 [-128 ; 127]
+
+			dith_o = _mm256_mullo_epi16 (dith_o, ampo_i);   // 16 s16 (full range)
+			dith_n = _mm256_mullo_epi16 (dith_n, ampn_i);   // 16 s16 (full range)
+			dither = _mm256_adds_epi16 (dith_o, dith_n);    // 16 s16 = s8 * s8
+
+			enum {         DIT_SHFT = AMP_BITS + 8 - DIF_BITS };
+			dither = _mm256_srai_epi16 (dither, DIT_SHFT);  // 16 s16 = s16 >> cst
+		}
+
+		const __m256i  dith_rcst = _mm256_adds_epi16 (dither, rcst);
+
+		__m256i        quant;
+		if (S_FLAG && SRC_BITS < 16)
+		{
+			__m256i        sum = _mm256_adds_epi16 (s, dith_rcst);
+			quant = _mm256_srai_epi16 (sum, DIF_BITS);
+		}
+		else
+		{
+			__m256i        sum  = _mm256_xor_si256 (s, sign_bit); // 16 s16
+			sum   = _mm256_adds_epi16 (sum, dith_rcst);
+			sum   = _mm256_xor_si256 (sum, sign_bit);       // 16 u16
+			quant = _mm256_srli_epi16 (sum, DIF_BITS);
+		}
+
+		__m256i        pix = quant;
+		if (SRC_BITS < 16)
+		{
+			pix = _mm256_max_epi16 (pix, zero);
+			pix = _mm256_min_epi16 (pix, vmax);
+		}
+
+		if (len >= 16)
+		{
+			fmtcl::ProxyRwAvx2 <DST_FMT>::write_i16 (
+				dst_n_ptr + pos, pix, mask_lsb
+			);
+		}
+		else
+		{
+			fmtcl::ProxyRwAvx2 <DST_FMT>::write_i16_partial (
+				dst_n_ptr + pos, pix, mask_lsb, len
+			);
+		}
+	}
+
+	if (! S_FLAG)
+	{
+		generate_rnd_eol (rnd_state);
+	}
+}
+
+
+
+template <bool S_FLAG, fmtcl::SplFmt DST_FMT, int DST_BITS, fmtcl::SplFmt SRC_FMT>
+void	Bitdepth::process_seg_ord_flt_int_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) const
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (((_mm_getcsr () >> 13) & 3) == 0);   // 00 = Round to nearest (even)
+
+	const PatRow & pattern   = ctx.extract_pattern_row ();
+	uint32_t &     rnd_state = ctx._rnd_state;
+
+	const float    qt_cst    = 1.0f / (
+		65536.0f * float (1 << ((S_FLAG ? 0 : AMP_BITS) + 8))
+	);
+
+	typedef typename  fmtcl::ProxyRwAvx2 <SRC_FMT>::PtrConst::Type SrcPtr;
+	typedef typename  fmtcl::ProxyRwAvx2 <DST_FMT>::Ptr::Type      DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+	const __m256   zero_f    = _mm256_setzero_ps ();
+	const __m256i  zero_i    = _mm256_setzero_si256 ();
+	const __m256i  c128_16   = _mm256_set1_epi16 (0x80);
+	const __m256   mul       = _mm256_set1_ps (float (ctx._scale_info_ptr->_gain));
+	const __m256   add       = _mm256_set1_ps (float (ctx._scale_info_ptr->_add_cst));
+	const __m256   qt        = _mm256_set1_ps (qt_cst);
+	const __m256   vmax      = _mm256_set1_ps ((1 << DST_BITS) - 1);
+	const __m256   offset    = _mm256_set1_ps (-32768);
+	const __m256i  mask_lsb  = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit  = _mm256_set1_epi16 (-0x8000);
+
+	const __m256i  ampo_i    = _mm256_set1_epi16 (_ampo_i);  // 16 ?16 [0 ; 255]
+	const __m256i  ampn_i    = _mm256_set1_epi16 (_ampn_i);  // 16 ?16 [0 ; 255]
+
+	for (int pos = 0; pos < w; pos += 16)
+	{
+		const int      len = w - pos;
+
+		__m256         s0;
+		__m256         s1;
+		if (len >= 16)
+		{
+			fmtcl::ProxyRwAvx2 <SRC_FMT>::read_flt (
+				src_n_ptr + pos, s0, s1, zero_i
+			);
+		}
+		else
+		{
+			fmtcl::ProxyRwAvx2 <SRC_FMT>::read_flt_partial (
+				src_n_ptr + pos, s0, s1, zero_i, len
+			);
+		}
+		s0 = _mm256_add_ps (_mm256_mul_ps (s0, mul), add);
+		s1 = _mm256_add_ps (_mm256_mul_ps (s1, mul), add);
+
+		__m256i        dith_o =
+			_mm256_loadu_si256 (reinterpret_cast <const __m256i *> (
+				&pattern [pos & (PAT_WIDTH - 1)]
+			)
+		);
+
+		__m256i        dither;
+		if (S_FLAG)
+		{
+			dither = dith_o;
+		}
+		else
+		{
+			// Random generation. Lane 0 gets the pixels 0-7, lane 1 8-15.
+			generate_rnd (rnd_state);
+			const uint32_t rnd_03  = rnd_state;
+			generate_rnd (rnd_state);
+			const uint32_t rnd_47  = rnd_state;
+			uint32_t       rnd_8b  = 0;
+			uint32_t       rnd_cf  = 0;
+			if (len > 8)
+			{
+				generate_rnd (rnd_state);
+				rnd_8b = rnd_state;
+				generate_rnd (rnd_state);
+				rnd_cf = rnd_state;
+			}
+			const __m256i  rnd_val = _mm256_set_epi32 (
+				0, 0, rnd_cf, rnd_8b, 0, 0, rnd_47, rnd_03
+			);
+
+			__m256i			dith_n =
+				_mm256_unpacklo_epi8 (rnd_val, zero_i);      // 16 ?16 [0 ; 255]
+			dith_n = _mm256_sub_epi16 (dith_n, c128_16);    // 16 s16 [-128 ; 127]
+
+			dith_o = _mm256_mullo_epi16 (dith_o, ampo_i);   // 16 s16 (full range)
+			dith_n = _mm256_mullo_epi16 (dith_n, ampn_i);   // 16 s16 (full range)
+			dither = _mm256_adds_epi16 (dith_o, dith_n);    // 16 s16 = s8 * s8
+		}
+
+		// s0 and s1 contain the pixels 0-7 and 8-15, so the lanes are not
+		// interleaved like in the SSE2 code.
+		__m256i        dither_07i = _mm256_slli_epi32 (      // 8 s32 << 16
+			_mm256_cvtepi16_epi32 (_mm256_castsi256_si128 (dither)), 16
+		);
+		__m256i        dither_8fi = _mm256_slli_epi32 (      // 8 s32 << 16
+			_mm256_cvtepi16_epi32 (_mm256_extracti128_si256 (dither, 1)), 16
+		);
+		__m256         dither_07  = _mm256_cvtepi32_ps (dither_07i);
+		__m256         dither_8f  = _mm256_cvtepi32_ps (dither_8fi);
+		dither_07 = _mm256_mul_ps (dither_07, qt);
+		dither_8f = _mm256_mul_ps (dither_8f, qt);
+
+		s0 = _mm256_add_ps (s0, dither_07);
+		s1 = _mm256_add_ps (s1, dither_8f);
+
+		s0 = _mm256_max_ps (_mm256_min_ps (s0, vmax), zero_f);
+		s1 = _mm256_max_ps (_mm256_min_ps (s1, vmax), zero_f);
+
+		if (len >= 16)
+		{
+			fmtcl::ProxyRwAvx2 <DST_FMT>::write_flt (
+				dst_n_ptr + pos, s0, s1, mask_lsb, sign_bit, offset
+			);
+		}
+		else
+		{
+			fmtcl::ProxyRwAvx2 <DST_FMT>::write_flt_partial (
+				dst_n_ptr + pos, s0, s1, mask_lsb, sign_bit, offset, len
+			);
+		}
+	}
+
+	if (! S_FLAG)
+	{
+		generate_rnd_eol (rnd_state);
+	}
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
+
+
+}	// namespace fmtc
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -62,6 +62,8 @@ Matrix::Matrix (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, ::VSC
 ,	_sse2_flag (false)
 ,	_avx_flag (false)
 ,	_avx2_flag (false)
+,	_avx512_flag (false)
+,	_fma_flag (false)
 ,	_range_set_src_flag (false)
 ,	_range_set_dst_flag (false)
 ,	_full_range_src_flag (false)
@@ -70,15 +72,18 @@ Matrix::Matrix (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, ::VSC
 ,	_csp_out (fmtcl::ColorSpaceH265_UNSPECIFIED)
 ,	_plane_out (get_arg_int (in, out, "singleout", -1))
 ,	_proc_uptr ()
+,	_stripe_scheduler ()
 {
 	vsutl::CpuOpt  cpu_opt (*this, in, out);
 	_sse_flag  = cpu_opt.has_sse ();
 	_sse2_flag = cpu_opt.has_sse2 ();
 	_avx_flag  = cpu_opt.has_avx ();
 	_avx2_flag = cpu_opt.has_avx2 ();
+	_avx512_flag = (cpu_opt.has_avx512f () && cpu_opt.has_avx512bw ());
+	_fma_flag    = (cpu_opt.has_fma3 () && get_arg_int (in, out, "fma", 1) != 0);
 
 	_proc_uptr = std::unique_ptr <fmtcl::MatrixProc> (new fmtcl::MatrixProc (
-		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag
+		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag, _avx512_flag, _fma_flag
 	));
 
 	// Checks the input clip
@@ -325,7 +330,8 @@ const ::VSFrameRef *	Matrix::get_frame (int n, int activation_reason, void * &fr
 			_vsapi.getStride (&src, 2)
 		};
 
-		_proc_uptr->process (
+		_stripe_scheduler.process_planes (
+			*_proc_uptr,
 			dst_ptr_arr, dst_str_arr,
 			src_ptr_arr, src_str_arr,
 			w, h
@@ -34,6 +34,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fstb/AllocAlign.h"
 #include "vsutl/FilterBase.h"
 #include "vsutl/NodeRefSPtr.h"
+#include "vsutl/StripeScheduler.h"
 #include "VapourSynth.h"
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
@@ -122,6 +123,8 @@ private:
 	bool           _sse2_flag;
 	bool           _avx_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;           // AVX-512F and AVX-512BW
+	bool           _fma_flag;              // Not bit-exact with the non-FMA code
 
 	bool           _range_set_src_flag;
 	bool           _range_set_dst_flag;
@@ -134,6 +137,8 @@ private:
 
 	std::unique_ptr <fmtcl::MatrixProc>
 	               _proc_uptr;
+	vsutl::StripeScheduler
+	               _stripe_scheduler;
 
 
 
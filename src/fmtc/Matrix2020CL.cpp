@@ -56,6 +56,7 @@ Matrix2020CL::Matrix2020CL (const ::VSMap &in, ::VSMap &out, void *user_data_ptr
 ,	_full_range_flag (false)
 ,	_to_yuv_flag (false)
 ,	_proc_uptr ()
+,	_stripe_scheduler ()
 {
 	vsutl::CpuOpt  cpu_opt (*this, in, out);
 	const bool     sse2_flag = cpu_opt.has_sse2 ();
@@ -239,7 +240,8 @@ const ::VSFrameRef *	Matrix2020CL::get_frame (int n, int activation_reason, void
 			_vsapi.getStride (&src, 2)
 		};
 
-		_proc_uptr->process (
+		_stripe_scheduler.process_planes (
+			*_proc_uptr,
 			dst_ptr_arr, dst_str_arr,
 			src_ptr_arr, src_str_arr,
 			w, h
@@ -31,6 +31,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/Matrix2020CLProc.h"
 #include "vsutl/FilterBase.h"
 #include "vsutl/NodeRefSPtr.h"
+#include "vsutl/StripeScheduler.h"
 #include "VapourSynth.h"
 
 #include <memory>
@@ -101,6 +102,8 @@ private:
 
 	std::unique_ptr <fmtcl::Matrix2020CLProc>
 	               _proc_uptr;
+	vsutl::StripeScheduler
+	               _stripe_scheduler;
 
 
 
@@ -25,6 +25,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtc/NativeToStack16.h"
+#include "fmtcl/BitBltConv.h"
+#include "vsutl/CpuOpt.h"
 #include "vsutl/FrameRefSPtr.h"
 
 #include <stdexcept>
@@ -48,7 +50,13 @@ NativeToStack16::NativeToStack16 (const ::VSMap &in, ::VSMap &out, void *user_da
 ,	_clip_src_sptr (vsapi.propGetNode (&in, "clip", 0, 0), vsapi)
 ,	_vi_in (*_vsapi.getVideoInfo (_clip_src_sptr.get ()))
 ,	_vi_out (_vi_in)
+,	_sse2_flag (false)
+,	_avx2_flag (false)
 {
+	vsutl::CpuOpt  cpu_opt (*this, in, out);
+	_sse2_flag = cpu_opt.has_sse2 ();
+	_avx2_flag = cpu_opt.has_avx2 ();
+
 	// Checks the input clip
 	if (_vi_in.format == 0)
 	{
@@ -110,6 +118,8 @@ const ::VSFrameRef *	NativeToStack16::get_frame (int n, int activation_reason, v
 
 		dst_ptr = _vsapi.newVideoFrame (_vi_out.format, w, h << 1, &src, &core);
 
+		fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, false);
+
 		const int      nbr_planes = _vi_out.format->numPlanes;
 		for (int plane_index = 0; plane_index < nbr_planes; ++plane_index)
 		{
@@ -123,19 +133,13 @@ const ::VSFrameRef *	NativeToStack16::get_frame (int n, int activation_reason, v
 
 			const int      lsb_offset = stride_dst * ph;
 
-			for (int y = 0; y < ph; ++y)
-			{
-				for (int x = 0; x < pw; ++x)
-				{
-					const int      val =
-						reinterpret_cast <const uint16_t *> (data_src_ptr) [x];
-					data_dst_ptr [x             ] = uint8_t (val >> 8);
-					data_dst_ptr [x + lsb_offset] = uint8_t (val     );
-				}
-
-				data_src_ptr += stride_src;
-				data_dst_ptr += stride_dst;
-			}
+			blitter.bitblt (
+				fmtcl::SplFmt_STACK16, 16,
+				data_dst_ptr, data_dst_ptr + lsb_offset, stride_dst,
+				fmtcl::SplFmt_INT16, 16,
+				data_src_ptr, 0, stride_src,
+				pw, ph
+			);
 		}
 	}
 
@@ -32,6 +32,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/RgbSystem.h"
 #include "vsutl/FilterBase.h"
 #include "vsutl/NodeRefSPtr.h"
+#include "vsutl/StripeScheduler.h"
 
 #include <memory>
 
@@ -103,6 +104,8 @@ private:
 	bool           _sse2_flag;
 	bool           _avx_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;           // AVX-512F and AVX-512BW
+	bool           _fma_flag;              // Not bit-exact with the non-FMA code
 
 	RgbSystem      _prim_s;
 	RgbSystem      _prim_d;
@@ -111,6 +114,8 @@ private:
 
 	std::unique_ptr <fmtcl::MatrixProc>
 	               _proc_uptr;
+	vsutl::StripeScheduler
+	               _stripe_scheduler;
 
 
 
@@ -30,6 +30,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "vsutl/fnc.h"
 #include "vsutl/FrameRefSPtr.h"
 #include "vsutl/PlaneProcMode.h"
+#include "AvstpWrapper.h"
 
 #include <algorithm>
 
@@ -85,6 +86,10 @@ Resample::Resample (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 ,	_cplace_d (fmtcl::ChromaPlacement_MPEG2)
 ,	_sse2_flag (false)
 ,	_avx2_flag (false)
+,	_avx512_flag (false)
+,	_fma_flag (false)
+,	_tile_size (get_arg_int (in, out, "tilesize", 0))
+,	_stats_flag (get_arg_int (in, out, "taskstats", 0) != 0)
 ,	_plane_processor (vsapi, *this, "resample", true)
 ,	_filter_mutex ()
 ,	_filter_uptr_map ()
@@ -93,6 +98,15 @@ Resample::Resample (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 	vsutl::CpuOpt  cpu_opt (*this, in, out);
 	_sse2_flag = cpu_opt.has_sse2 ();
 	_avx2_flag = cpu_opt.has_avx2 ();
+	_avx512_flag = (cpu_opt.has_avx512f () && cpu_opt.has_avx512bw ());
+	_fma_flag    = (cpu_opt.has_fma3 () && get_arg_int (in, out, "fma", 1) != 0);
+
+	_plane_processor.set_mt_planes (get_arg_int (in, out, "mtplanes", 0) != 0);
+
+	if (_tile_size < 0)
+	{
+		throw_inval_arg ("tilesize must be positive or null.");
+	}
 
 	// Checks the input clip
 	if (! vsutl::is_constant_format (_vi_in))
@@ -421,6 +435,22 @@ Resample::Resample (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 	}
 
 	create_plane_specs ();
+
+	// Last, so the destructor is always called to balance it
+	if (_stats_flag)
+	{
+		AvstpWrapper::use_instance ().add_stats_user ();
+	}
+}
+
+
+
+Resample::~Resample ()
+{
+	if (_stats_flag)
+	{
+		AvstpWrapper::use_instance ().remove_stats_user ();
+	}
 }
 
 
@@ -479,9 +509,14 @@ const ::VSFrameRef *	Resample::get_frame (int n, int activation_reason, void * &
 		// Output frame properties
 		if (ret_val == 0 && (   _range_set_out_flag
 		                     || _cplace_d_set_flag
-		                     || _interlaced_dst != InterlacingParam_AUTO))
+		                     || _interlaced_dst != InterlacingParam_AUTO
+		                     || _stats_flag))
 		{
 			::VSMap &      dst_prop = *(_vsapi.getFramePropsRW (dst_ptr));
+			if (_stats_flag)
+			{
+				set_stats_props (dst_prop, frame_info);
+			}
 			if (_range_set_out_flag)
 			{
 				const int      cr_val = (_full_range_out_flag) ? 0 : 1;
@@ -604,9 +639,29 @@ int	Resample::do_process_plane (::VSFrameRef &dst, int n, int plane_index, void
 
 	if (proc_mode == vsutl::PlaneProcMode_PROCESS)
 	{
-		process_plane_proc (
-			dst, n, plane_index, frame_data_ptr, frame_ctx, core, src_node1_sptr
+		vsutl::FrameRefSPtr	src_sptr (
+			_vsapi.getFrameFilter (n, src_node1_sptr.get (), &frame_ctx),
+			_vsapi
 		);
+
+		PlaneBuf       buf;
+		_plane_processor.get_plane_buf (buf, dst, src_sptr.get (), plane_index);
+
+		try
+		{
+			ret_val = do_process_plane_buf (buf, n, plane_index, frame_data_ptr);
+		}
+
+		catch (std::exception &e)
+		{
+			_vsapi.setFilterError (e.what (), &frame_ctx);
+			ret_val = -1;
+		}
+		catch (...)
+		{
+			_vsapi.setFilterError ("resample: exception.", &frame_ctx);
+			ret_val = -1;
+		}
 	}
 
 	// Copy (and convert)
@@ -629,6 +684,40 @@ int	Resample::do_process_plane (::VSFrameRef &dst, int n, int plane_index, void
 
 
 
+int	Resample::do_process_plane_buf (const PlaneBuf &buf, int /*n*/, int plane_index, void *frame_data_ptr)
+{
+	assert (frame_data_ptr != 0);
+
+	FrameInfo &    frame_info =
+		*reinterpret_cast <FrameInfo *> (frame_data_ptr);
+	const InterlacingType   itl_s =
+		get_itl_type (frame_info._itl_s_flag, frame_info._top_s_flag);
+	const InterlacingType   itl_d =
+		get_itl_type (frame_info._itl_d_flag, frame_info._top_d_flag);
+
+	fmtcl::FilterResize *   filter_ptr = create_or_access_plane_filter (
+		plane_index,
+		itl_d,
+		itl_s
+	);
+
+	const bool     chroma_flag =
+		vsutl::is_chroma_plane (*_vi_in.format, plane_index);
+
+	filter_ptr->process_plane (
+		buf._dst_ptr, 0,
+		buf._src_ptr, 0,
+		buf._dst_stride,
+		buf._src_stride,
+		chroma_flag,
+		(_stats_flag) ? &frame_info._stats_arr [plane_index] : 0
+	);
+
+	return (0);
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -777,64 +866,6 @@ void	Resample::get_interlacing_param (bool &itl_flag, bool &top_flag, int field_
 
 
 
-int	Resample::process_plane_proc (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr)
-{
-	int            ret_val = 0;
-
-	vsutl::FrameRefSPtr	src_sptr (
-		_vsapi.getFrameFilter (n, src_node1_sptr.get (), &frame_ctx),
-		_vsapi
-	);
-	const ::VSFrameRef & src = *src_sptr;
-
-	const uint8_t* data_src_ptr = _vsapi.getReadPtr (&src, plane_index);
-	const int      stride_src   = _vsapi.getStride (&src, plane_index);
-	uint8_t *      data_dst_ptr = _vsapi.getWritePtr (&dst, plane_index);
-	const int      stride_dst   = _vsapi.getStride (&dst, plane_index);
-
-	const FrameInfo & frame_info =
-		*reinterpret_cast <const FrameInfo *> (frame_data_ptr);
-	const InterlacingType   itl_s =
-		get_itl_type (frame_info._itl_s_flag, frame_info._top_s_flag);
-	const InterlacingType   itl_d =
-		get_itl_type (frame_info._itl_d_flag, frame_info._top_d_flag);
-
-	try
-	{
-		fmtcl::FilterResize *   filter_ptr = create_or_access_plane_filter (
-			plane_index,
-			itl_d,
-			itl_s
-		);
-
-		const bool     chroma_flag =
-			vsutl::is_chroma_plane (*_vi_in.format, plane_index);
-
-		filter_ptr->process_plane (
-			data_dst_ptr, 0,
-			data_src_ptr, 0,
-			stride_dst,
-			stride_src,
-			chroma_flag
-		);
-	}
-
-	catch (std::exception &e)
-	{
-		_vsapi.setFilterError (e.what (), &frame_ctx);
-		ret_val = -1;
-	}
-	catch (...)
-	{
-		_vsapi.setFilterError ("resample: exception.", &frame_ctx);
-		ret_val = -1;
-	}
-
-	return (ret_val);
-}
-
-
-
 int	Resample::process_plane_copy (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr)
 {
 	int            ret_val = 0;
@@ -872,7 +903,7 @@ int	Resample::process_plane_copy (::VSFrameRef &dst, int n, int plane_index, voi
 		scale_info_ptr = &scale_info;
 	}
 
-	fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag);
+	fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, _fma_flag);
 	blitter.bitblt (
 		_dst_type, _dst_res, data_dst_ptr, 0, stride_dst,
 		_src_type, _src_res, data_src_ptr, 0, stride_src,
@@ -892,26 +923,41 @@ fmtcl::FilterResize *	Resample::create_or_access_plane_filter (int plane_index,
 	assert (itl_s >= 0);
 	assert (itl_s < InterlacingType_NBR_ELT);
 
-	const PlaneData & plane_data         = _plane_data_arr [plane_index];
-	const fmtcl::ResampleSpecPlane & key = plane_data._spec_arr [itl_d] [itl_s];
+	PlaneData &    plane_data = _plane_data_arr [plane_index];
 
-	std::lock_guard <std::mutex>  autolock (_filter_mutex);
+	// Fast path: the filter has already been accessed for this combination.
+	// The filters are never destroyed before the Resample object, so the
+	// pointer remains valid.
+	fmtcl::FilterResize *   filter_ptr = plane_data._filter_arr [itl_d] [itl_s];
 
-	std::unique_ptr <fmtcl::FilterResize> &   filter_uptr = _filter_uptr_map [key];
-	if (filter_uptr.get () == 0)
+	if (filter_ptr == 0)
 	{
-		filter_uptr = std::unique_ptr <fmtcl::FilterResize> (new fmtcl::FilterResize (
-			key,
-			*(plane_data._kernel_arr [fmtcl::FilterResize::Dir_H]._k_uptr),
-			*(plane_data._kernel_arr [fmtcl::FilterResize::Dir_V]._k_uptr),
-			_norm_flag, _norm_val_h, _norm_val_v,
-			plane_data._gain,
-			_src_type, _src_res, _dst_type, _dst_res,
-			_int_flag, _sse2_flag, _avx2_flag
-		));
+		const fmtcl::ResampleSpecPlane & key = plane_data._spec_arr [itl_d] [itl_s];
+
+		std::lock_guard <std::mutex>  autolock (_filter_mutex);
+
+		// Different planes or combinations may share the same spec.
+		std::unique_ptr <fmtcl::FilterResize> &   filter_uptr = _filter_uptr_map [key];
+		if (filter_uptr.get () == 0)
+		{
+			filter_uptr = std::unique_ptr <fmtcl::FilterResize> (new fmtcl::FilterResize (
+				key,
+				*(plane_data._kernel_arr [fmtcl::FilterResize::Dir_H]._k_uptr),
+				*(plane_data._kernel_arr [fmtcl::FilterResize::Dir_V]._k_uptr),
+				_norm_flag, _norm_val_h, _norm_val_v,
+				plane_data._gain,
+				_src_type, _src_res, _dst_type, _dst_res,
+				_int_flag, _sse2_flag, _avx2_flag, _avx512_flag, _fma_flag,
+				_tile_size
+			));
+		}
+
+		// Published only once the filter is fully constructed
+		filter_ptr = filter_uptr.get ();
+		plane_data._filter_arr [itl_d] [itl_s] = filter_ptr;
 	}
 
-	return (filter_uptr.get ());
+	return (filter_ptr);
 }
 
 
@@ -993,6 +1039,44 @@ void	Resample::create_plane_specs ()
 
 
 
+// Sums the statistics of all the planes. Properties are not written if the
+// statistics could not be collected (external AVSTP library or mono-threaded
+// mode).
+// FmtcTaskIdleUs contains the total idle time of each worker of the shared
+// thread pool since the statistics have been enabled, not only for this
+// frame nor for this filter.
+void	Resample::set_stats_props (::VSMap &dst_prop, const FrameInfo &frame_info) const
+{
+	AvstpStats     stats;
+	for (int plane_index = 0; plane_index < _vi_out.format->numPlanes; ++plane_index)
+	{
+		stats.add (frame_info._stats_arr [plane_index]);
+	}
+
+	std::vector <int64_t>   idle_ns_arr;
+	if (AvstpWrapper::use_instance ().get_worker_idle_times (idle_ns_arr))
+	{
+		_vsapi.propSetInt (&dst_prop, "FmtcTasks", stats._nbr_tasks, ::paReplace);
+		_vsapi.propSetInt (&dst_prop, "FmtcTaskSteals", stats._nbr_steals, ::paReplace);
+		_vsapi.propSetFloat (&dst_prop, "FmtcTaskRunUs", double (stats._run_ns) * 1e-3, ::paReplace);
+		_vsapi.propSetFloat (&dst_prop, "FmtcTaskWaitUs", double (stats._wait_ns) * 1e-3, ::paReplace);
+
+		_vsapi.propDeleteKey (&dst_prop, "FmtcTaskHist");
+		for (int bin = 0; bin < AvstpStats::NBR_HIST_BINS; ++bin)
+		{
+			_vsapi.propSetInt (&dst_prop, "FmtcTaskHist", stats._run_hist [bin], ::paAppend);
+		}
+
+		_vsapi.propDeleteKey (&dst_prop, "FmtcTaskIdleUs");
+		for (size_t w = 0; w < idle_ns_arr.size (); ++w)
+		{
+			_vsapi.propSetInt (&dst_prop, "FmtcTaskIdleUs", idle_ns_arr [w] / 1000, ::paAppend);
+		}
+	}
+}
+
+
+
 Resample::InterlacingType	Resample::get_itl_type (bool itl_flag, bool top_flag)
 {
 	return (
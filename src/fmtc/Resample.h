@@ -27,6 +27,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
+#include "conc/AtomicPtr.h"
 #include "fmtcl/ChromaPlacement.h"
 #include "fmtcl/FilterResize.h"
 #include "fmtcl/KernelData.h"
@@ -35,6 +36,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "vsutl/NodeRefSPtr.h"
 #include "vsutl/PlaneProcCbInterface.h"
 #include "vsutl/PlaneProcessor.h"
+#include "AvstpStats.h"
 #include "VapourSynth.h"
 
 #include <array>
@@ -60,7 +62,7 @@ class Resample
 public:
 
 	explicit       Resample (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCore &core, const ::VSAPI &vsapi);
-	virtual        ~Resample () = default;
+	virtual        ~Resample ();
 
 	// vsutl::FilterBase
 	virtual void   init_filter (::VSMap &in, ::VSMap &out, ::VSNode &node, ::VSCore &core);
@@ -79,6 +81,7 @@ protected:
 
 	// vsutl::PlaneProcCbInterface
 	virtual int    do_process_plane (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr, const vsutl::NodeRefSPtr &src_node2_sptr, const vsutl::NodeRefSPtr &src_node3_sptr);
+	virtual int    do_process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void *frame_data_ptr);
 
 
 
@@ -131,11 +134,15 @@ private:
 		bool           _top_s_flag;
 		bool           _itl_d_flag;
 		bool           _top_d_flag;
+		std::array <AvstpStats, MAX_NBR_PLANES>
+		               _stats_arr;    // Scheduling statistics for each plane, when collected
 	};
 
 	// Array order: [dest] [src]
 	typedef std::array <fmtcl::ResampleSpecPlane, InterlacingType_NBR_ELT> SpecSrcArray;
 	typedef std::array <SpecSrcArray,             InterlacingType_NBR_ELT> SpecArray;
+	typedef std::array <conc::AtomicPtr <fmtcl::FilterResize>, InterlacingType_NBR_ELT> FilterSrcArray;
+	typedef std::array <FilterSrcArray,           InterlacingType_NBR_ELT> FilterArray;
 
 	class PlaneData
 	{
@@ -146,6 +153,7 @@ private:
 		>  KernelArray;
 		Win            _win;
 		SpecArray      _spec_arr;        // Contains the spec (used as a key) for each plane/interlacing combination
+		FilterArray    _filter_arr;      // Filters from _filter_uptr_map for each interlacing combination, 0 if not accessed yet. Lock-free read.
 		KernelArray    _kernel_arr;
 		double         _kernel_scale_h;  // Can be negative (forced scaling)
 		double         _kernel_scale_v;  // Can be negative (forced scaling)
@@ -160,11 +168,11 @@ private:
 	               get_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSCore &core, const ::VSFormat &fmt_src) const;
 	bool           cumulate_flag (bool flag, const ::VSMap &in, ::VSMap &out, const char name_0 [], int pos = 0) const;
 	void           get_interlacing_param (bool &itl_flag, bool &top_flag, int field_index, const ::VSFrameRef &src, InterlacingParam interlaced, FieldOrder field_order) const;
-	int            process_plane_proc (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr);
 	int            process_plane_copy (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr);
 	fmtcl::FilterResize *
 	               create_or_access_plane_filter (int plane_index, InterlacingType itl_d, InterlacingType itl_s);
 	void           create_plane_specs ();
+	void           set_stats_props (::VSMap &dst_prop, const FrameInfo &frame_info) const;
 
 	static InterlacingType
 	               get_itl_type (bool itl_flag, bool top_flag);
@@ -206,9 +214,13 @@ private:
 
 	bool           _sse2_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;           // AVX-512F and AVX-512BW
+	bool           _fma_flag;              // Not bit-exact with the non-FMA code
+	int            _tile_size;             // Memory for the tile buffers, in KiB. 0 = automatic
+	bool           _stats_flag;            // Exports the scheduling statistics as frame properties
 	vsutl::PlaneProcessor
 	               _plane_processor;
-	std::mutex     _filter_mutex;          // To access _filter_uptr_map.
+	std::mutex     _filter_mutex;          // To access _filter_uptr_map and to fill PlaneData::_filter_arr.
 	std::map <fmtcl::ResampleSpecPlane, std::unique_ptr <fmtcl::FilterResize> >
 	               _filter_uptr_map;       // Created only on request.
 
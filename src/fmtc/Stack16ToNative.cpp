@@ -25,6 +25,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtc/Stack16ToNative.h"
+#include "fmtcl/BitBltConv.h"
+#include "vsutl/CpuOpt.h"
 #include "vsutl/FrameRefSPtr.h"
 
 #include <stdexcept>
@@ -48,7 +50,13 @@ Stack16ToNative::Stack16ToNative (const ::VSMap &in, ::VSMap &out, void *user_da
 ,	_clip_src_sptr (vsapi.propGetNode (&in, "clip", 0, 0), vsapi)
 ,	_vi_in (*_vsapi.getVideoInfo (_clip_src_sptr.get ()))
 ,	_vi_out (_vi_in)
+,	_sse2_flag (false)
+,	_avx2_flag (false)
 {
+	vsutl::CpuOpt  cpu_opt (*this, in, out);
+	_sse2_flag = cpu_opt.has_sse2 ();
+	_avx2_flag = cpu_opt.has_avx2 ();
+
 	// Checks the input clip
 	if (_vi_in.format == 0)
 	{
@@ -128,6 +136,8 @@ const ::VSFrameRef *	Stack16ToNative::get_frame (int n, int activation_reason, v
 		{
 			dst_ptr = _vsapi.newVideoFrame (_vi_out.format, w, h >> 1, &src, &core);
 
+			fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, false);
+
 			const int      nbr_planes = _vi_out.format->numPlanes;
 			for (int plane_index = 0; plane_index < nbr_planes; ++plane_index)
 			{
@@ -142,19 +152,13 @@ const ::VSFrameRef *	Stack16ToNative::get_frame (int n, int activation_reason, v
 
 				const int      lsb_offset = stride_src * hh;
 
-				for (int y = 0; y < hh; ++y)
-				{
-					for (int x = 0; x < pw; ++x)
-					{
-						const int      msb = data_src_ptr [x             ];
-						const int      lsb = data_src_ptr [x + lsb_offset];
-						reinterpret_cast <uint16_t *> (data_dst_ptr) [x] =
-							uint16_t ((msb << 8) + lsb);
-					}
-
-					data_src_ptr += stride_src;
-					data_dst_ptr += stride_dst;
-				}
+				blitter.bitblt (
+					fmtcl::SplFmt_INT16, 16,
+					data_dst_ptr, 0, stride_dst,
+					fmtcl::SplFmt_STACK16, 16,
+					data_src_ptr, data_src_ptr + lsb_offset, stride_src,
+					pw, hh
+				);
 			}
 		}
 	}
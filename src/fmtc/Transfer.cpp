@@ -82,6 +82,7 @@ Transfer::Transfer (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, :
 ,	_loglut_flag (false)
 ,	_plane_processor (vsapi, *this, "transfer", true)
 ,	_lut_uptr ()
+,	_stripe_scheduler ()
 {
 	fstb::conv_to_lower_case (_transs);
 	fstb::conv_to_lower_case (_transd);
@@ -90,6 +91,8 @@ Transfer::Transfer (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, :
 	_sse2_flag = cpu_opt.has_sse2 ();
 	_avx2_flag = cpu_opt.has_avx2 ();
 
+	_plane_processor.set_mt_planes (get_arg_int (in, out, "mtplanes", 0) != 0);
+
 	// Checks the input clip
 	if (_vi_in.format == 0)
 	{
@@ -215,19 +218,11 @@ int	Transfer::do_process_plane (::VSFrameRef &dst, int n, int plane_index, void
 			_vsapi.getFrameFilter (n, src_node1_sptr.get (), &frame_ctx),
 			_vsapi
 		);
-		const ::VSFrameRef & src = *src_sptr;
-
-		const int      w = _vsapi.getFrameWidth (&src, plane_index);
-		const int      h = _vsapi.getFrameHeight (&src, plane_index);
 
-		const uint8_t* data_src_ptr = _vsapi.getReadPtr (&src, plane_index);
-		const int      stride_src   = _vsapi.getStride (&src, plane_index);
-		uint8_t *      data_dst_ptr = _vsapi.getWritePtr (&dst, plane_index);
-		const int      stride_dst   = _vsapi.getStride (&dst, plane_index);
+		PlaneBuf       buf;
+		_plane_processor.get_plane_buf (buf, dst, src_sptr.get (), plane_index);
 
-		_lut_uptr->process_plane (
-			data_dst_ptr, data_src_ptr, stride_dst, stride_src, w, h
-		);
+		ret_val = do_process_plane_buf (buf, n, plane_index, frame_data_ptr);
 	}
 
 	return (ret_val);
@@ -235,6 +230,19 @@ int	Transfer::do_process_plane (::VSFrameRef &dst, int n, int plane_index, void
 
 
 
+int	Transfer::do_process_plane_buf (const PlaneBuf &buf, int /*n*/, int /*plane_index*/, void * /*frame_data_ptr*/)
+{
+	_stripe_scheduler.process_plane (
+		*_lut_uptr,
+		buf._dst_ptr, buf._src_ptr, buf._dst_stride, buf._src_stride,
+		buf._src_w, buf._src_h
+	);
+
+	return (0);
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
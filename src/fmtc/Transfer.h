@@ -36,6 +36,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "vsutl/NodeRefSPtr.h"
 #include "vsutl/PlaneProcCbInterface.h"
 #include "vsutl/PlaneProcessor.h"
+#include "vsutl/StripeScheduler.h"
 #include "VapourSynth.h"
 
 #include <memory>
@@ -72,6 +73,7 @@ protected:
 
 	// vsutl::PlaneProcCbInterface
 	virtual int    do_process_plane (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const vsutl::NodeRefSPtr &src_node1_sptr, const vsutl::NodeRefSPtr &src_node2_sptr, const vsutl::NodeRefSPtr &src_node3_sptr);
+	virtual int    do_process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void *frame_data_ptr);
 
 
 
@@ -116,6 +118,8 @@ private:
 
 	std::unique_ptr <fmtcl::TransLut>
 	               _lut_uptr;
+	vsutl::StripeScheduler
+	               _stripe_scheduler;
 
 
 
@@ -54,9 +54,10 @@ namespace fmtcl
 
 
 
-BitBltConv::BitBltConv (bool sse2_flag, bool avx2_flag)
+BitBltConv::BitBltConv (bool sse2_flag, bool avx2_flag, bool fma_flag)
 :	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
+,	_fma_flag (fma_flag)
 {
 	// Nothing
 }
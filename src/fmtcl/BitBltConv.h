@@ -54,7 +54,7 @@ public:
 		double         _add_cst = 0;
 	};
 
-	explicit       BitBltConv (bool sse2_flag, bool avx2_flag);
+	explicit       BitBltConv (bool sse2_flag, bool avx2_flag, bool fma_flag);
 	               BitBltConv (const BitBltConv &other) = default;
 	virtual        ~BitBltConv () {}
 
@@ -92,7 +92,7 @@ private:
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	template <bool SF, class SRC, int SBD>
 	static void    bitblt_int_to_flt_sse2 (uint8_t *dst_ptr, int dst_stride, typename SRC::PtrConst::Type src_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr);
-	template <bool SF, class SRC, int SBD>
+	template <bool SF, bool FMA_FLAG, class SRC, int SBD>
 	static void    bitblt_int_to_flt_avx2 (uint8_t *dst_ptr, int dst_stride, typename SRC::PtrConst::Type src_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr);
 #endif
 
@@ -101,7 +101,7 @@ private:
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	template <bool SF, class DST>
 	static void    bitblt_flt_to_int_sse2 (typename DST::Ptr::Type dst_ptr, int dst_stride, const uint8_t *src_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr);
-	template <bool SF, class DST>
+	template <bool SF, bool FMA_FLAG, class DST>
 	static void    bitblt_flt_to_int_avx2 (typename DST::Ptr::Type dst_ptr, int dst_stride, const uint8_t *src_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr);
 #endif
 
@@ -118,6 +118,7 @@ private:
 
 	bool           _sse2_flag;
 	bool           _avx2_flag;
+	bool           _fma_flag;     // Scaled conversions only, requires _avx2_flag
 
 
 
@@ -55,6 +55,18 @@ namespace fmtcl
 
 
 
+// x * gain + add_cst
+template <bool FMA_FLAG>
+static fstb_FORCEINLINE __m256	BitBltConv_mul_add_avx2 (__m256 x, __m256 gain, __m256 add_cst)
+{
+	return ((FMA_FLAG)
+		? _mm256_fmadd_ps (x, gain, add_cst)
+		: _mm256_add_ps (_mm256_mul_ps (x, gain), add_cst)
+	);
+}
+
+
+
 void	BitBltConv::bitblt_int_to_flt_avx2_switch (uint8_t *dst_ptr, int dst_stride, fmtcl::SplFmt src_fmt, int src_res, const uint8_t *src_ptr, const uint8_t *src_lsb_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
 {
 	const uint8_t *                    src_i08_ptr (src_ptr);
@@ -64,29 +76,36 @@ void	BitBltConv::bitblt_int_to_flt_avx2_switch (uint8_t *dst_ptr, int dst_stride
 	);
 
 	const bool     scale_flag = ! is_si_neutral (scale_info_ptr);
+	const bool     fma_flag   = (scale_flag && _fma_flag);
 
-#define	fmtcl_BitBltConv_CASE(SCF, SFMT, SRES, SPTR) \
-	case	((SCF << 16) + (SplFmt_##SFMT << 8) + SRES): \
-		bitblt_int_to_flt_avx2 <SCF, ProxyRwAvx2 <SplFmt_##SFMT>, SRES> ( \
+#define	fmtcl_BitBltConv_CASE(SCF, FMA, SFMT, SRES, SPTR) \
+	case	((FMA << 17) + (SCF << 16) + (SplFmt_##SFMT << 8) + SRES): \
+		bitblt_int_to_flt_avx2 <SCF, FMA, ProxyRwAvx2 <SplFmt_##SFMT>, SRES> ( \
 			dst_ptr, dst_stride, src_##SPTR##_ptr, src_stride, \
 			w, h, scale_info_ptr \
 		); \
 		break;
 
-	switch ((scale_flag << 16) + (src_fmt << 8) + src_res)
+	switch ((fma_flag << 17) + (scale_flag << 16) + (src_fmt << 8) + src_res)
 	{
-	fmtcl_BitBltConv_CASE (false, STACK16, 16, s16)
-	fmtcl_BitBltConv_CASE (false, INT16  , 16, i16)
-	fmtcl_BitBltConv_CASE (false, INT16  , 12, i16)
-	fmtcl_BitBltConv_CASE (false, INT16  , 10, i16)
-	fmtcl_BitBltConv_CASE (false, INT16  ,  9, i16)
-	fmtcl_BitBltConv_CASE (false, INT8   ,  8, i08)
-	fmtcl_BitBltConv_CASE (true , STACK16, 16, s16)
-	fmtcl_BitBltConv_CASE (true , INT16  , 16, i16)
-	fmtcl_BitBltConv_CASE (true , INT16  , 12, i16)
-	fmtcl_BitBltConv_CASE (true , INT16  , 10, i16)
-	fmtcl_BitBltConv_CASE (true , INT16  ,  9, i16)
-	fmtcl_BitBltConv_CASE (true , INT8   ,  8, i08)
+	fmtcl_BitBltConv_CASE (false, false, STACK16, 16, s16)
+	fmtcl_BitBltConv_CASE (false, false, INT16  , 16, i16)
+	fmtcl_BitBltConv_CASE (false, false, INT16  , 12, i16)
+	fmtcl_BitBltConv_CASE (false, false, INT16  , 10, i16)
+	fmtcl_BitBltConv_CASE (false, false, INT16  ,  9, i16)
+	fmtcl_BitBltConv_CASE (false, false, INT8   ,  8, i08)
+	fmtcl_BitBltConv_CASE (true , false, STACK16, 16, s16)
+	fmtcl_BitBltConv_CASE (true , false, INT16  , 16, i16)
+	fmtcl_BitBltConv_CASE (true , false, INT16  , 12, i16)
+	fmtcl_BitBltConv_CASE (true , false, INT16  , 10, i16)
+	fmtcl_BitBltConv_CASE (true , false, INT16  ,  9, i16)
+	fmtcl_BitBltConv_CASE (true , false, INT8   ,  8, i08)
+	fmtcl_BitBltConv_CASE (true , true , STACK16, 16, s16)
+	fmtcl_BitBltConv_CASE (true , true , INT16  , 16, i16)
+	fmtcl_BitBltConv_CASE (true , true , INT16  , 12, i16)
+	fmtcl_BitBltConv_CASE (true , true , INT16  , 10, i16)
+	fmtcl_BitBltConv_CASE (true , true , INT16  ,  9, i16)
+	fmtcl_BitBltConv_CASE (true , true , INT8   ,  8, i08)
 	default:
 		assert (false);
 		throw std::logic_error (
@@ -108,21 +127,24 @@ void	BitBltConv::bitblt_flt_to_int_avx2_switch (fmtcl::SplFmt dst_fmt, int dst_r
 	);
 
 	const bool     scale_flag = ! is_si_neutral (scale_info_ptr);
+	const bool     fma_flag   = (scale_flag && _fma_flag);
 
-#define	fmtcl_BitBltConv_CASE(SCF, DFMT, DPTR) \
-	case	(SCF << 4) + SplFmt_##DFMT: \
-		bitblt_flt_to_int_avx2 <SCF, ProxyRwAvx2 <SplFmt_##DFMT> > ( \
+#define	fmtcl_BitBltConv_CASE(SCF, FMA, DFMT, DPTR) \
+	case	(FMA << 5) + (SCF << 4) + SplFmt_##DFMT: \
+		bitblt_flt_to_int_avx2 <SCF, FMA, ProxyRwAvx2 <SplFmt_##DFMT> > ( \
 			dst_##DPTR##_ptr, dst_stride, src_ptr, src_stride, \
 			w, h, scale_info_ptr \
 		); \
 		break;
 
-	switch ((scale_flag << 4) + dst_fmt)
+	switch ((fma_flag << 5) + (scale_flag << 4) + dst_fmt)
 	{
-	fmtcl_BitBltConv_CASE (false, STACK16, s16)
-	fmtcl_BitBltConv_CASE (false, INT16  , i16)
-	fmtcl_BitBltConv_CASE (true , STACK16, s16)
-	fmtcl_BitBltConv_CASE (true , INT16  , i16)
+	fmtcl_BitBltConv_CASE (false, false, STACK16, s16)
+	fmtcl_BitBltConv_CASE (false, false, INT16  , i16)
+	fmtcl_BitBltConv_CASE (true , false, STACK16, s16)
+	fmtcl_BitBltConv_CASE (true , false, INT16  , i16)
+	fmtcl_BitBltConv_CASE (true , true , STACK16, s16)
+	fmtcl_BitBltConv_CASE (true , true , INT16  , i16)
 	default:
 		assert (false);
 		throw std::logic_error (
@@ -189,7 +211,7 @@ void	BitBltConv::bitblt_int_to_int_avx2_switch (fmtcl::SplFmt dst_fmt, int dst_r
 
 // Stride offsets are still in bytes
 // Destination pointer must be 32-byte aligned!
-template <bool SF, class SRC, int SBD>
+template <bool SF, bool FMA_FLAG, class SRC, int SBD>
 void	BitBltConv::bitblt_int_to_flt_avx2 (uint8_t *dst_ptr, int dst_stride, typename SRC::PtrConst::Type src_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
 {
 	assert (fstb::ToolsAvx2::check_ptr_align (dst_ptr));
@@ -227,8 +249,8 @@ void	BitBltConv::bitblt_int_to_flt_avx2 (uint8_t *dst_ptr, int dst_stride, typen
 			SRC::read_flt (cur_src_ptr, val_0007, val_0815, zero);
 			if (SF)
 			{
-				val_0007 = _mm256_add_ps (_mm256_mul_ps (val_0007, gain), add_cst);
-				val_0815 = _mm256_add_ps (_mm256_mul_ps (val_0815, gain), add_cst);
+				val_0007 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0007, gain, add_cst);
+				val_0815 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0815, gain, add_cst);
 			}
 			_mm256_store_ps (dst_flt_ptr + x    , val_0007);
 			_mm256_store_ps (dst_flt_ptr + x + 8, val_0815);
@@ -241,8 +263,8 @@ void	BitBltConv::bitblt_int_to_flt_avx2 (uint8_t *dst_ptr, int dst_stride, typen
 			SRC::read_flt (cur_src_ptr, val_0007, val_0815, zero);
 			if (SF)
 			{
-				val_0007 = _mm256_add_ps (_mm256_mul_ps (val_0007, gain), add_cst);
-				val_0815 = _mm256_add_ps (_mm256_mul_ps (val_0815, gain), add_cst);
+				val_0007 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0007, gain, add_cst);
+				val_0815 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0815, gain, add_cst);
 			}
 			_mm256_store_ps (dst_flt_ptr + w16, val_0007);
 			if (w15 > 8)
@@ -259,7 +281,7 @@ void	BitBltConv::bitblt_int_to_flt_avx2 (uint8_t *dst_ptr, int dst_stride, typen
 
 
 // Stride offsets are still in bytes
-template <bool SF, class DST>
+template <bool SF, bool FMA_FLAG, class DST>
 void	BitBltConv::bitblt_flt_to_int_avx2 (typename DST::Ptr::Type dst_ptr, int dst_stride, const uint8_t *src_ptr, int src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
 {
 	assert (DST::Ptr::check_ptr (dst_ptr));
@@ -301,8 +323,8 @@ void	BitBltConv::bitblt_flt_to_int_avx2 (typename DST::Ptr::Type dst_ptr, int ds
 			val_0815 = _mm256_loadu_ps (src_flt_ptr + x + 8);
 			if (SF)
 			{
-				val_0007 = _mm256_add_ps (_mm256_mul_ps (val_0007, gain), add_cst);
-				val_0815 = _mm256_add_ps (_mm256_mul_ps (val_0815, gain), add_cst);
+				val_0007 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0007, gain, add_cst);
+				val_0815 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0815, gain, add_cst);
 			}
 			DST::write_flt (
 				cur_dst_ptr, val_0007, val_0815, mask_lsb, sign_bit, offset
@@ -318,8 +340,8 @@ void	BitBltConv::bitblt_flt_to_int_avx2 (typename DST::Ptr::Type dst_ptr, int ds
 			);
 			if (SF)
 			{
-				val_0007 = _mm256_add_ps (_mm256_mul_ps (val_0007, gain), add_cst);
-				val_0815 = _mm256_add_ps (_mm256_mul_ps (val_0815, gain), add_cst);
+				val_0007 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0007, gain, add_cst);
+				val_0815 = BitBltConv_mul_add_avx2 <FMA_FLAG> (val_0815, gain, add_cst);
 			}
 			DST::write_flt_partial (
 				cur_dst_ptr, val_0007, val_0815, mask_lsb, sign_bit, offset, w15
@@ -26,6 +26,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fmtcl/CoefArrInt.h"
 
+#include <algorithm>
+
 #include <cassert>
 #include <cstring>
 
@@ -43,6 +45,7 @@ namespace fmtcl
 void	CoefArrInt::clear ()
 {
 	_coef_arr.clear ();
+	_pair_arr.clear ();
 	_size = 0;
 }
 
@@ -62,9 +65,22 @@ void	CoefArrInt::resize (int size)
 {
 	assert (size >= 0);
 
+	const int      old_size = _size;
 	_size = size;
 	const int      size_i16 = _size << _vect_shift;
 	_coef_arr.resize (size_i16);
+
+	if (_avx2_flag)
+	{
+		_pair_arr.resize (size_i16);
+
+		// The second coefficient of the last common position has changed
+		const int      last_common = std::min (old_size, _size) - 1;
+		if (last_common >= 0 && old_size != _size)
+		{
+			update_pair (last_common);
+		}
+	}
 }
 
 
@@ -81,6 +97,15 @@ void	CoefArrInt::set_coef (int pos, int val)
 	{
 		_coef_arr [pos_i16 + i] = int16_t (val);
 	}
+
+	if (_avx2_flag)
+	{
+		if (pos > 0)
+		{
+			update_pair (pos - 1);
+		}
+		update_pair (pos);
+	}
 }
 
 
@@ -97,6 +122,15 @@ void	CoefArrInt::set_coef_int32 (int pos, int val)
 	{
 		*(reinterpret_cast <int32_t *> (&_coef_arr [pos_i16 + i])) = int32_t (val);
 	}
+
+	if (_avx2_flag)
+	{
+		if (pos > 0)
+		{
+			update_pair (pos - 1);
+		}
+		update_pair (pos);
+	}
 }
 
 
@@ -117,6 +151,15 @@ void	CoefArrInt::copy_coef (int pos_to, int pos_from)
 			&_coef_arr [pos_from_i16],
 			sizeof (int16_t) << _vect_shift
 		);
+
+		if (_avx2_flag)
+		{
+			if (pos_to > 0)
+			{
+				update_pair (pos_to - 1);
+			}
+			update_pair (pos_to);
+		}
 	}
 }
 
@@ -130,6 +173,25 @@ void	CoefArrInt::copy_coef (int pos_to, int pos_from)
 
 
 
+void	CoefArrInt::update_pair (int pos)
+{
+	assert (_avx2_flag);
+	assert (pos >= 0);
+	assert (pos < _size);
+
+	const int      c0      = get_coef (pos);
+	const int      c1      = (pos + 1 < _size) ? get_coef (pos + 1) : 0;
+	const int      pos_i16 = pos * VECT_LEN_AVX2;
+
+	for (int i = 0; i < VECT_LEN_AVX2; i += 2)
+	{
+		_pair_arr [pos_i16 + i    ] = int16_t (c0);
+		_pair_arr [pos_i16 + i + 1] = int16_t (c1);
+	}
+}
+
+
+
 }	// namespace fmtcl
 
 
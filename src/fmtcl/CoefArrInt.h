@@ -72,6 +72,8 @@ public:
 	               use_vect_sse2 (int pos) const;
 	fstb_FORCEINLINE const int16_t *
 	               use_vect_avx2 (int pos) const;
+	fstb_FORCEINLINE const int16_t *
+	               use_vect_pair_avx2 (int pos) const;
 
 
 
@@ -85,8 +87,12 @@ protected:
 
 private:
 
+	void           update_pair (int pos);
+
 	std::vector <int16_t, fstb::AllocAlign <int16_t, 32> >
 	               _coef_arr;
+	std::vector <int16_t, fstb::AllocAlign <int16_t, 32> >
+	               _pair_arr;           // AVX2 only. Coefficients pos and pos + 1 interleaved, for _mm256_madd_epi16
 	bool           _avx2_flag  = false;
 	int            _size       = 0;
 	int            _vect_shift = 3;     // For SSE2
@@ -70,6 +70,18 @@ const int16_t *	CoefArrInt::use_vect_avx2 (int pos) const
 
 
 
+// The second coefficient of the last position is 0.
+const int16_t *	CoefArrInt::use_vect_pair_avx2 (int pos) const
+{
+	assert (_avx2_flag);
+	assert (pos >= 0);
+	assert (pos < _size);
+
+	return (&_pair_arr [pos * VECT_LEN_AVX2]);
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -32,7 +32,9 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/FilterResize.h"
 #include "fmtcl/ResampleSpecPlane.h"
 #include "fmtcl/Scaler.h"
+#include "fstb/CpuId.h"
 #include "fstb/fnc.h"
+#include "AvstpScopedDispatcher.h"
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	#if ! defined (_WIN64) && ! defined (__64BIT__) && ! defined (__amd64__) && ! defined (__x86_64__)
@@ -60,7 +62,7 @@ namespace fmtcl
 
 
 
-FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag)
+FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag, bool fma_flag, int tile_size)
 :	_avstp (AvstpWrapper::use_instance ())
 ,	_task_rsz_pool ()
 /*,	_src_size ()
@@ -84,12 +86,15 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 ,	_int_flag (int_flag && _src_type != SplFmt_FLOAT && _dst_type != SplFmt_FLOAT)
 ,	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
-,	_pool ()
+,	_avx512_flag (avx512_flag)
+,	_fma_flag (fma_flag)
+,	_hori_flag (false)
+,	_pool_arr ()
 ,	_factory_uptr ()
 /*,	_crop_pos ()
 ,	_crop_size ()*/
 ,	_scaler_uptr ()
-,	_blitter (sse2_flag, avx2_flag)
+,	_blitter (sse2_flag, avx2_flag, fma_flag)
 /*,	_resize_flag ()
 ,	_roadmap ()
 ,	_tile_size_dst ()*/
@@ -166,6 +171,18 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 		}
 	}
 
+	// With AVX2, the horizontal resizing of float data works straight on the
+	// rows, as long as the kernels of adjacent pixels are close enough to be
+	// read from a sliding window. Otherwise, the tile is transposed back and
+	// forth around a vertical resizing pass. The integer path keeps the
+	// transpositions, they are cheap on 16-bit data.
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	_hori_flag = (
+		   _resize_flag [Dir_H] && _avx2_flag && ! _int_flag
+		&& _win_size [Dir_H] <= _dst_size [Dir_H] * HORI_MAX_DOWNSCALE
+	);
+#endif
+
 	// Finds the scaling order
 	const double		r_h = _dst_size [Dir_H] / _win_size [Dir_H];
 	const double		r_v = _dst_size [Dir_V] / _win_size [Dir_V];
@@ -177,6 +194,25 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 	vert_last_flag = (vert_last_flag ||   (r_v / r_h > 8 && r_v > 4));
 	vert_last_flag = (vert_last_flag && ! (r_h / r_v > 8 && r_h > 4));
 
+	// When both directions of float data are resized, the estimated costs of
+	// the two orders decide. The ratio-based rules above are only kept to
+	// break the ties. The integer path always keeps them: its intermediate
+	// results are rounded and clipped, so the order changes the output.
+	if (! _int_flag && _resize_flag [Dir_H] && _resize_flag [Dir_V])
+	{
+		const double   cost_v_first = eval_roadmap_cost (false);
+		const double   cost_v_last  = eval_roadmap_cost (true);
+		const double   margin       = 1 - COST_MARGIN_PCT * 0.01;
+		if (cost_v_first < cost_v_last * margin)
+		{
+			vert_last_flag = false;
+		}
+		else if (cost_v_last < cost_v_first * margin)
+		{
+			vert_last_flag = true;
+		}
+	}
+
 	// Builds a roadmap
 	_buffer_flag = false;
 	int					rm_pos = 0;
@@ -188,10 +224,18 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 	if (_resize_flag [Dir_H])
 	{
 		_buffer_flag = true;
-		_roadmap [rm_pos    ] = PassType_TRANSPOSE;
-		_roadmap [rm_pos + 1] = PassType_RESIZE;
-		_roadmap [rm_pos + 2] = PassType_TRANSPOSE;
-		rm_pos += 3;
+		if (_hori_flag)
+		{
+			_roadmap [rm_pos] = PassType_RESIZE_H;
+			++ rm_pos;
+		}
+		else
+		{
+			_roadmap [rm_pos    ] = PassType_TRANSPOSE;
+			_roadmap [rm_pos + 1] = PassType_RESIZE;
+			_roadmap [rm_pos + 2] = PassType_TRANSPOSE;
+			rm_pos += 3;
+		}
 	}
 	if (_resize_flag [Dir_V] && vert_last_flag)
 	{
@@ -220,175 +264,33 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 	// Computes the tile size (if required)
 	if (_buffer_flag)
 	{
-		const int      tile_dst_min_w = std::min (_dst_size [Dir_H], int (Scaler::SRC_ALIGN));
-		const int      tile_dst_min_h = 1;
-
-		int            tile_dst_w  = 0;
-		int            tile_dst_h  = 0;
-		bool           bigger_flag = false;
-		do
+		const int      tile_size_kb = std::max (tile_size, 0);
+		int            buf_size     = compute_buf_size (tile_size_kb);
+		compute_tile_size (buf_size, vert_last_flag);
+
+		// Makes the tiles smaller until there are enough of them to keep all
+		// the threads busy. The buffer size is not changed if it was given
+		// explicitly.
+		const int      nbr_threads   = _avstp.get_nbr_threads ();
+		const int      nbr_tiles_min =
+			(nbr_threads > 1) ? nbr_threads * TILES_PER_THREAD : 1;
+		while (   tile_size_kb == 0
+		       && count_tiles () < nbr_tiles_min
+		       && buf_size > MIN_BUF_SIZE)
 		{
-			bigger_flag = false;
-
-			int            tile_src_min_w;
-			int            tile_src_min_h;
-			compute_req_src_tile_size (
-				tile_src_min_w,
-				tile_src_min_h,
-				tile_dst_min_w,
-				tile_dst_min_h
-			);
-			tile_src_min_w = (tile_src_min_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
-			tile_src_min_h = (tile_src_min_h + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
-
-			// First computes a well-balanced source size
-			int            tile_src_w = tile_src_min_w;
-			int            tile_src_h = tile_src_min_h;
-			const double   a = 1;
-			const double   b = tile_src_min_w + tile_src_min_h;
-			const double   c = tile_src_min_w * tile_src_min_h - _buf_size;
-			const double   d = b * b - 4 * a * c;
-			const int      l = fstb::round_int ((sqrt (d) - b) / (2 * a));
-
-			tile_src_w = (l + tile_src_min_w);
-			bool           search_flag = true;
-			do
-			{
-				const int      old_tile_src_w = tile_src_w;
-				tile_src_w = std::min (tile_src_w, _crop_size [Dir_H]);
-				if (_resize_flag [Dir_V])
-				{
-					tile_src_w = (tile_src_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
-				}
-				tile_src_h = _buf_size / tile_src_w;
-				tile_src_h = std::min (tile_src_h, _crop_size [Dir_V] + Scaler::SRC_ALIGN - 1);
-				tile_src_h &= -Scaler::SRC_ALIGN;
-				search_flag = (tile_src_h < std::min (tile_src_min_h, _crop_size [Dir_V]));
-				if (search_flag)
-				{
-					tile_src_w = old_tile_src_w / 2;
-					if (   tile_src_w < tile_src_min_w
-					    || tile_src_w >= old_tile_src_w)
-					{
-						// Try again with a bigger buffer.
-						search_flag = false;
-						bigger_flag = true;
-					}
-				}
-			}
-			while (search_flag);
-
-			if (! bigger_flag)
-			{
-				// Computes the equivalent destination size
-				tile_dst_w = tile_src_w;
-				if (_resize_flag [Dir_H])
-				{
-					tile_dst_w = Scaler::eval_lower_bound_of_dst_tile_height (
-						tile_src_w,
-						_dst_size [Dir_H],
-						_win_size [Dir_H],
-						*(_kernel_ptr_arr [Dir_H]),
-						_kernel_scale [Dir_H],
-						_crop_size [Dir_H]
-					);
-					tile_dst_w = std::max (tile_dst_w, tile_dst_min_w);
-				}
-
-				tile_dst_h = tile_src_h;
-				if (_resize_flag [Dir_V])
-				{
-					tile_dst_h = Scaler::eval_lower_bound_of_dst_tile_height (
-						tile_src_h,
-						_dst_size [Dir_V],
-						_win_size [Dir_V],
-						*(_kernel_ptr_arr [Dir_V]),
-						_kernel_scale [Dir_V],
-						_crop_size [Dir_V]
-					);
-					tile_dst_h = std::max (tile_dst_h, tile_dst_min_h);
-				}
-
-				// Limits the destination size
-				if (! vert_last_flag)	// If we use a buffer for the last step
-				{
-					const double   area_final = double (tile_dst_w) * double (tile_dst_h);
-					assert (area_final > 0);
-					const double   fix_final = sqrt (_buf_size / area_final);
-					if (fix_final < 1)
-					{
-						tile_dst_w = fstb::floor_int (tile_dst_w * fix_final) & -Scaler::SRC_ALIGN;
-						tile_dst_h = fstb::floor_int (tile_dst_h * fix_final) & -Scaler::SRC_ALIGN;
-					}
-				}
-
-				// Limits the temporary size
-				if (vert_last_flag)
-				{
-					const int      stride =
-						(tile_dst_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
-					const double   area_tmp = stride * tile_src_h;
-					assert (area_tmp > 0);
-					const double   fix_tmp = _buf_size / area_tmp;
-					if (fix_tmp < 1)
-					{
-						tile_dst_w = fstb::floor_int (tile_dst_w * fix_tmp);
-					}
-//					tile_dst_h &= -Scaler::SRC_ALIGN;
-				}
-				else
-				{
-					const int      stride =
-						(tile_src_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
-					const double   area_tmp = stride * tile_dst_h;
-					assert (area_tmp > 0);
-					const double   fix_tmp = _buf_size / area_tmp;
-					if (fix_tmp < 1)
-					{
-						tile_dst_h = fstb::floor_int (tile_dst_h * fix_tmp) & -Scaler::SRC_ALIGN;
-					}
-//					tile_dst_w &= -Scaler::SRC_ALIGN;
-				}
-
-				// For the last step, we need to ensure that the window width is well
-				// aligned, otherwise we might overflow the end of the lines by
-				// starting the rightmost tile on an unaligned column.
-				if (tile_dst_w < _dst_size [Dir_H])
-				{
-					tile_dst_w &= -Scaler::SRC_ALIGN;
-				}
-
-				if (tile_dst_w <= 0 || tile_dst_h <= 0)
-				{
-					bigger_flag = true;
-				}
-			}	// bigger_flag
-
-			if (bigger_flag)
-			{
-				_buf_size <<= 1;
-				if (_buf_size > MAX_BUF_SIZE)
-				{
-					bigger_flag = false;
-					throw std::runtime_error (
-						"Dither_resize16: "
-						"resizing ratio too low or kernel support too high."
-					);
-				}
-			}
+			buf_size >>= 1;
+			compute_tile_size (buf_size, vert_last_flag);
 		}
-		while (bigger_flag);
-
-		tile_dst_w = std::max (tile_dst_w, int (Scaler::SRC_ALIGN));
-		tile_dst_h = std::max (tile_dst_h, 1);
-
-		_tile_size_dst [Dir_H] = tile_dst_w;
-		_tile_size_dst [Dir_V] = tile_dst_h;
 
 		_factory_uptr = std::unique_ptr <ResizeDataFactory> (
 			new ResizeDataFactory (_buf_size, 1)
 		);
-		_pool.set_factory (*_factory_uptr);
+		const int      nbr_nodes = std::max (_avstp.get_nbr_nodes (), 1);
+		for (int node = 0; node < nbr_nodes; ++node)
+		{
+			_pool_arr.push_back (ResizeDataPoolUPtr (new ResizeDataPool));
+			_pool_arr.back ()->set_factory (*_factory_uptr);
+		}
 	}
 
 	// ! buffer_flag
@@ -424,16 +326,26 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 					*(_kernel_ptr_arr [dir]), _kernel_scale [dir],
 					_norm_flag, _norm_val [dir],
 					_center_pos_src [dir], _center_pos_dst [dir],
-					dir_gain, dir_acst, _int_flag, _sse2_flag, _avx2_flag
+					dir_gain, dir_acst, _int_flag,
+					_sse2_flag, _avx2_flag, _avx512_flag, _fma_flag
 				));
 			}
 		}
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		if (_hori_flag)
+		{
+			_scaler_uptr [Dir_H]->prepare_hori (_tile_size_dst [Dir_H]);
+		}
+#endif
 	}
 }
 
 
 
-void	FilterResize::process_plane (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, bool chroma_flag)
+// stats_ptr: if not 0, receives the scheduling statistics of the plane, or
+// is cleared if they are not available.
+void	FilterResize::process_plane (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, bool chroma_flag, AvstpStats *stats_ptr)
 {
 	assert (dst_msb_ptr != 0);
 	assert (src_msb_ptr != 0);
@@ -447,13 +359,17 @@ void	FilterResize::process_plane (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, co
 			src_msb_ptr, src_lsb_ptr,
 			stride_dst, stride_src, chroma_flag
 		);
+		if (stats_ptr != 0)
+		{
+			stats_ptr->clear ();
+		}
 	}
 	else
 	{
 		process_plane_normal (
 			dst_msb_ptr, dst_lsb_ptr,
 			src_msb_ptr, src_lsb_ptr,
-			stride_dst, stride_src
+			stride_dst, stride_src, stats_ptr
 		);
 	}
 }
@@ -506,7 +422,7 @@ void	FilterResize::process_plane_bypass (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_
 
 
 
-void	FilterResize::process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src)
+void	FilterResize::process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, AvstpStats *stats_ptr)
 {
 	assert (_nbr_passes > 0);
 	assert (dst_msb_ptr != 0);
@@ -514,8 +430,6 @@ void	FilterResize::process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_
 	assert (stride_dst > 0);
 	assert (stride_src > 0);
 
-	avstp_TaskDispatcher *	task_dispatcher_ptr = _avstp.create_dispatcher ();
-
 	TaskRszGlobal	trg;
 	trg._this_ptr       = this;
 	trg._dst_msb_ptr    = dst_msb_ptr;
@@ -533,6 +447,9 @@ void	FilterResize::process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_
 	assert (stride_dst % trg._dst_bpp == 0);
 	assert (stride_src % trg._src_bpp == 0);
 
+	// After trg, which is used by the tasks
+	AvstpScopedDispatcher   task_dispatcher (_avstp);
+
 	int            dst_beg [Dir_NBR_ELT]  = { 0, 0 };
 	int            work_dst [Dir_NBR_ELT] = { 0, 0 };
 	int            src_beg [Dir_NBR_ELT]  = { 0, 0 };
@@ -610,18 +527,19 @@ void	FilterResize::process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_
 			}
 
 			_avstp.enqueue_task (
-				task_dispatcher_ptr,
+				task_dispatcher.get_ptr (),
 				&redirect_task_resize,
 				tr_cell_ptr
 			);
 		}	// for Dir_H
 	}	// for Dir_V
 
-	_avstp.wait_completion (task_dispatcher_ptr);
+	_avstp.wait_completion (task_dispatcher.get_ptr ());
 
-	// Done
-	_avstp.destroy_dispatcher (task_dispatcher_ptr);
-	task_dispatcher_ptr = 0;
+	if (stats_ptr != 0)
+	{
+		_avstp.get_stats (task_dispatcher.get_ptr (), *stats_ptr);
+	}
 }
 
 
@@ -642,12 +560,20 @@ void	FilterResize::process_tile (TaskRszCell &tr_cell)
 	const TaskRszGlobal& trg = *(tr._glob_data_ptr);
 	assert (trg._this_ptr == this);
 
-	ResizeData *   rd_ptr = 0;
+	ResizeData *   rd_ptr   = 0;
+	ResizeDataPool *
+	               pool_ptr = 0;
 	if (_buffer_flag)
 	{
 		assert (_factory_uptr.get () != 0);
 
-		rd_ptr = _pool.take_obj ();
+		// The buffer memory is first touched by the constructor of the
+		// object, so new buffers are allocated on the current node.
+		const int      node = _avstp.get_cur_node ();
+		assert (node >= 0);
+		assert (node < int (_pool_arr.size ()));
+		pool_ptr = _pool_arr [node].get ();
+		rd_ptr   = pool_ptr->take_obj ();
 		if (rd_ptr == 0)
 		{
 			throw std::runtime_error (
@@ -693,6 +619,14 @@ void	FilterResize::process_tile (TaskRszCell &tr_cell)
 			}
 			break;
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		case	PassType_RESIZE_H:
+			process_tile_resize_h (
+				tr, trg, *rd_ptr, stride_buf, pass, cur_dir, cur_buf, cur_size
+			);
+			break;
+#endif
+
 		case	PassType_NONE:
 			// Nothing
 			break;
@@ -704,7 +638,7 @@ void	FilterResize::process_tile (TaskRszCell &tr_cell)
 
 	if (rd_ptr != 0)
 	{
-		_pool.return_obj (*rd_ptr);
+		pool_ptr->return_obj (*rd_ptr);
 		rd_ptr = 0;
 	}
 
@@ -934,6 +868,118 @@ void	FilterResize::process_tile_resize (const TaskRsz &tr, const TaskRszGlobal&
 
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+// Horizontal resizing without transposition, on float data. The tile keeps
+// its orientation: the source is converted to float first if required, and
+// the result is converted to the output format afterwards.
+void	FilterResize::process_tile_resize_h (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, int stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT])
+{
+	assert (cur_dir == Dir_V);
+	assert (! _int_flag);
+
+	stride_buf [1 - cur_buf] =
+		(tr._work_dst [Dir_H] + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+	assert (cur_size [Dir_V] * stride_buf [1 - cur_buf] <= _buf_size);
+
+	const float *   ptr_src      = rd.use_buf <float> (    cur_buf);
+	int             stride_src   = stride_buf [    cur_buf]; // Pixels
+	int             offset_src   = 0;
+	const bool      src_buf_flag = has_buf_src (pass);
+
+	float *         ptr_dst      = rd.use_buf <float> (1 - cur_buf);
+	int             stride_dst   = stride_buf [1 - cur_buf]; // Pixels
+	int             offset_dst   = 0;
+	const bool      dst_buf_flag = has_buf_dst (pass);
+
+	if (! src_buf_flag)
+	{
+		offset_src =            // In bytes
+			  trg._offset_crop
+			+ tr._src_beg [Dir_V] * trg._stride_src
+			+ tr._src_beg [Dir_H] * trg._src_bpp;
+
+		// Direct access
+		if (_src_type == SplFmt_FLOAT)
+		{
+			ptr_src    = reinterpret_cast <const float *> (
+				trg._src_msb_ptr + offset_src
+			);
+			stride_src = trg._stride_src_pix;
+		}
+
+		// Converts input in buffer type
+		else
+		{
+			stride_src =
+				(cur_size [Dir_H] + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+			assert (cur_size [Dir_V] * stride_src <= _buf_size);
+
+			_blitter.bitblt (
+				SplFmt_FLOAT, sizeof (float) * CHAR_BIT,
+				rd.use_buf <uint8_t> (cur_buf),
+				0,
+				stride_src * sizeof (float),
+				_src_type, _src_res,
+				trg._src_msb_ptr + offset_src,
+				trg._src_lsb_ptr + offset_src,
+				trg._stride_src,
+				cur_size [Dir_H], cur_size [Dir_V],
+				0
+			);
+		}
+	}
+	if (! dst_buf_flag)
+	{
+		offset_dst =            // In bytes
+			  tr._dst_beg [Dir_V] * trg._stride_dst
+			+ tr._dst_beg [Dir_H] * trg._dst_bpp;
+
+		if (_dst_type == SplFmt_FLOAT)
+		{
+			ptr_dst    = reinterpret_cast <float *> (
+				trg._dst_msb_ptr + offset_dst
+			);
+			stride_dst = trg._stride_dst_pix;
+		}
+	}
+
+	_scaler_uptr [Dir_H]->process_plane_hori (
+		ptr_dst,
+		ptr_src,
+		stride_dst,
+		stride_src,
+		cur_size [Dir_V],
+		tr._dst_beg [Dir_H],
+		tr._dst_beg [Dir_H] + tr._work_dst [Dir_H]
+	);
+
+	cur_size [Dir_H] = tr._work_dst [Dir_H];
+
+	cur_buf = 1 - cur_buf;
+
+	// Last pass: converts to output format if required
+	if (! dst_buf_flag && _dst_type != SplFmt_FLOAT)
+	{
+		_blitter.bitblt (
+			_dst_type, _dst_res,
+			trg._dst_msb_ptr + offset_dst,
+			trg._dst_lsb_ptr + offset_dst,
+			trg._stride_dst,
+			SplFmt_FLOAT, sizeof (float) * CHAR_BIT,
+			rd.use_buf <const uint8_t> (cur_buf),
+			0,
+			stride_buf [cur_buf] * sizeof (float),
+			tr._work_dst [Dir_H], tr._work_dst [Dir_V],
+			0
+		);
+	}
+}
+
+#endif   // fstb_ARCHI_X86
+
+
+
 template <typename T, SplFmt BUFT>
 void	FilterResize::process_tile_transpose (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, int stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT])
 {
@@ -1054,7 +1100,15 @@ void	FilterResize::transpose (T *dst_ptr, const T *src_ptr, int w, int h, int st
 	assert (stride_dst > 0);
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-	if (_sse2_flag)
+	if (_avx512_flag)
+	{
+		transpose_avx512 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+	}
+	else if (_avx2_flag)
+	{
+		transpose_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+	}
+	else if (_sse2_flag)
 	{
 		transpose_sse2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
 	}
@@ -1318,6 +1372,279 @@ bool	FilterResize::has_buf_dst (int pass) const
 
 
 
+// Rough estimation of the processing cost of the roadmap, for a full frame.
+// Resizing passes count the kernel taps and the stored pixels, the horizontal
+// resizing pass also counts its two transpositions when it cannot work
+// straight on the rows. Tiling overhead is ignored, it is similar for both
+// orders.
+double	FilterResize::eval_roadmap_cost (bool vert_last_flag) const
+{
+	double         w = _crop_size [Dir_H];
+	double         h = _crop_size [Dir_V];
+	double         cost = 0;
+
+	for (int step = 0; step < Dir_NBR_ELT; ++step)
+	{
+		const Dir      dir = ((step == 0) == vert_last_flag) ? Dir_H : Dir_V;
+		if (_resize_flag [dir])
+		{
+			const int      fir_len = Scaler::eval_fir_len (
+				_crop_size [dir], _dst_size [dir], _win_size [dir],
+				*(_kernel_ptr_arr [dir]), _kernel_scale [dir]
+			);
+			double &       len_dir = (dir == Dir_H) ? w : h;
+			const double   len_ort = (dir == Dir_H) ? h : w;
+			const double   area_src = len_dir * len_ort;
+			len_dir = _dst_size [dir];
+			const double   area_dst = len_dir * len_ort;
+
+			cost += area_dst * (fir_len * COST_TAP + COST_WRITE);
+			if (dir == Dir_H && ! _hori_flag)
+			{
+				cost += (area_src + area_dst) * COST_TRANSP;
+			}
+		}
+	}
+
+	return (cost);
+}
+
+
+
+// Returns the initial number of pixels for each temporary buffer of the
+// tiles. tile_size_kb is the requested memory footprint of the buffers, in
+// KiB. 0 = automatic, based on the cache size of the CPU.
+int	FilterResize::compute_buf_size (int tile_size_kb) const
+{
+	assert (tile_size_kb >= 0);
+
+	int64_t        mem_size = 0;
+	if (tile_size_kb > 0)
+	{
+		mem_size = int64_t (tile_size_kb) << 10;
+	}
+	else
+	{
+		// Half of the L2 for the buffers, the other half for the source and
+		// destination lines, and the filter coefficients.
+		const fstb::CpuId cpu;
+		if (cpu._l2_size > 0)
+		{
+			mem_size = cpu._l2_size / 2;
+		}
+		else if (cpu._l3_size > 0)
+		{
+			mem_size = cpu._l3_size / (2 * std::max (_avstp.get_nbr_threads (), 1));
+		}
+	}
+
+	int            buf_size = BUF_SIZE;
+	if (mem_size > 0)
+	{
+		const int      pix_size =
+			(_int_flag) ? int (sizeof (int16_t)) : int (sizeof (float));
+		const int64_t  nbr_pix  = mem_size / (ResizeData::NBR_BUF * pix_size);
+		buf_size = int (std::min (
+			std::max (nbr_pix, int64_t (MIN_BUF_SIZE)),
+			int64_t (MAX_BUF_SIZE)
+		));
+	}
+
+	return (buf_size);
+}
+
+
+
+// Sets _buf_size and _tile_size_dst. The buffer size may be increased if the
+// tiles cannot fit in the requested size.
+// Throws: std::runtime_error if no valid tile size has been found
+void	FilterResize::compute_tile_size (int buf_size, bool vert_last_flag)
+{
+	assert (_buffer_flag);
+	assert (buf_size > 0);
+
+	_buf_size = buf_size;
+
+	const int      tile_dst_min_w = std::min (_dst_size [Dir_H], int (Scaler::SRC_ALIGN));
+	const int      tile_dst_min_h = 1;
+
+	int            tile_dst_w  = 0;
+	int            tile_dst_h  = 0;
+	bool           bigger_flag = false;
+	do
+	{
+		bigger_flag = false;
+
+		int            tile_src_min_w;
+		int            tile_src_min_h;
+		compute_req_src_tile_size (
+			tile_src_min_w,
+			tile_src_min_h,
+			tile_dst_min_w,
+			tile_dst_min_h
+		);
+		tile_src_min_w = (tile_src_min_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+		tile_src_min_h = (tile_src_min_h + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+
+		// First computes a well-balanced source size
+		int            tile_src_w = tile_src_min_w;
+		int            tile_src_h = tile_src_min_h;
+		const double   a = 1;
+		const double   b = tile_src_min_w + tile_src_min_h;
+		const double   c = tile_src_min_w * tile_src_min_h - _buf_size;
+		const double   d = b * b - 4 * a * c;
+		const int      l = fstb::round_int ((sqrt (d) - b) / (2 * a));
+
+		tile_src_w = (l + tile_src_min_w);
+		bool           search_flag = true;
+		do
+		{
+			const int      old_tile_src_w = tile_src_w;
+			tile_src_w = std::min (tile_src_w, _crop_size [Dir_H]);
+			if (_resize_flag [Dir_V])
+			{
+				tile_src_w = (tile_src_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+			}
+			tile_src_h = _buf_size / tile_src_w;
+			tile_src_h = std::min (tile_src_h, _crop_size [Dir_V] + Scaler::SRC_ALIGN - 1);
+			tile_src_h &= -Scaler::SRC_ALIGN;
+			search_flag = (tile_src_h < std::min (tile_src_min_h, _crop_size [Dir_V]));
+			if (search_flag)
+			{
+				tile_src_w = old_tile_src_w / 2;
+				if (   tile_src_w < tile_src_min_w
+				    || tile_src_w >= old_tile_src_w)
+				{
+					// Try again with a bigger buffer.
+					search_flag = false;
+					bigger_flag = true;
+				}
+			}
+		}
+		while (search_flag);
+
+		if (! bigger_flag)
+		{
+			// Computes the equivalent destination size
+			tile_dst_w = tile_src_w;
+			if (_resize_flag [Dir_H])
+			{
+				tile_dst_w = Scaler::eval_lower_bound_of_dst_tile_height (
+					tile_src_w,
+					_dst_size [Dir_H],
+					_win_size [Dir_H],
+					*(_kernel_ptr_arr [Dir_H]),
+					_kernel_scale [Dir_H],
+					_crop_size [Dir_H]
+				);
+				tile_dst_w = std::max (tile_dst_w, tile_dst_min_w);
+			}
+
+			tile_dst_h = tile_src_h;
+			if (_resize_flag [Dir_V])
+			{
+				tile_dst_h = Scaler::eval_lower_bound_of_dst_tile_height (
+					tile_src_h,
+					_dst_size [Dir_V],
+					_win_size [Dir_V],
+					*(_kernel_ptr_arr [Dir_V]),
+					_kernel_scale [Dir_V],
+					_crop_size [Dir_V]
+				);
+				tile_dst_h = std::max (tile_dst_h, tile_dst_min_h);
+			}
+
+			// Limits the destination size
+			if (! vert_last_flag)	// If we use a buffer for the last step
+			{
+				const double   area_final = double (tile_dst_w) * double (tile_dst_h);
+				assert (area_final > 0);
+				const double   fix_final = sqrt (_buf_size / area_final);
+				if (fix_final < 1)
+				{
+					tile_dst_w = fstb::floor_int (tile_dst_w * fix_final) & -Scaler::SRC_ALIGN;
+					tile_dst_h = fstb::floor_int (tile_dst_h * fix_final) & -Scaler::SRC_ALIGN;
+				}
+			}
+
+			// Limits the temporary size
+			if (vert_last_flag)
+			{
+				const int      stride =
+					(tile_dst_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+				const double   area_tmp = stride * tile_src_h;
+				assert (area_tmp > 0);
+				const double   fix_tmp = _buf_size / area_tmp;
+				if (fix_tmp < 1)
+				{
+					tile_dst_w = fstb::floor_int (tile_dst_w * fix_tmp);
+				}
+//					tile_dst_h &= -Scaler::SRC_ALIGN;
+			}
+			else
+			{
+				const int      stride =
+					(tile_src_w + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+				const double   area_tmp = stride * tile_dst_h;
+				assert (area_tmp > 0);
+				const double   fix_tmp = _buf_size / area_tmp;
+				if (fix_tmp < 1)
+				{
+					tile_dst_h = fstb::floor_int (tile_dst_h * fix_tmp) & -Scaler::SRC_ALIGN;
+				}
+//					tile_dst_w &= -Scaler::SRC_ALIGN;
+			}
+
+			// For the last step, we need to ensure that the window width is well
+			// aligned, otherwise we might overflow the end of the lines by
+			// starting the rightmost tile on an unaligned column.
+			if (tile_dst_w < _dst_size [Dir_H])
+			{
+				tile_dst_w &= -Scaler::SRC_ALIGN;
+			}
+
+			if (tile_dst_w <= 0 || tile_dst_h <= 0)
+			{
+				bigger_flag = true;
+			}
+		}	// bigger_flag
+
+		if (bigger_flag)
+		{
+			_buf_size <<= 1;
+			if (_buf_size > MAX_BUF_SIZE)
+			{
+				bigger_flag = false;
+				throw std::runtime_error (
+					"Dither_resize16: "
+					"resizing ratio too low or kernel support too high."
+				);
+			}
+		}
+	}
+	while (bigger_flag);
+
+	tile_dst_w = std::max (tile_dst_w, int (Scaler::SRC_ALIGN));
+	tile_dst_h = std::max (tile_dst_h, 1);
+
+	_tile_size_dst [Dir_H] = tile_dst_w;
+	_tile_size_dst [Dir_V] = tile_dst_h;
+}
+
+
+
+int	FilterResize::count_tiles () const
+{
+	const int      nbr_tiles_h =
+		(_dst_size [Dir_H] + _tile_size_dst [Dir_H] - 1) / _tile_size_dst [Dir_H];
+	const int      nbr_tiles_v =
+		(_dst_size [Dir_V] + _tile_size_dst [Dir_V] - 1) / _tile_size_dst [Dir_V];
+
+	return (nbr_tiles_h * nbr_tiles_v);
+}
+
+
+
 void	FilterResize::compute_req_src_tile_size (int &tw, int &th, int dw, int dh) const
 {
 	assert (_buffer_flag);
@@ -1349,6 +1676,18 @@ void	FilterResize::compute_req_src_tile_size (int &tw, int &th, int dw, int dh)
 			cur_dir = (cur_dir == Dir_V) ? Dir_H : Dir_V;
 			break;
 
+		case	PassType_RESIZE_H:
+			assert (cur_dir == Dir_V);
+			tw = Scaler::eval_lower_bound_of_src_tile_height (
+				tw,
+				_dst_size [Dir_H],
+				_win_size [Dir_H],
+				*(_kernel_ptr_arr [Dir_H]),
+				_kernel_scale [Dir_H],
+				_src_size [Dir_H]
+			);
+			break;
+
 		case	PassType_NONE:
 			// Nothing
 			break;
@@ -35,6 +35,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/ResizeDataFactory.h"
 #include "fmtcl/Scaler.h"
 #include "avstp.h"
+#include "AvstpStats.h"
 #include "AvstpWrapper.h"
 
 #include <vector>
@@ -69,10 +70,10 @@ public:
 
 	typedef	FilterResize	ThisType;
 
-	explicit       FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag);
+	explicit       FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag, bool fma_flag, int tile_size);
 	virtual        ~FilterResize () {}
 
-	void           process_plane (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, bool chroma_flag);
+	void           process_plane (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, bool chroma_flag, AvstpStats *stats_ptr = 0);
 
 
 
@@ -91,13 +92,25 @@ private:
 		PassType_NONE = 0,
 		PassType_RESIZE,
 		PassType_TRANSPOSE,
+		PassType_RESIZE_H,   // Horizontal resizing without transposition
 
 		PassType_NBR_ELT
 	};
 
-	static const int  MAX_NBR_PASSES = 4;                 // 2 * (transpose + resize)
-	static const int  BUF_SIZE       = 65536;             // Number of pixels (float or int16_t)
-	static const int  MAX_BUF_SIZE   = BUF_SIZE * 1024;   // Number of pixels (float or int16_t)
+	static const int  MAX_NBR_PASSES   = 4;                 // 2 * (transpose + resize)
+	static const int  BUF_SIZE         = 65536;             // Number of pixels (float or int16_t). Default when the cache size is unknown.
+	static const int  MIN_BUF_SIZE     = 4096;              // Number of pixels (float or int16_t)
+	static const int  MAX_BUF_SIZE     = BUF_SIZE * 1024;   // Number of pixels (float or int16_t)
+	static const int  TILES_PER_THREAD = 4;                 // Minimum number of tiles per thread, for the load balancing
+	static const int  TRANSP_BLK_W     = 64;                // Source columns per cache block in the SIMD transpositions. Multiple of the largest block size.
+
+	// Relative costs for the pass ordering, per pixel
+	static const int  COST_TAP         = 1;                 // One kernel tap for an output pixel
+	static const int  COST_WRITE       = 1;                 // Storing an output pixel of a resizing pass
+	static const int  COST_TRANSP      = 4;                 // Transposing a pixel (read + write with a large stride)
+	static const int  COST_MARGIN_PCT  = 5;                 // Below this difference, the cost model is not trusted
+
+	static const int  HORI_MAX_DOWNSCALE = 2;               // Above this ratio, the horizontal kernels are too far apart to be resized without transposition
 
 	class TaskRszGlobal
 	{
@@ -131,11 +144,18 @@ private:
 
 	typedef	conc::LockFreeCell <TaskRsz>	TaskRszCell;
 
+	typedef conc::ObjPool <ResizeData> ResizeDataPool;
+	typedef std::unique_ptr <ResizeDataPool> ResizeDataPoolUPtr;
+
 	void           process_plane_bypass (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, bool chroma_flag);
-	void           process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src);
+	void           process_plane_normal (uint8_t *dst_msb_ptr, uint8_t *dst_lsb_ptr, const uint8_t *src_msb_ptr, const uint8_t *src_lsb_ptr, int stride_dst, int stride_src, AvstpStats *stats_ptr);
 	void           process_tile (TaskRszCell &tr_cell);
 	void           process_tile_resize (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, int stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT]);
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	void           process_tile_resize_h (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, int stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT]);
+#endif
+
 	template <typename T, SplFmt BUFT>
 	void           process_tile_transpose (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, int stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT]);
 
@@ -148,12 +168,20 @@ private:
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	void           transpose_sse2 (float *dst_ptr, const float *src_ptr, int w, int h, int stride_dst, int stride_src);
 	void           transpose_sse2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, int stride_dst, int stride_src);
+	void           transpose_avx2 (float *dst_ptr, const float *src_ptr, int w, int h, int stride_dst, int stride_src);
+	void           transpose_avx2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, int stride_dst, int stride_src);
+	void           transpose_avx512 (float *dst_ptr, const float *src_ptr, int w, int h, int stride_dst, int stride_src);
+	void           transpose_avx512 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, int stride_dst, int stride_src);
 #endif
 
 	bool           is_kernel_neutral (Dir di) const;
 
 	inline bool    has_buf_src (int pass) const;
 	inline bool    has_buf_dst (int pass) const;
+	double         eval_roadmap_cost (bool vert_last_flag) const;
+	int            compute_buf_size (int tile_size_kb) const;
+	void           compute_tile_size (int buf_size, bool vert_last_flag);
+	int            count_tiles () const;
 	void           compute_req_src_tile_size (int &tw, int &th, int dw, int dh) const;
 
 	static void    redirect_task_resize (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr);
@@ -184,9 +212,12 @@ private:
 	bool           _int_flag;        // Use 16-bit int as temporary data instead of float, if possible
 	bool           _sse2_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;     // AVX-512F and AVX-512BW
+	bool           _fma_flag;        // Float paths only, results are not bit-exact with the non-FMA code
+	bool           _hori_flag;       // Horizontal resizing on the rows, without transposition. Requires AVX2, float only.
 
-	conc::ObjPool <ResizeData>
-						_pool;
+	std::vector <ResizeDataPoolUPtr> // One pool per NUMA node, so the buffers are allocated and reused on the node of the thread processing the tile.
+	               _pool_arr;
 	std::unique_ptr <ResizeDataFactory>
 	               _factory_uptr;
 
@@ -0,0 +1,276 @@
+/*****************************************************************************
+
+        FilterResize_avx2.cpp
+        Author: agent, 2026
+
+To be compiled with /arch:AVX in order to avoid SSE/AVX state switch
+slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/FilterResize.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+static fstb_FORCEINLINE void	FilterResize_transpose_8x8_avx2 (float *dst_ptr, const float *src_ptr, int stride_dst, int stride_src)
+{
+	const __m256   a0 = _mm256_loadu_ps (src_ptr                 );
+	const __m256   a1 = _mm256_loadu_ps (src_ptr + stride_src    );
+	const __m256   a2 = _mm256_loadu_ps (src_ptr + stride_src * 2);
+	const __m256   a3 = _mm256_loadu_ps (src_ptr + stride_src * 3);
+	const __m256   a4 = _mm256_loadu_ps (src_ptr + stride_src * 4);
+	const __m256   a5 = _mm256_loadu_ps (src_ptr + stride_src * 5);
+	const __m256   a6 = _mm256_loadu_ps (src_ptr + stride_src * 6);
+	const __m256   a7 = _mm256_loadu_ps (src_ptr + stride_src * 7);
+
+	// 4x4 transpositions within each 128-bit lane
+	const __m256   b0 = _mm256_unpacklo_ps (a0, a1);
+	const __m256   b1 = _mm256_unpackhi_ps (a0, a1);
+	const __m256   b2 = _mm256_unpacklo_ps (a2, a3);
+	const __m256   b3 = _mm256_unpackhi_ps (a2, a3);
+	const __m256   b4 = _mm256_unpacklo_ps (a4, a5);
+	const __m256   b5 = _mm256_unpackhi_ps (a4, a5);
+	const __m256   b6 = _mm256_unpacklo_ps (a6, a7);
+	const __m256   b7 = _mm256_unpackhi_ps (a6, a7);
+
+	const __m256   c0 = _mm256_shuffle_ps (b0, b2, 0x44);
+	const __m256   c1 = _mm256_shuffle_ps (b0, b2, 0xEE);
+	const __m256   c2 = _mm256_shuffle_ps (b1, b3, 0x44);
+	const __m256   c3 = _mm256_shuffle_ps (b1, b3, 0xEE);
+	const __m256   c4 = _mm256_shuffle_ps (b4, b6, 0x44);
+	const __m256   c5 = _mm256_shuffle_ps (b4, b6, 0xEE);
+	const __m256   c6 = _mm256_shuffle_ps (b5, b7, 0x44);
+	const __m256   c7 = _mm256_shuffle_ps (b5, b7, 0xEE);
+
+	// Lanes exchange
+	_mm256_storeu_ps (dst_ptr                 , _mm256_permute2f128_ps (c0, c4, 0x20));
+	_mm256_storeu_ps (dst_ptr + stride_dst    , _mm256_permute2f128_ps (c1, c5, 0x20));
+	_mm256_storeu_ps (dst_ptr + stride_dst * 2, _mm256_permute2f128_ps (c2, c6, 0x20));
+	_mm256_storeu_ps (dst_ptr + stride_dst * 3, _mm256_permute2f128_ps (c3, c7, 0x20));
+	_mm256_storeu_ps (dst_ptr + stride_dst * 4, _mm256_permute2f128_ps (c0, c4, 0x31));
+	_mm256_storeu_ps (dst_ptr + stride_dst * 5, _mm256_permute2f128_ps (c1, c5, 0x31));
+	_mm256_storeu_ps (dst_ptr + stride_dst * 6, _mm256_permute2f128_ps (c2, c6, 0x31));
+	_mm256_storeu_ps (dst_ptr + stride_dst * 7, _mm256_permute2f128_ps (c3, c7, 0x31));
+}
+
+
+
+// Transposes the 8x8 blocks of 16-bit elements held in each 128-bit lane
+// of the 8 input vectors. Same algorithm as the SSE2 code.
+static fstb_FORCEINLINE void	FilterResize_transpose_8x8x2_u16_avx2 (__m256i dst_arr [8], const __m256i src_arr [8])
+{
+	const __m256i  a03b03 = _mm256_unpacklo_epi16 (src_arr [0], src_arr [1]);
+	const __m256i  c03d03 = _mm256_unpacklo_epi16 (src_arr [2], src_arr [3]);
+	const __m256i  e03f03 = _mm256_unpacklo_epi16 (src_arr [4], src_arr [5]);
+	const __m256i  g03i03 = _mm256_unpacklo_epi16 (src_arr [6], src_arr [7]);
+	const __m256i  a47b47 = _mm256_unpackhi_epi16 (src_arr [0], src_arr [1]);
+	const __m256i  c47d47 = _mm256_unpackhi_epi16 (src_arr [2], src_arr [3]);
+	const __m256i  e47f47 = _mm256_unpackhi_epi16 (src_arr [4], src_arr [5]);
+	const __m256i  g47i47 = _mm256_unpackhi_epi16 (src_arr [6], src_arr [7]);
+
+	const __m256i  a01b01c01d01 = _mm256_unpacklo_epi32 (a03b03, c03d03);
+	const __m256i  a23b23c23d23 = _mm256_unpackhi_epi32 (a03b03, c03d03);
+	const __m256i  e01f01g01i01 = _mm256_unpacklo_epi32 (e03f03, g03i03);
+	const __m256i  e23f23g23i23 = _mm256_unpackhi_epi32 (e03f03, g03i03);
+	const __m256i  a45b45c45d45 = _mm256_unpacklo_epi32 (a47b47, c47d47);
+	const __m256i  a67b67c67d67 = _mm256_unpackhi_epi32 (a47b47, c47d47);
+	const __m256i  e45f45g45i45 = _mm256_unpacklo_epi32 (e47f47, g47i47);
+	const __m256i  e67f67g67i67 = _mm256_unpackhi_epi32 (e47f47, g47i47);
+
+	dst_arr [0] = _mm256_unpacklo_epi64 (a01b01c01d01, e01f01g01i01);
+	dst_arr [1] = _mm256_unpackhi_epi64 (a01b01c01d01, e01f01g01i01);
+	dst_arr [2] = _mm256_unpacklo_epi64 (a23b23c23d23, e23f23g23i23);
+	dst_arr [3] = _mm256_unpackhi_epi64 (a23b23c23d23, e23f23g23i23);
+	dst_arr [4] = _mm256_unpacklo_epi64 (a45b45c45d45, e45f45g45i45);
+	dst_arr [5] = _mm256_unpackhi_epi64 (a45b45c45d45, e45f45g45i45);
+	dst_arr [6] = _mm256_unpacklo_epi64 (a67b67c67d67, e67f67g67i67);
+	dst_arr [7] = _mm256_unpackhi_epi64 (a67b67c67d67, e67f67g67i67);
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_transpose_16x16_avx2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int stride_dst, int stride_src)
+{
+	__m256i        a_arr [8];
+	__m256i        b_arr [8];
+	__m256i        ta_arr [8];
+	__m256i        tb_arr [8];
+
+	for (int k = 0; k < 8; ++k)
+	{
+		a_arr [k] = _mm256_loadu_si256 (reinterpret_cast <const __m256i *> (
+			src_ptr + stride_src *  k
+		));
+		b_arr [k] = _mm256_loadu_si256 (reinterpret_cast <const __m256i *> (
+			src_ptr + stride_src * (k + 8)
+		));
+	}
+
+	FilterResize_transpose_8x8x2_u16_avx2 (ta_arr, a_arr);
+	FilterResize_transpose_8x8x2_u16_avx2 (tb_arr, b_arr);
+
+	// Lanes exchange
+	for (int k = 0; k < 8; ++k)
+	{
+		_mm256_storeu_si256 (
+			reinterpret_cast <__m256i *> (dst_ptr + stride_dst *  k     ),
+			_mm256_permute2x128_si256 (ta_arr [k], tb_arr [k], 0x20)
+		);
+		_mm256_storeu_si256 (
+			reinterpret_cast <__m256i *> (dst_ptr + stride_dst * (k + 8)),
+			_mm256_permute2x128_si256 (ta_arr [k], tb_arr [k], 0x31)
+		);
+	}
+}
+
+
+
+// The source is processed in vertical strips of TRANSP_BLK_W columns so
+// the destination lines being filled stay in the L1 cache.
+void	FilterResize::transpose_avx2 (float *dst_ptr, const float *src_ptr, int w, int h, int stride_dst, int stride_src)
+{
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != 0);
+	assert (stride_dst > 0);
+
+	static_assert (TRANSP_BLK_W % 8 == 0, "TRANSP_BLK_W must be a multiple of 8");
+
+	const int      w8 = w & -8;
+	const int      h8 = h & -8;
+
+	for (int x_blk = 0; x_blk < w8; x_blk += TRANSP_BLK_W)
+	{
+		const int      x_end = std::min (x_blk + int (TRANSP_BLK_W), w8);
+
+		for (int y = 0; y < h8; y += 8)
+		{
+			const float *  src_2_ptr = src_ptr + y * stride_src;
+
+			for (int x = x_blk; x < x_end; x += 8)
+			{
+				FilterResize_transpose_8x8_avx2 (
+					dst_ptr + x * stride_dst + y, src_2_ptr + x,
+					stride_dst, stride_src
+				);
+			}
+		}
+	}
+
+	if (w8 < w)
+	{
+		transpose_sse2 (
+			dst_ptr + w8 * stride_dst, src_ptr + w8,
+			w - w8, h, stride_dst, stride_src
+		);
+	}
+	if (w8 > 0 && h8 < h)
+	{
+		transpose_sse2 (
+			dst_ptr + h8, src_ptr + h8 * stride_src,
+			w8, h - h8, stride_dst, stride_src
+		);
+	}
+}
+
+
+
+void	FilterResize::transpose_avx2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, int stride_dst, int stride_src)
+{
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != 0);
+	assert (stride_dst > 0);
+
+	static_assert (TRANSP_BLK_W % 16 == 0, "TRANSP_BLK_W must be a multiple of 16");
+
+	const int      w16 = w & -16;
+	const int      h16 = h & -16;
+
+	for (int x_blk = 0; x_blk < w16; x_blk += TRANSP_BLK_W)
+	{
+		const int      x_end = std::min (x_blk + int (TRANSP_BLK_W), w16);
+
+		for (int y = 0; y < h16; y += 16)
+		{
+			const uint16_t *  src_2_ptr = src_ptr + y * stride_src;
+
+			for (int x = x_blk; x < x_end; x += 16)
+			{
+				FilterResize_transpose_16x16_avx2 (
+					dst_ptr + x * stride_dst + y, src_2_ptr + x,
+					stride_dst, stride_src
+				);
+			}
+		}
+	}
+
+	if (w16 < w)
+	{
+		transpose_sse2 (
+			dst_ptr + w16 * stride_dst, src_ptr + w16,
+			w - w16, h, stride_dst, stride_src
+		);
+	}
+	if (w16 > 0 && h16 < h)
+	{
+		transpose_sse2 (
+			dst_ptr + h16, src_ptr + h16 * stride_src,
+			w16, h - h16, stride_dst, stride_src
+		);
+	}
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,301 @@
+/*****************************************************************************
+
+        FilterResize_avx512.cpp
+        Author: agent, 2026
+
+To be compiled with AVX-512F and AVX-512BW enabled.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/FilterResize.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// 4x4 transposition of the 128-bit lanes of the 4 vectors
+static fstb_FORCEINLINE void	FilterResize_transpose_lanes_avx512 (__m512 &v0, __m512 &v1, __m512 &v2, __m512 &v3)
+{
+	const __m512   x0 = _mm512_shuffle_f32x4 (v0, v1, 0x44);
+	const __m512   x1 = _mm512_shuffle_f32x4 (v0, v1, 0xEE);
+	const __m512   x2 = _mm512_shuffle_f32x4 (v2, v3, 0x44);
+	const __m512   x3 = _mm512_shuffle_f32x4 (v2, v3, 0xEE);
+
+	v0 = _mm512_shuffle_f32x4 (x0, x2, 0x88);
+	v1 = _mm512_shuffle_f32x4 (x0, x2, 0xDD);
+	v2 = _mm512_shuffle_f32x4 (x1, x3, 0x88);
+	v3 = _mm512_shuffle_f32x4 (x1, x3, 0xDD);
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_transpose_lanes_avx512 (__m512i &v0, __m512i &v1, __m512i &v2, __m512i &v3)
+{
+	const __m512i  x0 = _mm512_shuffle_i32x4 (v0, v1, 0x44);
+	const __m512i  x1 = _mm512_shuffle_i32x4 (v0, v1, 0xEE);
+	const __m512i  x2 = _mm512_shuffle_i32x4 (v2, v3, 0x44);
+	const __m512i  x3 = _mm512_shuffle_i32x4 (v2, v3, 0xEE);
+
+	v0 = _mm512_shuffle_i32x4 (x0, x2, 0x88);
+	v1 = _mm512_shuffle_i32x4 (x0, x2, 0xDD);
+	v2 = _mm512_shuffle_i32x4 (x1, x3, 0x88);
+	v3 = _mm512_shuffle_i32x4 (x1, x3, 0xDD);
+}
+
+
+
+// Transposes the 4x4 blocks held in each 128-bit lane of the 4 vectors
+static fstb_FORCEINLINE void	FilterResize_transpose_4x4x4_avx512 (__m512 dst_arr [4], const __m512 src_arr [4])
+{
+	const __m512   b0 = _mm512_unpacklo_ps (src_arr [0], src_arr [1]);
+	const __m512   b1 = _mm512_unpackhi_ps (src_arr [0], src_arr [1]);
+	const __m512   b2 = _mm512_unpacklo_ps (src_arr [2], src_arr [3]);
+	const __m512   b3 = _mm512_unpackhi_ps (src_arr [2], src_arr [3]);
+
+	dst_arr [0] = _mm512_shuffle_ps (b0, b2, 0x44);
+	dst_arr [1] = _mm512_shuffle_ps (b0, b2, 0xEE);
+	dst_arr [2] = _mm512_shuffle_ps (b1, b3, 0x44);
+	dst_arr [3] = _mm512_shuffle_ps (b1, b3, 0xEE);
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_transpose_16x16_avx512 (float *dst_ptr, const float *src_ptr, int stride_dst, int stride_src)
+{
+	__m512         a_arr [4] [4];
+	__m512         t_arr [4] [4];
+
+	for (int g = 0; g < 4; ++g)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			a_arr [g] [k] = _mm512_loadu_ps (src_ptr + stride_src * (g * 4 + k));
+		}
+		FilterResize_transpose_4x4x4_avx512 (t_arr [g], a_arr [g]);
+	}
+
+	// Column 4 * j + k is now in the lane j of t_arr [0...3] [k]
+	for (int k = 0; k < 4; ++k)
+	{
+		FilterResize_transpose_lanes_avx512 (
+			t_arr [0] [k], t_arr [1] [k], t_arr [2] [k], t_arr [3] [k]
+		);
+		for (int j = 0; j < 4; ++j)
+		{
+			_mm512_storeu_ps (dst_ptr + stride_dst * (j * 4 + k), t_arr [j] [k]);
+		}
+	}
+}
+
+
+
+// Transposes the 8x8 blocks of 16-bit elements held in each 128-bit lane
+// of the 8 vectors. Same algorithm as the SSE2 code.
+static fstb_FORCEINLINE void	FilterResize_transpose_8x8x4_u16_avx512 (__m512i dst_arr [8], const __m512i src_arr [8])
+{
+	const __m512i  a03b03 = _mm512_unpacklo_epi16 (src_arr [0], src_arr [1]);
+	const __m512i  c03d03 = _mm512_unpacklo_epi16 (src_arr [2], src_arr [3]);
+	const __m512i  e03f03 = _mm512_unpacklo_epi16 (src_arr [4], src_arr [5]);
+	const __m512i  g03i03 = _mm512_unpacklo_epi16 (src_arr [6], src_arr [7]);
+	const __m512i  a47b47 = _mm512_unpackhi_epi16 (src_arr [0], src_arr [1]);
+	const __m512i  c47d47 = _mm512_unpackhi_epi16 (src_arr [2], src_arr [3]);
+	const __m512i  e47f47 = _mm512_unpackhi_epi16 (src_arr [4], src_arr [5]);
+	const __m512i  g47i47 = _mm512_unpackhi_epi16 (src_arr [6], src_arr [7]);
+
+	const __m512i  a01b01c01d01 = _mm512_unpacklo_epi32 (a03b03, c03d03);
+	const __m512i  a23b23c23d23 = _mm512_unpackhi_epi32 (a03b03, c03d03);
+	const __m512i  e01f01g01i01 = _mm512_unpacklo_epi32 (e03f03, g03i03);
+	const __m512i  e23f23g23i23 = _mm512_unpackhi_epi32 (e03f03, g03i03);
+	const __m512i  a45b45c45d45 = _mm512_unpacklo_epi32 (a47b47, c47d47);
+	const __m512i  a67b67c67d67 = _mm512_unpackhi_epi32 (a47b47, c47d47);
+	const __m512i  e45f45g45i45 = _mm512_unpacklo_epi32 (e47f47, g47i47);
+	const __m512i  e67f67g67i67 = _mm512_unpackhi_epi32 (e47f47, g47i47);
+
+	dst_arr [0] = _mm512_unpacklo_epi64 (a01b01c01d01, e01f01g01i01);
+	dst_arr [1] = _mm512_unpackhi_epi64 (a01b01c01d01, e01f01g01i01);
+	dst_arr [2] = _mm512_unpacklo_epi64 (a23b23c23d23, e23f23g23i23);
+	dst_arr [3] = _mm512_unpackhi_epi64 (a23b23c23d23, e23f23g23i23);
+	dst_arr [4] = _mm512_unpacklo_epi64 (a45b45c45d45, e45f45g45i45);
+	dst_arr [5] = _mm512_unpackhi_epi64 (a45b45c45d45, e45f45g45i45);
+	dst_arr [6] = _mm512_unpacklo_epi64 (a67b67c67d67, e67f67g67i67);
+	dst_arr [7] = _mm512_unpackhi_epi64 (a67b67c67d67, e67f67g67i67);
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_transpose_32x32_avx512 (uint16_t *dst_ptr, const uint16_t *src_ptr, int stride_dst, int stride_src)
+{
+	__m512i        a_arr [4] [8];
+	__m512i        t_arr [4] [8];
+
+	for (int g = 0; g < 4; ++g)
+	{
+		for (int k = 0; k < 8; ++k)
+		{
+			a_arr [g] [k] = _mm512_loadu_si512 (src_ptr + stride_src * (g * 8 + k));
+		}
+		FilterResize_transpose_8x8x4_u16_avx512 (t_arr [g], a_arr [g]);
+	}
+
+	// Column 8 * j + k is now in the lane j of t_arr [0...3] [k]
+	for (int k = 0; k < 8; ++k)
+	{
+		FilterResize_transpose_lanes_avx512 (
+			t_arr [0] [k], t_arr [1] [k], t_arr [2] [k], t_arr [3] [k]
+		);
+		for (int j = 0; j < 4; ++j)
+		{
+			_mm512_storeu_si512 (dst_ptr + stride_dst * (j * 8 + k), t_arr [j] [k]);
+		}
+	}
+}
+
+
+
+// The source is processed in vertical strips of TRANSP_BLK_W columns so
+// the destination lines being filled stay in the L1 cache.
+void	FilterResize::transpose_avx512 (float *dst_ptr, const float *src_ptr, int w, int h, int stride_dst, int stride_src)
+{
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != 0);
+	assert (stride_dst > 0);
+
+	static_assert (TRANSP_BLK_W % 16 == 0, "TRANSP_BLK_W must be a multiple of 16");
+
+	const int      w16 = w & -16;
+	const int      h16 = h & -16;
+
+	for (int x_blk = 0; x_blk < w16; x_blk += TRANSP_BLK_W)
+	{
+		const int      x_end = std::min (x_blk + int (TRANSP_BLK_W), w16);
+
+		for (int y = 0; y < h16; y += 16)
+		{
+			const float *  src_2_ptr = src_ptr + y * stride_src;
+
+			for (int x = x_blk; x < x_end; x += 16)
+			{
+				FilterResize_transpose_16x16_avx512 (
+					dst_ptr + x * stride_dst + y, src_2_ptr + x,
+					stride_dst, stride_src
+				);
+			}
+		}
+	}
+
+	if (w16 < w)
+	{
+		transpose_avx2 (
+			dst_ptr + w16 * stride_dst, src_ptr + w16,
+			w - w16, h, stride_dst, stride_src
+		);
+	}
+	if (w16 > 0 && h16 < h)
+	{
+		transpose_avx2 (
+			dst_ptr + h16, src_ptr + h16 * stride_src,
+			w16, h - h16, stride_dst, stride_src
+		);
+	}
+}
+
+
+
+void	FilterResize::transpose_avx512 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, int stride_dst, int stride_src)
+{
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != 0);
+	assert (stride_dst > 0);
+
+	static_assert (TRANSP_BLK_W % 32 == 0, "TRANSP_BLK_W must be a multiple of 32");
+
+	const int      w32 = w & -32;
+	const int      h32 = h & -32;
+
+	for (int x_blk = 0; x_blk < w32; x_blk += TRANSP_BLK_W)
+	{
+		const int      x_end = std::min (x_blk + int (TRANSP_BLK_W), w32);
+
+		for (int y = 0; y < h32; y += 32)
+		{
+			const uint16_t *  src_2_ptr = src_ptr + y * stride_src;
+
+			for (int x = x_blk; x < x_end; x += 32)
+			{
+				FilterResize_transpose_32x32_avx512 (
+					dst_ptr + x * stride_dst + y, src_2_ptr + x,
+					stride_dst, stride_src
+				);
+			}
+		}
+	}
+
+	if (w32 < w)
+	{
+		transpose_avx2 (
+			dst_ptr + w32 * stride_dst, src_ptr + w32,
+			w - w32, h, stride_dst, stride_src
+		);
+	}
+	if (w32 > 0 && h32 < h)
+	{
+		transpose_avx2 (
+			dst_ptr + h32, src_ptr + h32 * stride_src,
+			w32, h - h32, stride_dst, stride_src
+		);
+	}
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -3,9 +3,6 @@
         Matrix2020CLProc.cpp
         Author: Laurent de Soras, 2015
 
-TO DO:
-	- AVX2 optimizations
-
 --- Legal stuff ---
 
 This program is free software. It comes without any warranty, to
@@ -31,6 +28,9 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/Matrix2020CLProc.h"
 #include "fmtcl/Matrix2020CLProc_macro.h"
 #include "fmtcl/ProxyRwCpp.h"
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	#include "fmtcl/ProxyRwSse2.h"
+#endif   // fstb_ARCHI_X86
 #include "fmtcl/TransOpLinPow.h"
 #include "fstb/fnc.h"
 #if (fstb_ARCHI == fstb_ARCHI_X86)
@@ -173,6 +173,10 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_rgb_2_ycbcr ()
 			{
 				_proc_ptr = &ThisType::conv_rgb_2_ycbcr_sse2_flt;
 			}
+			if (_avx2_flag)
+			{
+				setup_rgb_2_ycbcr_avx2 ();
+			}
 
 			std::unique_ptr <TransOpInterface>  curve_uptr (new TransOpLinPow (
 				false, _alpha_b12, _beta_b12, _gam_pow, _slope_lin
@@ -213,6 +217,41 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_rgb_2_ycbcr ()
 
 #undef fmtcl_Matrix2020CLProc_CASE_INT
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		if (ret_val == Err_OK)
+		{
+			if (_sse2_flag)
+			{
+#define fmtcl_Matrix2020CLProc_CASE_INT(DF, DB, SF, SB) \
+		case   (fmtcl::SplFmt_##DF << 17) + (DB << 10) \
+		     + (fmtcl::SplFmt_##SF <<  7) + (SB      ): \
+			_proc_ptr = &ThisType::conv_rgb_2_ycbcr_sse2_int < \
+				ProxyRwSse2 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwSse2 <fmtcl::SplFmt_##SF>, SB \
+			>; \
+			break;
+
+				switch (
+					  (_dst_fmt  << 17)
+					+ (_dst_bits << 10)
+					+ (_src_fmt  <<  7)
+					+ (_src_bits      )
+				)
+				{
+				fmtcl_Matrix2020CLProc_TO_YUV_SPAN_I (fmtcl_Matrix2020CLProc_CASE_INT)
+				// No default, format combination is already checked
+				// and the C++ code fills all the possibilities.
+				}
+
+#undef fmtcl_Matrix2020CLProc_CASE_INT
+			}
+			if (_avx2_flag)
+			{
+				setup_rgb_2_ycbcr_avx2 ();
+			}
+		}
+#endif   // fstb_ARCHI_X86
+
 		// RGB -> Y
 		int            sum = 0;
 		for (int p = 0; p < NBR_PLANES - 1; ++p)
@@ -293,6 +332,10 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_ycbcr_2_rgb ()
 			{
 				_proc_ptr = &ThisType::conv_ycbcr_2_rgb_sse2_flt;
 			}
+			if (_avx2_flag)
+			{
+				setup_ycbcr_2_rgb_avx2 ();
+			}
 
 			std::unique_ptr <TransOpInterface>  curve_uptr (new TransOpLinPow (
 				true, _alpha_b12, _beta_b12, _gam_pow, _slope_lin
@@ -333,6 +376,41 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_ycbcr_2_rgb ()
 
 #undef fmtcl_Matrix2020CLProc_CASE_INT
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		if (ret_val == Err_OK)
+		{
+			if (_sse2_flag)
+			{
+#define fmtcl_Matrix2020CLProc_CASE_INT(DF, DB, SF, SB) \
+		case   (fmtcl::SplFmt_##DF << 17) + (DB << 10) \
+		     + (fmtcl::SplFmt_##SF <<  7) + (SB      ): \
+			_proc_ptr = &ThisType::conv_ycbcr_2_rgb_sse2_int < \
+				ProxyRwSse2 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwSse2 <fmtcl::SplFmt_##SF>, SB \
+			>; \
+			break;
+
+				switch (
+					  (_dst_fmt  << 17)
+					+ (_dst_bits << 10)
+					+ (_src_fmt  <<  7)
+					+ (_src_bits      )
+				)
+				{
+				fmtcl_Matrix2020CLProc_TO_RGB_SPAN_I (fmtcl_Matrix2020CLProc_CASE_INT)
+				// No default, format combination is already checked
+				// and the C++ code fills all the possibilities.
+				}
+
+#undef fmtcl_Matrix2020CLProc_CASE_INT
+			}
+			if (_avx2_flag)
+			{
+				setup_ycbcr_2_rgb_avx2 ();
+			}
+		}
+#endif   // fstb_ARCHI_X86
+
 		// YBR -> G
 		for (int p = 0; p < NBR_PLANES; ++p)
 		{
@@ -735,6 +813,211 @@ void	Matrix2020CLProc::conv_ycbcr_2_rgb_cpp_flt (uint8_t * const dst_ptr_arr [NB
 
 
 
+// Looks up the 8 unsigned 16-bit indexes in the table
+static fstb_FORCEINLINE __m128i	Matrix2020CLProc_map_sse2 (const __m128i &idx, const uint16_t lut_ptr [])
+{
+	return (_mm_set_epi16 (
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 7)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 6)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 5)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 4)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 3)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 2)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 1)]),
+		int16_t (lut_ptr [_mm_extract_epi16 (idx, 0)])
+	));
+}
+
+
+
+// DST and SRC are ProxyRwSse2 classes
+// Bit-exact with conv_rgb_2_ycbcr_cpp_int.
+// The unsigned 16-bit values are offset by -0x8000 to fit the signed
+// multiplications.
+template <class DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_rgb_2_ycbcr_sse2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (_coef_yg_a_int <= 0x7FFF);
+	assert (_coef_cb_a_int [0] <= 0x7FFF);
+	assert (_coef_cb_a_int [1] <= 0x7FFF);
+	assert (_coef_cr_a_int [0] <= 0x7FFF);
+	assert (_coef_cr_a_int [1] <= 0x7FFF);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+	typedef typename SRC::template S16 <false     , false> SrcS16R;
+	typedef typename DST::template S16 <(DB != 16), true > DstS16W;
+
+	const int      packsize  = 8;
+	const int      sizeof_st = int (sizeof (typename SRC::PtrConst::DataType));
+	assert (src_str_arr [0] % sizeof_st == 0);
+	assert (src_str_arr [1] % sizeof_st == 0);
+	assert (src_str_arr [2] % sizeof_st == 0);
+	const int      sizeof_dt = int (sizeof (typename DST::Ptr::DataType));
+	assert (dst_str_arr [0] % sizeof_dt == 0);
+	assert (dst_str_arr [1] % sizeof_dt == 0);
+	assert (dst_str_arr [2] % sizeof_dt == 0);
+
+	const int      wp = (w + (packsize - 1)) & -packsize;
+
+	SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [0], src_str_arr [0], h);
+	SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [1], src_str_arr [1], h);
+	SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [2], src_str_arr [2], h);
+	const int      src_0_str = src_str_arr [0] / sizeof_st - wp;
+	const int      src_1_str = src_str_arr [1] / sizeof_st - wp;
+	const int      src_2_str = src_str_arr [2] / sizeof_st - wp;
+
+	DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst_ptr_arr [0], dst_str_arr [0], h);
+	DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst_ptr_arr [1], dst_str_arr [1], h);
+	DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst_ptr_arr [2], dst_str_arr [2], h);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_dt - wp;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_dt - wp;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_dt - wp;
+
+	const int      shft2 = SHIFT_INT + RGB_INT_BITS - DB;
+	const int      cst_r = 1 << (SHIFT_INT - 1);
+	const int      sum_c =
+		_coef_rgby_int [Col_R] + _coef_rgby_int [Col_G] + _coef_rgby_int [Col_B];
+	const uint16_t *  map_ptr = &_map_gamma_int [0];
+
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128i  ofs_grey = _mm_set1_epi32 (0x8000);
+	const __m128i  ma       = _mm_set1_epi16 (int16_t ((1 << DB) - 1 - 0x8000));
+
+	// R, G and B coefficients paired for pmaddwd. The offset keeps the
+	// linear Y in the signed 16-bit range.
+	const __m128i  c_rg   = _mm_unpacklo_epi16 (
+		_mm_set1_epi16 (_coef_rgby_int [Col_R]),
+		_mm_set1_epi16 (_coef_rgby_int [Col_G])
+	);
+	const __m128i  c_b0   = _mm_unpacklo_epi16 (
+		_mm_set1_epi16 (_coef_rgby_int [Col_B]),
+		zero
+	);
+	const __m128i  k_yl   = _mm_set1_epi32 (
+		cst_r + 0x8000 * (sum_c - (1 << SHIFT_INT))
+	);
+
+	const __m128i  c_dy   = _mm_set1_epi16 (int16_t (_coef_yg_a_int));
+	const __m128i  k_dy   = _mm_set1_epi32 (_coef_yg_b_int + 0x8000 * _coef_yg_a_int);
+	const __m128i  c_cb_p = _mm_set1_epi16 (int16_t (_coef_cb_a_int [0]));
+	const __m128i  c_cb_n = _mm_set1_epi16 (int16_t (_coef_cb_a_int [1]));
+	const __m128i  c_cr_p = _mm_set1_epi16 (int16_t (_coef_cr_a_int [0]));
+	const __m128i  c_cr_n = _mm_set1_epi16 (int16_t (_coef_cr_a_int [1]));
+	const __m128i  k_c    = _mm_set1_epi32 (_coef_cbcr_b_int);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; x += packsize)
+		{
+			const __m128i  rl  = SrcS16R::read (src_0_ptr, zero, sign_bit);
+			const __m128i  gl  = SrcS16R::read (src_1_ptr, zero, sign_bit);
+			const __m128i  bl  = SrcS16R::read (src_2_ptr, zero, sign_bit);
+			const __m128i  rls = _mm_xor_si128 (rl, sign_bit);
+			const __m128i  gls = _mm_xor_si128 (gl, sign_bit);
+			const __m128i  bls = _mm_xor_si128 (bl, sign_bit);
+
+			__m128i        yl0 = _mm_add_epi32 (
+				_mm_madd_epi16 (_mm_unpacklo_epi16 (rls, gls), c_rg),
+				_mm_madd_epi16 (_mm_unpacklo_epi16 (bls, zero), c_b0)
+			);
+			__m128i        yl1 = _mm_add_epi32 (
+				_mm_madd_epi16 (_mm_unpackhi_epi16 (rls, gls), c_rg),
+				_mm_madd_epi16 (_mm_unpackhi_epi16 (bls, zero), c_b0)
+			);
+			yl0 = _mm_srai_epi32 (_mm_add_epi32 (yl0, k_yl), SHIFT_INT);
+			yl1 = _mm_srai_epi32 (_mm_add_epi32 (yl1, k_yl), SHIFT_INT);
+			const __m128i  yl  =
+				_mm_xor_si128 (_mm_packs_epi32 (yl0, yl1), sign_bit);
+
+			const __m128i  ygs = _mm_xor_si128 (
+				Matrix2020CLProc_map_sse2 (yl, map_ptr), sign_bit
+			);
+			const __m128i  bgs = _mm_xor_si128 (
+				Matrix2020CLProc_map_sse2 (bl, map_ptr), sign_bit
+			);
+			const __m128i  rgs = _mm_xor_si128 (
+				Matrix2020CLProc_map_sse2 (rl, map_ptr), sign_bit
+			);
+
+			// Y'
+			__m128i        dy0 = k_dy;
+			__m128i        dy1 = k_dy;
+			fstb::ToolsSse2::mac_s16_s16_s32 (dy0, dy1, ygs, c_dy);
+			dy0 = _mm_sub_epi32 (_mm_srai_epi32 (dy0, shft2), ofs_grey);
+			dy1 = _mm_sub_epi32 (_mm_srai_epi32 (dy1, shft2), ofs_grey);
+
+			// Cb and Cr. The differences don't fit in 16 bits, so they are
+			// computed within pmaddwd with (c, -c) coefficient pairs.
+			const __m128i  c_cb  = fstb::ToolsSse2::select (
+				_mm_cmplt_epi16 (bgs, ygs), c_cb_n, c_cb_p
+			);
+			const __m128i  c_cr  = fstb::ToolsSse2::select (
+				_mm_cmplt_epi16 (rgs, ygs), c_cr_n, c_cr_p
+			);
+			const __m128i  c_cbm = _mm_sub_epi16 (zero, c_cb);
+			const __m128i  c_crm = _mm_sub_epi16 (zero, c_cr);
+			__m128i        dcb0  = _mm_madd_epi16 (
+				_mm_unpacklo_epi16 (bgs, ygs), _mm_unpacklo_epi16 (c_cb, c_cbm)
+			);
+			__m128i        dcb1  = _mm_madd_epi16 (
+				_mm_unpackhi_epi16 (bgs, ygs), _mm_unpackhi_epi16 (c_cb, c_cbm)
+			);
+			__m128i        dcr0  = _mm_madd_epi16 (
+				_mm_unpacklo_epi16 (rgs, ygs), _mm_unpacklo_epi16 (c_cr, c_crm)
+			);
+			__m128i        dcr1  = _mm_madd_epi16 (
+				_mm_unpackhi_epi16 (rgs, ygs), _mm_unpackhi_epi16 (c_cr, c_crm)
+			);
+			dcb0 = _mm_srai_epi32 (_mm_add_epi32 (dcb0, k_c), shft2);
+			dcb1 = _mm_srai_epi32 (_mm_add_epi32 (dcb1, k_c), shft2);
+			dcr0 = _mm_srai_epi32 (_mm_add_epi32 (dcr0, k_c), shft2);
+			dcr1 = _mm_srai_epi32 (_mm_add_epi32 (dcr1, k_c), shft2);
+			dcb0 = _mm_sub_epi32 (dcb0, ofs_grey);
+			dcb1 = _mm_sub_epi32 (dcb1, ofs_grey);
+			dcr0 = _mm_sub_epi32 (dcr0, ofs_grey);
+			dcr1 = _mm_sub_epi32 (dcr1, ofs_grey);
+
+			// Values are clipped in the signed domain, then offset back
+			const __m128i  dy  = _mm_packs_epi32 (dy0 , dy1 );
+			const __m128i  dcb = _mm_packs_epi32 (dcb0, dcb1);
+			const __m128i  dcr = _mm_packs_epi32 (dcr0, dcr1);
+
+			DstS16W::write_clip (dst_0_ptr, dy , mask_lsb, sign_bit, ma, sign_bit);
+			DstS16W::write_clip (dst_1_ptr, dcb, mask_lsb, sign_bit, ma, sign_bit);
+			DstS16W::write_clip (dst_2_ptr, dcr, mask_lsb, sign_bit, ma, sign_bit);
+
+			SRC::PtrConst::jump (src_0_ptr, packsize);
+			SRC::PtrConst::jump (src_1_ptr, packsize);
+			SRC::PtrConst::jump (src_2_ptr, packsize);
+
+			DST::Ptr::jump (dst_0_ptr, packsize);
+			DST::Ptr::jump (dst_1_ptr, packsize);
+			DST::Ptr::jump (dst_2_ptr, packsize);
+		}
+
+		SRC::PtrConst::jump (src_0_ptr, src_0_str);
+		SRC::PtrConst::jump (src_1_ptr, src_1_str);
+		SRC::PtrConst::jump (src_2_ptr, src_2_str);
+
+		DST::Ptr::jump (dst_0_ptr, dst_0_str);
+		DST::Ptr::jump (dst_1_ptr, dst_1_str);
+		DST::Ptr::jump (dst_2_ptr, dst_2_str);
+	}
+}
+
+
+
 void	Matrix2020CLProc::conv_rgb_2_ycbcr_sse2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
 {
 	assert (_lut_uptr.get () != 0);
@@ -861,6 +1144,183 @@ void	Matrix2020CLProc::conv_rgb_2_ycbcr_sse2_flt (uint8_t * const dst_ptr_arr [N
 
 
 
+// DST and SRC are ProxyRwSse2 classes
+// Bit-exact with conv_ycbcr_2_rgb_cpp_int.
+template <class DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_ycbcr_2_rgb_sse2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (_coef_yg_a_int <= 0x7FFF);
+	assert (_coef_cb_a_int [0] <= 0x7FFF);
+	assert (_coef_cb_a_int [1] <= 0x7FFF);
+	assert (_coef_cr_a_int [0] <= 0x7FFF);
+	assert (_coef_cr_a_int [1] <= 0x7FFF);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+	static_assert (DB == 16, "Output must be 16 bits");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+	typedef typename SRC::template S16 <false, false> SrcS16R;
+	typedef typename DST::template S16 <false, false> DstS16W;
+
+	const int      packsize  = 8;
+	const int      sizeof_st = int (sizeof (typename SRC::PtrConst::DataType));
+	assert (src_str_arr [0] % sizeof_st == 0);
+	assert (src_str_arr [1] % sizeof_st == 0);
+	assert (src_str_arr [2] % sizeof_st == 0);
+	const int      sizeof_dt = int (sizeof (typename DST::Ptr::DataType));
+	assert (dst_str_arr [0] % sizeof_dt == 0);
+	assert (dst_str_arr [1] % sizeof_dt == 0);
+	assert (dst_str_arr [2] % sizeof_dt == 0);
+
+	const int      wp = (w + (packsize - 1)) & -packsize;
+
+	SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [0], src_str_arr [0], h);
+	SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [1], src_str_arr [1], h);
+	SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [2], src_str_arr [2], h);
+	const int      src_0_str = src_str_arr [0] / sizeof_st - wp;
+	const int      src_1_str = src_str_arr [1] / sizeof_st - wp;
+	const int      src_2_str = src_str_arr [2] / sizeof_st - wp;
+
+	DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst_ptr_arr [0], dst_str_arr [0], h);
+	DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst_ptr_arr [1], dst_str_arr [1], h);
+	DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst_ptr_arr [2], dst_str_arr [2], h);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_dt - wp;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_dt - wp;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_dt - wp;
+
+	const int      shft2     = SHIFT_INT + SB - RGB_INT_BITS;
+	const int      cst_r     = 1 << (SHIFT_INT - 1);
+	const int      ofs_grey  = 1 << (SB - 1);
+	const int      sum_c     =
+		_coef_rgby_int [Col_R] + _coef_rgby_int [Col_G] + _coef_rgby_int [Col_B];
+	const uint16_t *  map_ptr = &_map_gamma_int [0];
+
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128i  ofs_u16  = _mm_set1_epi32 (0x8000);
+	const __m128i  grey     = _mm_set1_epi16 (int16_t (ofs_grey));
+
+	const __m128i  c_dy   = _mm_set1_epi16 (int16_t (_coef_yg_a_int));
+	const __m128i  k_dy   = _mm_set1_epi32 (_coef_yg_b_int + 0x8000 * _coef_yg_a_int);
+	const __m128i  c_cb_p = _mm_set1_epi16 (int16_t (_coef_cb_a_int [0]));
+	const __m128i  c_cb_n = _mm_set1_epi16 (int16_t (_coef_cb_a_int [1]));
+	const __m128i  c_cr_p = _mm_set1_epi16 (int16_t (_coef_cr_a_int [0]));
+	const __m128i  c_cr_n = _mm_set1_epi16 (int16_t (_coef_cr_a_int [1]));
+	const __m128i  k_c    = _mm_set1_epi32 (_coef_cbcr_b_int);
+
+	// R, Y and B coefficients paired for pmaddwd
+	const __m128i  c_ry   = _mm_unpacklo_epi16 (
+		_mm_set1_epi16 (_coef_rgby_int [Col_R]),
+		_mm_set1_epi16 (_coef_rgby_int [Col_G])
+	);
+	const __m128i  c_b0   = _mm_unpacklo_epi16 (
+		_mm_set1_epi16 (_coef_rgby_int [Col_B]),
+		zero
+	);
+	const __m128i  k_gl   = _mm_set1_epi32 (cst_r + 0x8000 * sum_c);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; x += packsize)
+		{
+			const __m128i  dy   = SrcS16R::read (src_0_ptr, zero, sign_bit);
+			const __m128i  dcb  = SrcS16R::read (src_1_ptr, zero, sign_bit);
+			const __m128i  dcr  = SrcS16R::read (src_2_ptr, zero, sign_bit);
+			const __m128i  dys  = _mm_xor_si128 (dy, sign_bit);
+			const __m128i  dcb0 = _mm_sub_epi16 (dcb, grey);
+			const __m128i  dcr0 = _mm_sub_epi16 (dcr, grey);
+
+			// Y' is offset by -0x8000 so the sums can be clipped
+			// with a signed saturation.
+			__m128i        yg0 = k_dy;
+			__m128i        yg1 = k_dy;
+			fstb::ToolsSse2::mac_s16_s16_s32 (yg0, yg1, dys, c_dy);
+			yg0 = _mm_sub_epi32 (_mm_srai_epi32 (yg0, shft2), ofs_u16);
+			yg1 = _mm_sub_epi32 (_mm_srai_epi32 (yg1, shft2), ofs_u16);
+
+			const __m128i  c_cb = fstb::ToolsSse2::select (
+				_mm_cmplt_epi16 (dcb0, zero), c_cb_n, c_cb_p
+			);
+			const __m128i  c_cr = fstb::ToolsSse2::select (
+				_mm_cmplt_epi16 (dcr0, zero), c_cr_n, c_cr_p
+			);
+			__m128i        cb0 = k_c;
+			__m128i        cb1 = k_c;
+			__m128i        cr0 = k_c;
+			__m128i        cr1 = k_c;
+			fstb::ToolsSse2::mac_s16_s16_s32 (cb0, cb1, dcb0, c_cb);
+			fstb::ToolsSse2::mac_s16_s16_s32 (cr0, cr1, dcr0, c_cr);
+			cb0 = _mm_srai_epi32 (cb0, shft2);
+			cb1 = _mm_srai_epi32 (cb1, shft2);
+			cr0 = _mm_srai_epi32 (cr0, shft2);
+			cr1 = _mm_srai_epi32 (cr1, shft2);
+
+			const __m128i  yg = _mm_xor_si128 (
+				_mm_packs_epi32 (yg0, yg1), sign_bit
+			);
+			const __m128i  bg = _mm_xor_si128 (_mm_packs_epi32 (
+				_mm_add_epi32 (cb0, yg0), _mm_add_epi32 (cb1, yg1)
+			), sign_bit);
+			const __m128i  rg = _mm_xor_si128 (_mm_packs_epi32 (
+				_mm_add_epi32 (cr0, yg0), _mm_add_epi32 (cr1, yg1)
+			), sign_bit);
+
+			const __m128i  yl  = Matrix2020CLProc_map_sse2 (yg, map_ptr);
+			const __m128i  bl  = Matrix2020CLProc_map_sse2 (bg, map_ptr);
+			const __m128i  rl  = Matrix2020CLProc_map_sse2 (rg, map_ptr);
+			const __m128i  yls = _mm_xor_si128 (yl, sign_bit);
+			const __m128i  bls = _mm_xor_si128 (bl, sign_bit);
+			const __m128i  rls = _mm_xor_si128 (rl, sign_bit);
+
+			__m128i        gl0 = _mm_add_epi32 (
+				_mm_madd_epi16 (_mm_unpacklo_epi16 (rls, yls), c_ry),
+				_mm_madd_epi16 (_mm_unpacklo_epi16 (bls, zero), c_b0)
+			);
+			__m128i        gl1 = _mm_add_epi32 (
+				_mm_madd_epi16 (_mm_unpackhi_epi16 (rls, yls), c_ry),
+				_mm_madd_epi16 (_mm_unpackhi_epi16 (bls, zero), c_b0)
+			);
+			gl0 = _mm_srai_epi32 (_mm_add_epi32 (gl0, k_gl), SHIFT_INT);
+			gl1 = _mm_srai_epi32 (_mm_add_epi32 (gl1, k_gl), SHIFT_INT);
+
+			// Wraps around like the reference code
+			gl0 = _mm_srai_epi32 (_mm_slli_epi32 (gl0, 16), 16);
+			gl1 = _mm_srai_epi32 (_mm_slli_epi32 (gl1, 16), 16);
+			const __m128i  gl  = _mm_packs_epi32 (gl0, gl1);
+
+			DstS16W::write_clip (dst_0_ptr, rl, mask_lsb, zero, zero, sign_bit);
+			DstS16W::write_clip (dst_1_ptr, gl, mask_lsb, zero, zero, sign_bit);
+			DstS16W::write_clip (dst_2_ptr, bl, mask_lsb, zero, zero, sign_bit);
+
+			SRC::PtrConst::jump (src_0_ptr, packsize);
+			SRC::PtrConst::jump (src_1_ptr, packsize);
+			SRC::PtrConst::jump (src_2_ptr, packsize);
+
+			DST::Ptr::jump (dst_0_ptr, packsize);
+			DST::Ptr::jump (dst_1_ptr, packsize);
+			DST::Ptr::jump (dst_2_ptr, packsize);
+		}
+
+		SRC::PtrConst::jump (src_0_ptr, src_0_str);
+		SRC::PtrConst::jump (src_1_ptr, src_1_str);
+		SRC::PtrConst::jump (src_2_ptr, src_2_str);
+
+		DST::Ptr::jump (dst_0_ptr, dst_0_str);
+		DST::Ptr::jump (dst_1_ptr, dst_1_str);
+		DST::Ptr::jump (dst_2_ptr, dst_2_str);
+	}
+}
+
+
+
 void	Matrix2020CLProc::conv_ycbcr_2_rgb_sse2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
 {
 	assert (_lut_uptr.get () != 0);
@@ -114,8 +114,22 @@ private:
 	void           conv_ycbcr_2_rgb_cpp_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
+	template <class DST, int DB, class SRC, int SB>
+	void           conv_rgb_2_ycbcr_sse2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
 	void           conv_rgb_2_ycbcr_sse2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	template <class DST, int DB, class SRC, int SB>
+	void           conv_ycbcr_2_rgb_sse2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
 	void           conv_ycbcr_2_rgb_sse2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+
+	void           setup_rgb_2_ycbcr_avx2 ();
+	void           setup_ycbcr_2_rgb_avx2 ();
+
+	template <class DST, int DB, class SRC, int SB>
+	void           conv_rgb_2_ycbcr_avx2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	void           conv_rgb_2_ycbcr_avx2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	template <class DST, int DB, class SRC, int SB>
+	void           conv_ycbcr_2_rgb_avx2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	void           conv_ycbcr_2_rgb_avx2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
 #endif   // fstb_ARCHI_X86
 
 	template <typename T>
@@ -140,8 +154,8 @@ private:
 
 	std::array <int16_t, NBR_PLANES>
 	               _coef_rgby_int;
-	std::array <uint16_t, 1 << RGB_INT_BITS>
-	               _map_gamma_int;
+	std::array <uint16_t, (1 << RGB_INT_BITS) + 1>
+	               _map_gamma_int;  // The last entry is padding for the 32-bit AVX2 gathers
 	uint16_t       _coef_yg_a_int;
 	int32_t        _coef_yg_b_int;
 	std::array <uint16_t, 2>
@@ -0,0 +1,776 @@
+/*****************************************************************************
+
+        Matrix2020CLProc_avx2.cpp
+        Author: agent, 2026
+
+To be compiled with /arch:AVX in order to avoid SSE/AVX state switch
+slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Matrix2020CLProc.h"
+#include "fmtcl/Matrix2020CLProc_macro.h"
+#include "fmtcl/ProxyRwAvx2.h"
+#include "fstb/ToolsAvx2.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	Matrix2020CLProc::setup_rgb_2_ycbcr_avx2 ()
+{
+	if (_flt_flag)
+	{
+		_proc_ptr = &ThisType::conv_rgb_2_ycbcr_avx2_flt;
+	}
+
+	else
+	{
+#define fmtcl_Matrix2020CLProc_CASE_INT(DF, DB, SF, SB) \
+		case   (fmtcl::SplFmt_##DF << 17) + (DB << 10) \
+		     + (fmtcl::SplFmt_##SF <<  7) + (SB      ): \
+			_proc_ptr = &ThisType::conv_rgb_2_ycbcr_avx2_int < \
+				ProxyRwAvx2 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwAvx2 <fmtcl::SplFmt_##SF>, SB \
+			>; \
+			break;
+
+		switch (
+			  (_dst_fmt  << 17)
+			+ (_dst_bits << 10)
+			+ (_src_fmt  <<  7)
+			+ (_src_bits      )
+		)
+		{
+		fmtcl_Matrix2020CLProc_TO_YUV_SPAN_I (fmtcl_Matrix2020CLProc_CASE_INT)
+		// No default, format combination is already checked
+		// and the C++ code fills all the possibilities.
+		}
+
+#undef fmtcl_Matrix2020CLProc_CASE_INT
+	}
+}
+
+
+
+void	Matrix2020CLProc::setup_ycbcr_2_rgb_avx2 ()
+{
+	if (_flt_flag)
+	{
+		_proc_ptr = &ThisType::conv_ycbcr_2_rgb_avx2_flt;
+	}
+
+	else
+	{
+#define fmtcl_Matrix2020CLProc_CASE_INT(DF, DB, SF, SB) \
+		case   (fmtcl::SplFmt_##DF << 17) + (DB << 10) \
+		     + (fmtcl::SplFmt_##SF <<  7) + (SB      ): \
+			_proc_ptr = &ThisType::conv_ycbcr_2_rgb_avx2_int < \
+				ProxyRwAvx2 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwAvx2 <fmtcl::SplFmt_##SF>, SB \
+			>; \
+			break;
+
+		switch (
+			  (_dst_fmt  << 17)
+			+ (_dst_bits << 10)
+			+ (_src_fmt  <<  7)
+			+ (_src_bits      )
+		)
+		{
+		fmtcl_Matrix2020CLProc_TO_RGB_SPAN_I (fmtcl_Matrix2020CLProc_CASE_INT)
+		// No default, format combination is already checked
+		// and the C++ code fills all the possibilities.
+		}
+
+#undef fmtcl_Matrix2020CLProc_CASE_INT
+	}
+}
+
+
+
+// Looks up the 16 unsigned 16-bit indexes in the table.
+// The gathers read 32 bits per index, so the table must have an extra
+// entry at the end.
+static fstb_FORCEINLINE __m256i	Matrix2020CLProc_map_avx2 (const __m256i &idx, const uint16_t lut_ptr [])
+{
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  mask_u16 = _mm256_set1_epi32 (0xFFFF);
+	const int *    base_ptr = reinterpret_cast <const int *> (lut_ptr);
+
+	__m256i        val0 = _mm256_i32gather_epi32 (
+		base_ptr, _mm256_unpacklo_epi16 (idx, zero), 2
+	);
+	__m256i        val1 = _mm256_i32gather_epi32 (
+		base_ptr, _mm256_unpackhi_epi16 (idx, zero), 2
+	);
+	val0 = _mm256_and_si256 (val0, mask_u16);
+	val1 = _mm256_and_si256 (val1, mask_u16);
+
+	return (_mm256_packus_epi32 (val0, val1));
+}
+
+
+
+// DST and SRC are ProxyRwAvx2 classes
+// Bit-exact with conv_rgb_2_ycbcr_cpp_int.
+// The unsigned 16-bit values are offset by -0x8000 to fit the signed
+// multiplications.
+template <class DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_rgb_2_ycbcr_avx2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (_coef_yg_a_int <= 0x7FFF);
+	assert (_coef_cb_a_int [0] <= 0x7FFF);
+	assert (_coef_cb_a_int [1] <= 0x7FFF);
+	assert (_coef_cr_a_int [0] <= 0x7FFF);
+	assert (_coef_cr_a_int [1] <= 0x7FFF);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+	typedef typename SRC::template S16 <false     , false> SrcS16R;
+	typedef typename DST::template S16 <(DB != 16), true > DstS16W;
+
+	const int      packsize  = 16;
+	const int      sizeof_st = int (sizeof (typename SRC::PtrConst::DataType));
+	assert (src_str_arr [0] % sizeof_st == 0);
+	assert (src_str_arr [1] % sizeof_st == 0);
+	assert (src_str_arr [2] % sizeof_st == 0);
+	const int      sizeof_dt = int (sizeof (typename DST::Ptr::DataType));
+	assert (dst_str_arr [0] % sizeof_dt == 0);
+	assert (dst_str_arr [1] % sizeof_dt == 0);
+	assert (dst_str_arr [2] % sizeof_dt == 0);
+
+	const int      wp = (w + (packsize - 1)) & -packsize;
+
+	SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [0], src_str_arr [0], h);
+	SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [1], src_str_arr [1], h);
+	SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [2], src_str_arr [2], h);
+	const int      src_0_str = src_str_arr [0] / sizeof_st - wp;
+	const int      src_1_str = src_str_arr [1] / sizeof_st - wp;
+	const int      src_2_str = src_str_arr [2] / sizeof_st - wp;
+
+	DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst_ptr_arr [0], dst_str_arr [0], h);
+	DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst_ptr_arr [1], dst_str_arr [1], h);
+	DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst_ptr_arr [2], dst_str_arr [2], h);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_dt - wp;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_dt - wp;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_dt - wp;
+
+	const int      shft2 = SHIFT_INT + RGB_INT_BITS - DB;
+	const int      cst_r = 1 << (SHIFT_INT - 1);
+	const int      sum_c =
+		_coef_rgby_int [Col_R] + _coef_rgby_int [Col_G] + _coef_rgby_int [Col_B];
+	const uint16_t *  map_ptr = &_map_gamma_int [0];
+
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256i  ofs_grey = _mm256_set1_epi32 (0x8000);
+	const __m256i  ma       = _mm256_set1_epi16 (int16_t ((1 << DB) - 1 - 0x8000));
+
+	// R, G and B coefficients paired for pmaddwd. The offset keeps the
+	// linear Y in the signed 16-bit range.
+	const __m256i  c_rg   = _mm256_unpacklo_epi16 (
+		_mm256_set1_epi16 (_coef_rgby_int [Col_R]),
+		_mm256_set1_epi16 (_coef_rgby_int [Col_G])
+	);
+	const __m256i  c_b0   = _mm256_unpacklo_epi16 (
+		_mm256_set1_epi16 (_coef_rgby_int [Col_B]),
+		zero
+	);
+	const __m256i  k_yl   = _mm256_set1_epi32 (
+		cst_r + 0x8000 * (sum_c - (1 << SHIFT_INT))
+	);
+
+	const __m256i  c_dy   = _mm256_set1_epi16 (int16_t (_coef_yg_a_int));
+	const __m256i  k_dy   = _mm256_set1_epi32 (_coef_yg_b_int + 0x8000 * _coef_yg_a_int);
+	const __m256i  c_cb_p = _mm256_set1_epi16 (int16_t (_coef_cb_a_int [0]));
+	const __m256i  c_cb_n = _mm256_set1_epi16 (int16_t (_coef_cb_a_int [1]));
+	const __m256i  c_cr_p = _mm256_set1_epi16 (int16_t (_coef_cr_a_int [0]));
+	const __m256i  c_cr_n = _mm256_set1_epi16 (int16_t (_coef_cr_a_int [1]));
+	const __m256i  k_c    = _mm256_set1_epi32 (_coef_cbcr_b_int);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; x += packsize)
+		{
+			const __m256i  rl  = SrcS16R::read (src_0_ptr, zero, sign_bit);
+			const __m256i  gl  = SrcS16R::read (src_1_ptr, zero, sign_bit);
+			const __m256i  bl  = SrcS16R::read (src_2_ptr, zero, sign_bit);
+			const __m256i  rls = _mm256_xor_si256 (rl, sign_bit);
+			const __m256i  gls = _mm256_xor_si256 (gl, sign_bit);
+			const __m256i  bls = _mm256_xor_si256 (bl, sign_bit);
+
+			__m256i        yl0 = _mm256_add_epi32 (
+				_mm256_madd_epi16 (_mm256_unpacklo_epi16 (rls, gls), c_rg),
+				_mm256_madd_epi16 (_mm256_unpacklo_epi16 (bls, zero), c_b0)
+			);
+			__m256i        yl1 = _mm256_add_epi32 (
+				_mm256_madd_epi16 (_mm256_unpackhi_epi16 (rls, gls), c_rg),
+				_mm256_madd_epi16 (_mm256_unpackhi_epi16 (bls, zero), c_b0)
+			);
+			yl0 = _mm256_srai_epi32 (_mm256_add_epi32 (yl0, k_yl), SHIFT_INT);
+			yl1 = _mm256_srai_epi32 (_mm256_add_epi32 (yl1, k_yl), SHIFT_INT);
+			const __m256i  yl  =
+				_mm256_xor_si256 (_mm256_packs_epi32 (yl0, yl1), sign_bit);
+
+			const __m256i  ygs = _mm256_xor_si256 (
+				Matrix2020CLProc_map_avx2 (yl, map_ptr), sign_bit
+			);
+			const __m256i  bgs = _mm256_xor_si256 (
+				Matrix2020CLProc_map_avx2 (bl, map_ptr), sign_bit
+			);
+			const __m256i  rgs = _mm256_xor_si256 (
+				Matrix2020CLProc_map_avx2 (rl, map_ptr), sign_bit
+			);
+
+			// Y'
+			__m256i        dy0 = k_dy;
+			__m256i        dy1 = k_dy;
+			fstb::ToolsAvx2::mac_s16_s16_s32 (dy0, dy1, ygs, c_dy);
+			dy0 = _mm256_sub_epi32 (_mm256_srai_epi32 (dy0, shft2), ofs_grey);
+			dy1 = _mm256_sub_epi32 (_mm256_srai_epi32 (dy1, shft2), ofs_grey);
+
+			// Cb and Cr. The differences don't fit in 16 bits, so they are
+			// computed within pmaddwd with (c, -c) coefficient pairs.
+			const __m256i  c_cb  = fstb::ToolsAvx2::select (
+				_mm256_cmpgt_epi16 (ygs, bgs), c_cb_n, c_cb_p
+			);
+			const __m256i  c_cr  = fstb::ToolsAvx2::select (
+				_mm256_cmpgt_epi16 (ygs, rgs), c_cr_n, c_cr_p
+			);
+			const __m256i  c_cbm = _mm256_sub_epi16 (zero, c_cb);
+			const __m256i  c_crm = _mm256_sub_epi16 (zero, c_cr);
+			__m256i        dcb0  = _mm256_madd_epi16 (
+				_mm256_unpacklo_epi16 (bgs, ygs), _mm256_unpacklo_epi16 (c_cb, c_cbm)
+			);
+			__m256i        dcb1  = _mm256_madd_epi16 (
+				_mm256_unpackhi_epi16 (bgs, ygs), _mm256_unpackhi_epi16 (c_cb, c_cbm)
+			);
+			__m256i        dcr0  = _mm256_madd_epi16 (
+				_mm256_unpacklo_epi16 (rgs, ygs), _mm256_unpacklo_epi16 (c_cr, c_crm)
+			);
+			__m256i        dcr1  = _mm256_madd_epi16 (
+				_mm256_unpackhi_epi16 (rgs, ygs), _mm256_unpackhi_epi16 (c_cr, c_crm)
+			);
+			dcb0 = _mm256_srai_epi32 (_mm256_add_epi32 (dcb0, k_c), shft2);
+			dcb1 = _mm256_srai_epi32 (_mm256_add_epi32 (dcb1, k_c), shft2);
+			dcr0 = _mm256_srai_epi32 (_mm256_add_epi32 (dcr0, k_c), shft2);
+			dcr1 = _mm256_srai_epi32 (_mm256_add_epi32 (dcr1, k_c), shft2);
+			dcb0 = _mm256_sub_epi32 (dcb0, ofs_grey);
+			dcb1 = _mm256_sub_epi32 (dcb1, ofs_grey);
+			dcr0 = _mm256_sub_epi32 (dcr0, ofs_grey);
+			dcr1 = _mm256_sub_epi32 (dcr1, ofs_grey);
+
+			// Values are clipped in the signed domain, then offset back
+			const __m256i  dy  = _mm256_packs_epi32 (dy0 , dy1 );
+			const __m256i  dcb = _mm256_packs_epi32 (dcb0, dcb1);
+			const __m256i  dcr = _mm256_packs_epi32 (dcr0, dcr1);
+
+			DstS16W::write_clip (dst_0_ptr, dy , mask_lsb, sign_bit, ma, sign_bit);
+			DstS16W::write_clip (dst_1_ptr, dcb, mask_lsb, sign_bit, ma, sign_bit);
+			DstS16W::write_clip (dst_2_ptr, dcr, mask_lsb, sign_bit, ma, sign_bit);
+
+			SRC::PtrConst::jump (src_0_ptr, packsize);
+			SRC::PtrConst::jump (src_1_ptr, packsize);
+			SRC::PtrConst::jump (src_2_ptr, packsize);
+
+			DST::Ptr::jump (dst_0_ptr, packsize);
+			DST::Ptr::jump (dst_1_ptr, packsize);
+			DST::Ptr::jump (dst_2_ptr, packsize);
+		}
+
+		SRC::PtrConst::jump (src_0_ptr, src_0_str);
+		SRC::PtrConst::jump (src_1_ptr, src_1_str);
+		SRC::PtrConst::jump (src_2_ptr, src_2_str);
+
+		DST::Ptr::jump (dst_0_ptr, dst_0_str);
+		DST::Ptr::jump (dst_1_ptr, dst_1_str);
+		DST::Ptr::jump (dst_2_ptr, dst_2_str);
+	}
+}
+
+
+
+void	Matrix2020CLProc::conv_rgb_2_ycbcr_avx2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (_lut_uptr.get () != 0);
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+	const int      sizeof_xt = int (sizeof (float));
+	assert (src_str_arr [0] % sizeof_xt == 0);
+	assert (src_str_arr [1] % sizeof_xt == 0);
+	assert (src_str_arr [2] % sizeof_xt == 0);
+	assert (dst_str_arr [0] % sizeof_xt == 0);
+	assert (dst_str_arr [1] % sizeof_xt == 0);
+	assert (dst_str_arr [2] % sizeof_xt == 0);
+
+	const int      stride_fix = ((w + BUF_LEN - 1) / BUF_LEN) * BUF_LEN;
+
+	const float *  src_0_ptr = reinterpret_cast <const float *> (src_ptr_arr [0]);
+	const float *  src_1_ptr = reinterpret_cast <const float *> (src_ptr_arr [1]);
+	const float *  src_2_ptr = reinterpret_cast <const float *> (src_ptr_arr [2]);
+	const int      src_0_str = src_str_arr [0] / sizeof_xt - stride_fix;
+	const int      src_1_str = src_str_arr [1] / sizeof_xt - stride_fix;
+	const int      src_2_str = src_str_arr [2] / sizeof_xt - stride_fix;
+
+	float *        dst_0_ptr = reinterpret_cast <      float *> (dst_ptr_arr [0]);
+	float *        dst_1_ptr = reinterpret_cast <      float *> (dst_ptr_arr [1]);
+	float *        dst_2_ptr = reinterpret_cast <      float *> (dst_ptr_arr [2]);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_xt - stride_fix;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_xt - stride_fix;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_xt - stride_fix;
+
+	BufAlign       tmp_buf_arr;
+
+	const __m256   c_yr   = _mm256_set1_ps (float (_coef_rgb_to_y_dbl [Col_R]));
+	const __m256   c_yg   = _mm256_set1_ps (float (_coef_rgb_to_y_dbl [Col_G]));
+	const __m256   c_yb   = _mm256_set1_ps (float (_coef_rgb_to_y_dbl [Col_B]));
+
+	const __m256   c_cb_n = _mm256_set1_ps (float (1 / _coef_cb_neg));
+	const __m256   c_cb_p = _mm256_set1_ps (float (1 / _coef_cb_pos));
+	const __m256   c_cr_n = _mm256_set1_ps (float (1 / _coef_cr_neg));
+	const __m256   c_cr_p = _mm256_set1_ps (float (1 / _coef_cr_pos));
+
+	const __m256   zero   = _mm256_setzero_ps ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x_buf = 0; x_buf < w; x_buf += BUF_LEN)
+		{
+			const int      w_work = std::min (w - x_buf, int (BUF_LEN));
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   rl = _mm256_load_ps (src_0_ptr + x);
+				const __m256   gl = _mm256_load_ps (src_1_ptr + x);
+				const __m256   bl = _mm256_load_ps (src_2_ptr + x);
+				const __m256   yl = _mm256_add_ps (_mm256_add_ps (
+					_mm256_mul_ps (rl, c_yr),
+					_mm256_mul_ps (gl, c_yg)),
+					_mm256_mul_ps (bl, c_yb)
+				);
+				_mm256_store_ps (tmp_buf_arr [0] + x, yl);
+			}
+
+			_lut_uptr->process_plane (
+				reinterpret_cast <      uint8_t *> (dst_0_ptr),
+				reinterpret_cast <const uint8_t *> (tmp_buf_arr [0]),
+				0, 0, w_work, 1
+			);
+			_lut_uptr->process_plane (
+				reinterpret_cast <      uint8_t *> (tmp_buf_arr [1]),
+				reinterpret_cast <const uint8_t *> (src_2_ptr),
+				0, 0, w_work, 1
+			);
+			_lut_uptr->process_plane (
+				reinterpret_cast <      uint8_t *> (tmp_buf_arr [2]),
+				reinterpret_cast <const uint8_t *> (src_0_ptr),
+				0, 0, w_work, 1
+			);
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   yg   = _mm256_load_ps (dst_0_ptr       + x);
+				const __m256   bg   = _mm256_load_ps (tmp_buf_arr [1] + x);
+				const __m256   rg   = _mm256_load_ps (tmp_buf_arr [2] + x);
+
+				const __m256   cb   = _mm256_sub_ps (bg, yg);
+				const __m256   cr   = _mm256_sub_ps (rg, yg);
+
+				const __m256   cb_n = _mm256_cmp_ps (cb, zero, _CMP_LT_OQ);
+				const __m256   cr_n = _mm256_cmp_ps (cr, zero, _CMP_LT_OQ);
+
+				const __m256   c_cb = fstb::ToolsAvx2::select (cb_n, c_cb_n, c_cb_p);
+				const __m256   c_cr = fstb::ToolsAvx2::select (cr_n, c_cr_n, c_cr_p);
+
+				const __m256   dcb  = _mm256_mul_ps (cb, c_cb);
+				const __m256   dcr  = _mm256_mul_ps (cr, c_cr);
+
+				_mm256_store_ps (dst_1_ptr + x, dcb);
+				_mm256_store_ps (dst_2_ptr + x, dcr);
+			}
+
+			src_0_ptr += BUF_LEN;
+			src_1_ptr += BUF_LEN;
+			src_2_ptr += BUF_LEN;
+
+			dst_0_ptr += BUF_LEN;
+			dst_1_ptr += BUF_LEN;
+			dst_2_ptr += BUF_LEN;
+		}
+
+		src_0_ptr += src_0_str;
+		src_1_ptr += src_1_str;
+		src_2_ptr += src_2_str;
+
+		dst_0_ptr += dst_0_str;
+		dst_1_ptr += dst_1_str;
+		dst_2_ptr += dst_2_str;
+	}
+}
+
+
+
+// DST and SRC are ProxyRwAvx2 classes
+// Bit-exact with conv_ycbcr_2_rgb_cpp_int.
+template <class DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_ycbcr_2_rgb_avx2_int (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+	assert (_coef_yg_a_int <= 0x7FFF);
+	assert (_coef_cb_a_int [0] <= 0x7FFF);
+	assert (_coef_cb_a_int [1] <= 0x7FFF);
+	assert (_coef_cr_a_int [0] <= 0x7FFF);
+	assert (_coef_cr_a_int [1] <= 0x7FFF);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+	static_assert (DB == 16, "Output must be 16 bits");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+	typedef typename SRC::template S16 <false, false> SrcS16R;
+	typedef typename DST::template S16 <false, false> DstS16W;
+
+	const int      packsize  = 16;
+	const int      sizeof_st = int (sizeof (typename SRC::PtrConst::DataType));
+	assert (src_str_arr [0] % sizeof_st == 0);
+	assert (src_str_arr [1] % sizeof_st == 0);
+	assert (src_str_arr [2] % sizeof_st == 0);
+	const int      sizeof_dt = int (sizeof (typename DST::Ptr::DataType));
+	assert (dst_str_arr [0] % sizeof_dt == 0);
+	assert (dst_str_arr [1] % sizeof_dt == 0);
+	assert (dst_str_arr [2] % sizeof_dt == 0);
+
+	const int      wp = (w + (packsize - 1)) & -packsize;
+
+	SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [0], src_str_arr [0], h);
+	SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [1], src_str_arr [1], h);
+	SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [2], src_str_arr [2], h);
+	const int      src_0_str = src_str_arr [0] / sizeof_st - wp;
+	const int      src_1_str = src_str_arr [1] / sizeof_st - wp;
+	const int      src_2_str = src_str_arr [2] / sizeof_st - wp;
+
+	DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst_ptr_arr [0], dst_str_arr [0], h);
+	DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst_ptr_arr [1], dst_str_arr [1], h);
+	DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst_ptr_arr [2], dst_str_arr [2], h);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_dt - wp;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_dt - wp;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_dt - wp;
+
+	const int      shft2     = SHIFT_INT + SB - RGB_INT_BITS;
+	const int      cst_r     = 1 << (SHIFT_INT - 1);
+	const int      ofs_grey  = 1 << (SB - 1);
+	const int      sum_c     =
+		_coef_rgby_int [Col_R] + _coef_rgby_int [Col_G] + _coef_rgby_int [Col_B];
+	const uint16_t *  map_ptr = &_map_gamma_int [0];
+
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256i  ofs_u16  = _mm256_set1_epi32 (0x8000);
+	const __m256i  grey     = _mm256_set1_epi16 (int16_t (ofs_grey));
+
+	const __m256i  c_dy   = _mm256_set1_epi16 (int16_t (_coef_yg_a_int));
+	const __m256i  k_dy   = _mm256_set1_epi32 (_coef_yg_b_int + 0x8000 * _coef_yg_a_int);
+	const __m256i  c_cb_p = _mm256_set1_epi16 (int16_t (_coef_cb_a_int [0]));
+	const __m256i  c_cb_n = _mm256_set1_epi16 (int16_t (_coef_cb_a_int [1]));
+	const __m256i  c_cr_p = _mm256_set1_epi16 (int16_t (_coef_cr_a_int [0]));
+	const __m256i  c_cr_n = _mm256_set1_epi16 (int16_t (_coef_cr_a_int [1]));
+	const __m256i  k_c    = _mm256_set1_epi32 (_coef_cbcr_b_int);
+
+	// R, Y and B coefficients paired for pmaddwd
+	const __m256i  c_ry   = _mm256_unpacklo_epi16 (
+		_mm256_set1_epi16 (_coef_rgby_int [Col_R]),
+		_mm256_set1_epi16 (_coef_rgby_int [Col_G])
+	);
+	const __m256i  c_b0   = _mm256_unpacklo_epi16 (
+		_mm256_set1_epi16 (_coef_rgby_int [Col_B]),
+		zero
+	);
+	const __m256i  k_gl   = _mm256_set1_epi32 (cst_r + 0x8000 * sum_c);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; x += packsize)
+		{
+			const __m256i  dy   = SrcS16R::read (src_0_ptr, zero, sign_bit);
+			const __m256i  dcb  = SrcS16R::read (src_1_ptr, zero, sign_bit);
+			const __m256i  dcr  = SrcS16R::read (src_2_ptr, zero, sign_bit);
+			const __m256i  dys  = _mm256_xor_si256 (dy, sign_bit);
+			const __m256i  dcb0 = _mm256_sub_epi16 (dcb, grey);
+			const __m256i  dcr0 = _mm256_sub_epi16 (dcr, grey);
+
+			// Y' is offset by -0x8000 so the sums can be clipped
+			// with a signed saturation.
+			__m256i        yg0 = k_dy;
+			__m256i        yg1 = k_dy;
+			fstb::ToolsAvx2::mac_s16_s16_s32 (yg0, yg1, dys, c_dy);
+			yg0 = _mm256_sub_epi32 (_mm256_srai_epi32 (yg0, shft2), ofs_u16);
+			yg1 = _mm256_sub_epi32 (_mm256_srai_epi32 (yg1, shft2), ofs_u16);
+
+			const __m256i  c_cb = fstb::ToolsAvx2::select (
+				_mm256_cmpgt_epi16 (zero, dcb0), c_cb_n, c_cb_p
+			);
+			const __m256i  c_cr = fstb::ToolsAvx2::select (
+				_mm256_cmpgt_epi16 (zero, dcr0), c_cr_n, c_cr_p
+			);
+			__m256i        cb0 = k_c;
+			__m256i        cb1 = k_c;
+			__m256i        cr0 = k_c;
+			__m256i        cr1 = k_c;
+			fstb::ToolsAvx2::mac_s16_s16_s32 (cb0, cb1, dcb0, c_cb);
+			fstb::ToolsAvx2::mac_s16_s16_s32 (cr0, cr1, dcr0, c_cr);
+			cb0 = _mm256_srai_epi32 (cb0, shft2);
+			cb1 = _mm256_srai_epi32 (cb1, shft2);
+			cr0 = _mm256_srai_epi32 (cr0, shft2);
+			cr1 = _mm256_srai_epi32 (cr1, shft2);
+
+			const __m256i  yg = _mm256_xor_si256 (
+				_mm256_packs_epi32 (yg0, yg1), sign_bit
+			);
+			const __m256i  bg = _mm256_xor_si256 (_mm256_packs_epi32 (
+				_mm256_add_epi32 (cb0, yg0), _mm256_add_epi32 (cb1, yg1)
+			), sign_bit);
+			const __m256i  rg = _mm256_xor_si256 (_mm256_packs_epi32 (
+				_mm256_add_epi32 (cr0, yg0), _mm256_add_epi32 (cr1, yg1)
+			), sign_bit);
+
+			const __m256i  yl  = Matrix2020CLProc_map_avx2 (yg, map_ptr);
+			const __m256i  bl  = Matrix2020CLProc_map_avx2 (bg, map_ptr);
+			const __m256i  rl  = Matrix2020CLProc_map_avx2 (rg, map_ptr);
+			const __m256i  yls = _mm256_xor_si256 (yl, sign_bit);
+			const __m256i  bls = _mm256_xor_si256 (bl, sign_bit);
+			const __m256i  rls = _mm256_xor_si256 (rl, sign_bit);
+
+			__m256i        gl0 = _mm256_add_epi32 (
+				_mm256_madd_epi16 (_mm256_unpacklo_epi16 (rls, yls), c_ry),
+				_mm256_madd_epi16 (_mm256_unpacklo_epi16 (bls, zero), c_b0)
+			);
+			__m256i        gl1 = _mm256_add_epi32 (
+				_mm256_madd_epi16 (_mm256_unpackhi_epi16 (rls, yls), c_ry),
+				_mm256_madd_epi16 (_mm256_unpackhi_epi16 (bls, zero), c_b0)
+			);
+			gl0 = _mm256_srai_epi32 (_mm256_add_epi32 (gl0, k_gl), SHIFT_INT);
+			gl1 = _mm256_srai_epi32 (_mm256_add_epi32 (gl1, k_gl), SHIFT_INT);
+
+			// Wraps around like the reference code
+			gl0 = _mm256_srai_epi32 (_mm256_slli_epi32 (gl0, 16), 16);
+			gl1 = _mm256_srai_epi32 (_mm256_slli_epi32 (gl1, 16), 16);
+			const __m256i  gl  = _mm256_packs_epi32 (gl0, gl1);
+
+			DstS16W::write_clip (dst_0_ptr, rl, mask_lsb, zero, zero, sign_bit);
+			DstS16W::write_clip (dst_1_ptr, gl, mask_lsb, zero, zero, sign_bit);
+			DstS16W::write_clip (dst_2_ptr, bl, mask_lsb, zero, zero, sign_bit);
+
+			SRC::PtrConst::jump (src_0_ptr, packsize);
+			SRC::PtrConst::jump (src_1_ptr, packsize);
+			SRC::PtrConst::jump (src_2_ptr, packsize);
+
+			DST::Ptr::jump (dst_0_ptr, packsize);
+			DST::Ptr::jump (dst_1_ptr, packsize);
+			DST::Ptr::jump (dst_2_ptr, packsize);
+		}
+
+		SRC::PtrConst::jump (src_0_ptr, src_0_str);
+		SRC::PtrConst::jump (src_1_ptr, src_1_str);
+		SRC::PtrConst::jump (src_2_ptr, src_2_str);
+
+		DST::Ptr::jump (dst_0_ptr, dst_0_str);
+		DST::Ptr::jump (dst_1_ptr, dst_1_str);
+		DST::Ptr::jump (dst_2_ptr, dst_2_str);
+	}
+}
+
+
+
+void	Matrix2020CLProc::conv_ycbcr_2_rgb_avx2_flt (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (_lut_uptr.get () != 0);
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+	const int      sizeof_xt = int (sizeof (float));
+	assert (src_str_arr [0] % sizeof_xt == 0);
+	assert (src_str_arr [1] % sizeof_xt == 0);
+	assert (src_str_arr [2] % sizeof_xt == 0);
+	assert (dst_str_arr [0] % sizeof_xt == 0);
+	assert (dst_str_arr [1] % sizeof_xt == 0);
+	assert (dst_str_arr [2] % sizeof_xt == 0);
+
+	const int      stride_fix = ((w + BUF_LEN - 1) / BUF_LEN) * BUF_LEN;
+
+	const float *  src_0_ptr = reinterpret_cast <const float *> (src_ptr_arr [0]);
+	const float *  src_1_ptr = reinterpret_cast <const float *> (src_ptr_arr [1]);
+	const float *  src_2_ptr = reinterpret_cast <const float *> (src_ptr_arr [2]);
+	const int      src_0_str = src_str_arr [0] / sizeof_xt - stride_fix;
+	const int      src_1_str = src_str_arr [1] / sizeof_xt - stride_fix;
+	const int      src_2_str = src_str_arr [2] / sizeof_xt - stride_fix;
+
+	float *        dst_0_ptr = reinterpret_cast <      float *> (dst_ptr_arr [0]);
+	float *        dst_1_ptr = reinterpret_cast <      float *> (dst_ptr_arr [1]);
+	float *        dst_2_ptr = reinterpret_cast <      float *> (dst_ptr_arr [2]);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_xt - stride_fix;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_xt - stride_fix;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_xt - stride_fix;
+
+	const __m256   c_rl   = _mm256_set1_ps (float (_coef_ryb_to_g_dbl [Col_R]));
+	const __m256   c_gl   = _mm256_set1_ps (float (_coef_ryb_to_g_dbl [Col_G]));
+	const __m256   c_bl   = _mm256_set1_ps (float (_coef_ryb_to_g_dbl [Col_B]));
+
+	const __m256   c_cb_n = _mm256_set1_ps (float (_coef_cb_neg));
+	const __m256   c_cb_p = _mm256_set1_ps (float (_coef_cb_pos));
+	const __m256   c_cr_n = _mm256_set1_ps (float (_coef_cr_neg));
+	const __m256   c_cr_p = _mm256_set1_ps (float (_coef_cr_pos));
+
+	const __m256   zero   = _mm256_setzero_ps ();
+
+	BufAlign       tmp_buf_arr;
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x_buf = 0; x_buf < w; x_buf += BUF_LEN)
+		{
+			const int      w_work = std::min (w - x_buf, int (BUF_LEN));
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   yg   = _mm256_load_ps (src_0_ptr + x);
+				const __m256   dcb  = _mm256_load_ps (src_1_ptr + x);
+				const __m256   dcr  = _mm256_load_ps (src_2_ptr + x);
+
+				const __m256   cb_n = _mm256_cmp_ps (dcb, zero, _CMP_LT_OQ);
+				const __m256   cr_n = _mm256_cmp_ps (dcr, zero, _CMP_LT_OQ);
+
+				const __m256   c_cb = fstb::ToolsAvx2::select (cb_n, c_cb_n, c_cb_p);
+				const __m256   c_cr = fstb::ToolsAvx2::select (cr_n, c_cr_n, c_cr_p);
+
+				const __m256   cb   = _mm256_mul_ps (dcb, c_cb);
+				const __m256   cr   = _mm256_mul_ps (dcr, c_cr);
+
+				const __m256   bg   = _mm256_add_ps (cb, yg);
+				const __m256   rg   = _mm256_add_ps (cr, yg);
+
+				_mm256_store_ps (tmp_buf_arr [1] + x, bg);
+				_mm256_store_ps (tmp_buf_arr [2] + x, rg);
+			}
+
+			_lut_uptr->process_plane (
+				reinterpret_cast <      uint8_t *> (tmp_buf_arr [0]),
+				reinterpret_cast <const uint8_t *> (src_0_ptr),
+				0, 0, w_work, 1
+			);
+			_lut_uptr->process_plane (
+				reinterpret_cast <      uint8_t *> (dst_2_ptr),
+				reinterpret_cast <const uint8_t *> (tmp_buf_arr [1]),
+				0, 0, w_work, 1
+			);
+			_lut_uptr->process_plane (
+				reinterpret_cast <      uint8_t *> (dst_0_ptr),
+				reinterpret_cast <const uint8_t *> (tmp_buf_arr [2]),
+				0, 0, w_work, 1
+			);
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   yl = _mm256_load_ps (tmp_buf_arr [0] + x);
+				const __m256   bl = _mm256_load_ps (dst_2_ptr + x);
+				const __m256   rl = _mm256_load_ps (dst_0_ptr + x);
+				const __m256   gl = _mm256_add_ps (_mm256_add_ps (
+					_mm256_mul_ps (yl, c_gl),
+					_mm256_mul_ps (bl, c_bl)),
+					_mm256_mul_ps (rl, c_rl)
+				);
+				_mm256_store_ps (dst_1_ptr + x, gl);
+			}
+
+			src_0_ptr += BUF_LEN;
+			src_1_ptr += BUF_LEN;
+			src_2_ptr += BUF_LEN;
+
+			dst_0_ptr += BUF_LEN;
+			dst_1_ptr += BUF_LEN;
+			dst_2_ptr += BUF_LEN;
+		}
+
+		src_0_ptr += src_0_str;
+		src_1_ptr += src_1_str;
+		src_2_ptr += src_2_str;
+
+		dst_0_ptr += dst_0_str;
+		dst_1_ptr += dst_1_str;
+		dst_2_ptr += dst_2_str;
+	}
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -55,11 +55,13 @@ namespace fmtcl
 
 
 
-MatrixProc::MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag)
+MatrixProc::MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag, bool fma_flag)
 :	_sse_flag (sse_flag)
 ,	_sse2_flag (sse2_flag)
 ,	_avx_flag (avx_flag)
 ,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx512_flag)
+,	_fma_flag (fma_flag)
 ,	_proc_ptr (0)
 ,	_coef_flt_arr ()
 ,	_coef_int_arr ()
@@ -186,6 +188,16 @@ MatrixProc::Err	MatrixProc::configure (const Mat4 &m, bool int_proc_flag, SplFmt
 				single_plane_flag
 			);
 		}
+
+		if (_avx512_flag)
+		{
+			setup_fnc_avx512 (
+				int_proc_flag,
+				src_fmt, src_bits,
+				dst_fmt, dst_bits,
+				single_plane_flag
+			);
+		}
 	}
 #endif   // fstb_ARCHI_X86
 
@@ -248,9 +260,10 @@ MatrixProc::Err	MatrixProc::set_matrix_int (const Mat4 &m, int plane_out, int sr
 	_coef_int_arr.resize (NBR_PLANES * MAT_SIZE, 0);
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-	if (_sse2_flag || _avx2_flag)
+	if (_sse2_flag || _avx2_flag || _avx512_flag)
 	{
-		if (_avx2_flag)
+		// The AVX-512 code uses the AVX2 coefficient layout too.
+		if (_avx2_flag || _avx512_flag)
 		{
 			_coef_simd_arr.set_avx2_mode (true);
 		}
@@ -268,7 +281,7 @@ MatrixProc::Err	MatrixProc::set_matrix_int (const Mat4 &m, int plane_out, int sr
 	for (int y = plane_beg; y < plane_end; ++y)
 	{
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-		// SSE2/AVX2 only
+		// SSE2/AVX2/AVX-512 only
 		// Compensates for the sign in 16 bits.
 		// We need to take both source and destination into account.
 		// Real formula:
@@ -309,8 +322,8 @@ MatrixProc::Err	MatrixProc::set_matrix_int (const Mat4 &m, int plane_out, int sr
 			_coef_int_arr [index] = c_cpp;
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-			// Coefficient for the SSE2/AVX2 version
-			if (_sse2_flag || _avx2_flag)
+			// Coefficient for the SSE2/AVX2/AVX-512 version
+			if (_sse2_flag || _avx2_flag || _avx512_flag)
 			{
 				// Default: normal integer coefficient
 				int            c_sse2 = c_int;
@@ -63,7 +63,7 @@ public:
 	static const int  NBR_PLANES = 3;
 	static const int  MAT_SIZE   = NBR_PLANES + 1;
 
-	explicit       MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag);
+	explicit       MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag, bool fma_flag);
 	virtual        ~MatrixProc () {}
 
 	Err            configure (const Mat4 &m, bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, int plane_out);
@@ -95,6 +95,7 @@ private:
 	void           setup_fnc_sse2 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
 	void           setup_fnc_avx (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
 	void           setup_fnc_avx2 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
+	void           setup_fnc_avx512 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
 #endif   // fstb_ARCHI_X86
 
 	template <typename DST, int DB, class SRC, int SB>
@@ -113,14 +114,25 @@ private:
 
 	template <class DST, int DB, class SRC, int SB, int NP>
 	void           process_n_int_avx2 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	template <bool FMA_FLAG>
 	void           process_3_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	template <bool FMA_FLAG>
 	void           process_1_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+
+	template <class DST, int DB, class SRC, int SB, int NP>
+	void           process_n_int_avx512 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	template <bool FMA_FLAG>
+	void           process_3_flt_avx512 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+	template <bool FMA_FLAG>
+	void           process_1_flt_avx512 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
 #endif   // fstb_ARCHI_X86
 
 	bool           _sse_flag;
 	bool           _sse2_flag;
 	bool           _avx_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;           // AVX-512F and AVX-512BW
+	bool           _fma_flag;              // Float only, requires _avx_flag
 
 	void (ThisType::*                   // 0 = not set
 	               _proc_ptr) (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
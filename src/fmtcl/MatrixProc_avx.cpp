@@ -56,17 +56,48 @@ void	MatrixProc::setup_fnc_avx (bool int_proc_flag, SplFmt src_fmt, int src_bits
 	{
 		if (single_plane_flag)
 		{
-			_proc_ptr = &ThisType::process_1_flt_avx;
+			_proc_ptr = (_fma_flag)
+				? &ThisType::process_1_flt_avx <true>
+				: &ThisType::process_1_flt_avx <false>;
 		}
 		else
 		{
-			_proc_ptr = &ThisType::process_3_flt_avx;
+			_proc_ptr = (_fma_flag)
+				? &ThisType::process_3_flt_avx <true>
+				: &ThisType::process_3_flt_avx <false>;
 		}
 	}
 }
 
 
 
+// c0 * s0 + c1 * s1 + c2 * s2 + c3
+// The FMA version accumulates in a different order.
+template <bool FMA_FLAG>
+static fstb_FORCEINLINE __m256	MatrixProc_mac3_avx (__m256 s0, __m256 s1, __m256 s2, __m256 c0, __m256 c1, __m256 c2, __m256 c3)
+{
+	__m256         d;
+	if (FMA_FLAG)
+	{
+		d = _mm256_fmadd_ps (s0, c0, c3);
+		d = _mm256_fmadd_ps (s1, c1, d);
+		d = _mm256_fmadd_ps (s2, c2, d);
+	}
+	else
+	{
+		d = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
+			_mm256_mul_ps (s0, c0),
+			_mm256_mul_ps (s1, c1)),
+			_mm256_mul_ps (s2, c2)),
+			                  c3);
+	}
+
+	return (d);
+}
+
+
+
+template <bool FMA_FLAG>
 void	MatrixProc::process_3_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
 {
 	assert (dst_ptr_arr != 0);
@@ -120,21 +151,15 @@ void	MatrixProc::process_3_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], co
 			const __m256   s1 = _mm256_load_ps (src_1_ptr + x);
 			const __m256   s2 = _mm256_load_ps (src_2_ptr + x);
 
-			const __m256   d0 = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
-				_mm256_mul_ps (s0, c00),
-				_mm256_mul_ps (s1, c01)),
-				_mm256_mul_ps (s2, c02)),
-				                   c03);
-			const __m256   d1 = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
-				_mm256_mul_ps (s0, c04),
-				_mm256_mul_ps (s1, c05)),
-				_mm256_mul_ps (s2, c06)),
-				                   c07);
-			const __m256   d2 = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
-				_mm256_mul_ps (s0, c08),
-				_mm256_mul_ps (s1, c09)),
-				_mm256_mul_ps (s2, c10)),
-				                   c11);
+			const __m256   d0 = MatrixProc_mac3_avx <FMA_FLAG> (
+				s0, s1, s2, c00, c01, c02, c03
+			);
+			const __m256   d1 = MatrixProc_mac3_avx <FMA_FLAG> (
+				s0, s1, s2, c04, c05, c06, c07
+			);
+			const __m256   d2 = MatrixProc_mac3_avx <FMA_FLAG> (
+				s0, s1, s2, c08, c09, c10, c11
+			);
 
 			_mm256_store_ps (dst_0_ptr + x, d0);
 			_mm256_store_ps (dst_1_ptr + x, d1);
@@ -155,6 +180,7 @@ void	MatrixProc::process_3_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], co
 
 
 
+template <bool FMA_FLAG>
 void	MatrixProc::process_1_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
 {
 	assert (dst_ptr_arr != 0);
@@ -194,11 +220,9 @@ void	MatrixProc::process_1_flt_avx (uint8_t * const dst_ptr_arr [NBR_PLANES], co
 			const __m256   s1 = _mm256_load_ps (src_1_ptr + x);
 			const __m256   s2 = _mm256_load_ps (src_2_ptr + x);
 
-			const __m256   d0 = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
-				_mm256_mul_ps (s0, c00),
-				_mm256_mul_ps (s1, c01)),
-				_mm256_mul_ps (s2, c02)),
-				                c03);
+			const __m256   d0 = MatrixProc_mac3_avx <FMA_FLAG> (
+				s0, s1, s2, c00, c01, c02, c03
+			);
 
 			_mm256_store_ps (dst_0_ptr + x, d0);
 		}
@@ -0,0 +1,427 @@
+/*****************************************************************************
+
+        MatrixProc_avx512.cpp
+        Author: agent, 2026
+
+To be compiled with AVX-512F and AVX-512BW enabled.
+
+Unlike the SSE2 and AVX2 versions, the last pixels of each row are processed
+with masked loads and stores. Rows are not read or written beyond w.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/MatrixProc_macro.h"
+#include "fmtcl/ProxyRwAvx512.h"
+#include "fstb/ToolsAvx512.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	MatrixProc::setup_fnc_avx512 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag)
+{
+	// Integer
+	if (int_proc_flag)
+	{
+#define fmtcl_MatrixProc_CASE_INT(DF, DB, SF, SB) \
+		case   (fmtcl::SplFmt_##DF << 18) + (DB << 11) \
+		     + (fmtcl::SplFmt_##SF <<  8) + (SB <<  1) + 0: \
+			_proc_ptr = &ThisType::process_n_int_avx512 < \
+				ProxyRwAvx512 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwAvx512 <fmtcl::SplFmt_##SF>, SB, 3 \
+			>; \
+			break; \
+		case   (fmtcl::SplFmt_##DF << 18) + (DB << 11) \
+		     + (fmtcl::SplFmt_##SF <<  8) + (SB <<  1) + 1: \
+			_proc_ptr = &ThisType::process_n_int_avx512 < \
+				ProxyRwAvx512 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwAvx512 <fmtcl::SplFmt_##SF>, SB, 1 \
+			>; \
+			break;
+
+		switch (
+			  (dst_fmt  << 18)
+			+ (dst_bits << 11)
+			+ (src_fmt  <<  8)
+			+ (src_bits <<  1)
+			+ (single_plane_flag ? 1 : 0)
+		)
+		{
+		fmtcl_MatrixProc_SPAN_I (fmtcl_MatrixProc_CASE_INT)
+		// No default, format combination is already checked
+		// and the C++ code fills all the possibilities.
+		}
+#undef fmtcl_MatrixProc_CASE_INT
+	}
+
+	// Float
+	else
+	{
+		if (single_plane_flag)
+		{
+			_proc_ptr = (_fma_flag)
+				? &ThisType::process_1_flt_avx512 <true>
+				: &ThisType::process_1_flt_avx512 <false>;
+		}
+		else
+		{
+			_proc_ptr = (_fma_flag)
+				? &ThisType::process_3_flt_avx512 <true>
+				: &ThisType::process_3_flt_avx512 <false>;
+		}
+	}
+}
+
+
+
+// DST and SRC are ProxyRwAvx512 classes
+template <class DST, int DB, class SRC, int SB, int NP>
+void	MatrixProc::process_n_int_avx512 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+
+	typedef typename SRC::template S16 <false     , (SB == 16)> SrcS16R;
+	typedef typename DST::template S16 <(DB != 16), (DB == 16)> DstS16W;
+
+	const int      packsize  = 32;
+	const int      sizeof_st = int (sizeof (typename SRC::PtrConst::DataType));
+	assert (src_str_arr [0] % sizeof_st == 0);
+	assert (src_str_arr [1] % sizeof_st == 0);
+	assert (src_str_arr [2] % sizeof_st == 0);
+
+	const __m512i  zero     = _mm512_setzero_si512 ();
+	const __m512i  mask_lsb = _mm512_set1_epi16 (0x00FF);
+	const __m512i  sign_bit = _mm512_set1_epi16 (-0x8000);
+	const __m512i  ma       = _mm512_set1_epi16 (int16_t ((1 << DB) - 1));
+
+	// The coefficients are stored as AVX2 vectors. Their content is the same
+	// in both 128-bit lanes, so we can just duplicate them.
+	const __m256i* coef_ptr = reinterpret_cast <const __m256i *> (
+		_coef_simd_arr.use_vect_avx2 (0)
+	);
+	__m512i        coef_arr [NBR_PLANES * MAT_SIZE];
+	for (int k = 0; k < NP * MAT_SIZE; ++k)
+	{
+		coef_arr [k] = _mm512_broadcast_i64x4 (_mm256_load_si256 (coef_ptr + k));
+	}
+
+	// Looping over lines then over planes helps keeping input data
+	// in the cache.
+	const int      w32 = w & -packsize;
+	const int      w31 = w - w32;
+	SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [0], src_str_arr [0], h);
+	SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [1], src_str_arr [1], h);
+	SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src_ptr_arr [2], src_str_arr [2], h);
+	const int      src_0_str = src_str_arr [0] / sizeof_st;
+	const int      src_1_str = src_str_arr [1] / sizeof_st;
+	const int      src_2_str = src_str_arr [2] / sizeof_st;
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int plane_index = 0; plane_index < NP; ++ plane_index)
+		{
+			DstPtr         dst_ptr (DST::Ptr::make_ptr (
+				dst_ptr_arr [plane_index] + y * dst_str_arr [plane_index],
+				dst_str_arr [plane_index],
+				h
+			));
+			const int      cind    = plane_index * MAT_SIZE;
+
+			for (int x = 0; x < w32; x += packsize)
+			{
+				const __m512i  s0 = SrcS16R::read (src_0_ptr, zero, sign_bit);
+				const __m512i  s1 = SrcS16R::read (src_1_ptr, zero, sign_bit);
+				const __m512i  s2 = SrcS16R::read (src_2_ptr, zero, sign_bit);
+
+				__m512i        d0 = coef_arr [cind + NBR_PLANES];
+				__m512i        d1 = d0;
+
+				// Same ranges and headroom as the SSE2 and AVX2 versions
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s0, coef_arr [cind + 0]);
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s1, coef_arr [cind + 1]);
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s2, coef_arr [cind + 2]);
+
+				d0 = _mm512_srai_epi32 (d0, SHIFT_INT + SB - DB);
+				d1 = _mm512_srai_epi32 (d1, SHIFT_INT + SB - DB);
+
+				const __m512i  val = _mm512_packs_epi32 (d0, d1);
+
+				DstS16W::write_clip (dst_ptr, val, mask_lsb, zero, ma, sign_bit);
+
+				SRC::PtrConst::jump (src_0_ptr, packsize);
+				SRC::PtrConst::jump (src_1_ptr, packsize);
+				SRC::PtrConst::jump (src_2_ptr, packsize);
+
+				DST::Ptr::jump (dst_ptr, packsize);
+			}
+
+			if (w31 > 0)
+			{
+				const __m512i  s0 = SrcS16R::read_partial (src_0_ptr, zero, sign_bit, w31);
+				const __m512i  s1 = SrcS16R::read_partial (src_1_ptr, zero, sign_bit, w31);
+				const __m512i  s2 = SrcS16R::read_partial (src_2_ptr, zero, sign_bit, w31);
+
+				__m512i        d0 = coef_arr [cind + NBR_PLANES];
+				__m512i        d1 = d0;
+
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s0, coef_arr [cind + 0]);
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s1, coef_arr [cind + 1]);
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s2, coef_arr [cind + 2]);
+
+				d0 = _mm512_srai_epi32 (d0, SHIFT_INT + SB - DB);
+				d1 = _mm512_srai_epi32 (d1, SHIFT_INT + SB - DB);
+
+				const __m512i  val = _mm512_packs_epi32 (d0, d1);
+
+				DstS16W::write_clip_partial (
+					dst_ptr, val, mask_lsb, zero, ma, sign_bit, w31
+				);
+			}
+
+			SRC::PtrConst::jump (src_0_ptr, -w32);
+			SRC::PtrConst::jump (src_1_ptr, -w32);
+			SRC::PtrConst::jump (src_2_ptr, -w32);
+		}
+
+		SRC::PtrConst::jump (src_0_ptr, src_0_str);
+		SRC::PtrConst::jump (src_1_ptr, src_1_str);
+		SRC::PtrConst::jump (src_2_ptr, src_2_str);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+// c0 * s0 + c1 * s1 + c2 * s2 + c3
+// The FMA version accumulates in a different order.
+template <bool FMA_FLAG>
+static fstb_FORCEINLINE __m512	MatrixProc_mac3_avx512 (__m512 s0, __m512 s1, __m512 s2, __m512 c0, __m512 c1, __m512 c2, __m512 c3)
+{
+	__m512         d;
+	if (FMA_FLAG)
+	{
+		d = _mm512_fmadd_ps (s0, c0, c3);
+		d = _mm512_fmadd_ps (s1, c1, d);
+		d = _mm512_fmadd_ps (s2, c2, d);
+	}
+	else
+	{
+		d = _mm512_add_ps (_mm512_add_ps (_mm512_add_ps (
+			_mm512_mul_ps (s0, c0),
+			_mm512_mul_ps (s1, c1)),
+			_mm512_mul_ps (s2, c2)),
+			                  c3);
+	}
+
+	return (d);
+}
+
+
+
+template <bool FMA_FLAG>
+void	MatrixProc::process_3_flt_avx512 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+	const int      sizeof_xt = int (sizeof (float));
+	assert (src_str_arr [0] % sizeof_xt == 0);
+	assert (src_str_arr [1] % sizeof_xt == 0);
+	assert (src_str_arr [2] % sizeof_xt == 0);
+	assert (dst_str_arr [0] % sizeof_xt == 0);
+	assert (dst_str_arr [1] % sizeof_xt == 0);
+	assert (dst_str_arr [2] % sizeof_xt == 0);
+
+	const float *  src_0_ptr = reinterpret_cast <const float *> (src_ptr_arr [0]);
+	const float *  src_1_ptr = reinterpret_cast <const float *> (src_ptr_arr [1]);
+	const float *  src_2_ptr = reinterpret_cast <const float *> (src_ptr_arr [2]);
+	const int      src_0_str = src_str_arr [0] / sizeof_xt;
+	const int      src_1_str = src_str_arr [1] / sizeof_xt;
+	const int      src_2_str = src_str_arr [2] / sizeof_xt;
+
+	float *        dst_0_ptr = reinterpret_cast <      float *> (dst_ptr_arr [0]);
+	float *        dst_1_ptr = reinterpret_cast <      float *> (dst_ptr_arr [1]);
+	float *        dst_2_ptr = reinterpret_cast <      float *> (dst_ptr_arr [2]);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_xt;
+	const int      dst_1_str = dst_str_arr [1] / sizeof_xt;
+	const int      dst_2_str = dst_str_arr [2] / sizeof_xt;
+
+	const __m512   c00 = _mm512_set1_ps (_coef_flt_arr [ 0]);
+	const __m512   c01 = _mm512_set1_ps (_coef_flt_arr [ 1]);
+	const __m512   c02 = _mm512_set1_ps (_coef_flt_arr [ 2]);
+	const __m512   c03 = _mm512_set1_ps (_coef_flt_arr [ 3]);
+	const __m512   c04 = _mm512_set1_ps (_coef_flt_arr [ 4]);
+	const __m512   c05 = _mm512_set1_ps (_coef_flt_arr [ 5]);
+	const __m512   c06 = _mm512_set1_ps (_coef_flt_arr [ 6]);
+	const __m512   c07 = _mm512_set1_ps (_coef_flt_arr [ 7]);
+	const __m512   c08 = _mm512_set1_ps (_coef_flt_arr [ 8]);
+	const __m512   c09 = _mm512_set1_ps (_coef_flt_arr [ 9]);
+	const __m512   c10 = _mm512_set1_ps (_coef_flt_arr [10]);
+	const __m512   c11 = _mm512_set1_ps (_coef_flt_arr [11]);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; x += 16)
+		{
+			const __mmask16   mask = fstb::ToolsAvx512::make_mask16 (
+				std::min (w - x, 16)
+			);
+
+			const __m512   s0 = _mm512_maskz_loadu_ps (mask, src_0_ptr + x);
+			const __m512   s1 = _mm512_maskz_loadu_ps (mask, src_1_ptr + x);
+			const __m512   s2 = _mm512_maskz_loadu_ps (mask, src_2_ptr + x);
+
+			const __m512   d0 = MatrixProc_mac3_avx512 <FMA_FLAG> (
+				s0, s1, s2, c00, c01, c02, c03
+			);
+			const __m512   d1 = MatrixProc_mac3_avx512 <FMA_FLAG> (
+				s0, s1, s2, c04, c05, c06, c07
+			);
+			const __m512   d2 = MatrixProc_mac3_avx512 <FMA_FLAG> (
+				s0, s1, s2, c08, c09, c10, c11
+			);
+
+			_mm512_mask_storeu_ps (dst_0_ptr + x, mask, d0);
+			_mm512_mask_storeu_ps (dst_1_ptr + x, mask, d1);
+			_mm512_mask_storeu_ps (dst_2_ptr + x, mask, d2);
+		}
+
+		src_0_ptr += src_0_str;
+		src_1_ptr += src_1_str;
+		src_2_ptr += src_2_str;
+
+		dst_0_ptr += dst_0_str;
+		dst_1_ptr += dst_1_str;
+		dst_2_ptr += dst_2_str;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <bool FMA_FLAG>
+void	MatrixProc::process_1_flt_avx512 (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (NBR_PLANES == 3, "Code is hardcoded for 3 planes");
+	const int      sizeof_xt = int (sizeof (float));
+	assert (src_str_arr [0] % sizeof_xt == 0);
+	assert (src_str_arr [1] % sizeof_xt == 0);
+	assert (src_str_arr [2] % sizeof_xt == 0);
+	assert (dst_str_arr [0] % sizeof_xt == 0);
+
+	const float *  src_0_ptr = reinterpret_cast <const float *> (src_ptr_arr [0]);
+	const float *  src_1_ptr = reinterpret_cast <const float *> (src_ptr_arr [1]);
+	const float *  src_2_ptr = reinterpret_cast <const float *> (src_ptr_arr [2]);
+	const int      src_0_str = src_str_arr [0] / sizeof_xt;
+	const int      src_1_str = src_str_arr [1] / sizeof_xt;
+	const int      src_2_str = src_str_arr [2] / sizeof_xt;
+
+	float *        dst_0_ptr = reinterpret_cast <      float *> (dst_ptr_arr [0]);
+	const int      dst_0_str = dst_str_arr [0] / sizeof_xt;
+
+	const __m512   c00 = _mm512_set1_ps (_coef_flt_arr [ 0]);
+	const __m512   c01 = _mm512_set1_ps (_coef_flt_arr [ 1]);
+	const __m512   c02 = _mm512_set1_ps (_coef_flt_arr [ 2]);
+	const __m512   c03 = _mm512_set1_ps (_coef_flt_arr [ 3]);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; x += 16)
+		{
+			const __mmask16   mask = fstb::ToolsAvx512::make_mask16 (
+				std::min (w - x, 16)
+			);
+
+			const __m512   s0 = _mm512_maskz_loadu_ps (mask, src_0_ptr + x);
+			const __m512   s1 = _mm512_maskz_loadu_ps (mask, src_1_ptr + x);
+			const __m512   s2 = _mm512_maskz_loadu_ps (mask, src_2_ptr + x);
+
+			const __m512   d0 = MatrixProc_mac3_avx512 <FMA_FLAG> (
+				s0, s1, s2, c00, c01, c02, c03
+			);
+
+			_mm512_mask_storeu_ps (dst_0_ptr + x, mask, d0);
+		}
+
+		src_0_ptr += src_0_str;
+		src_1_ptr += src_1_str;
+		src_2_ptr += src_2_str;
+
+		dst_0_ptr += dst_0_str;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,194 @@
+/*****************************************************************************
+
+        ProxyRwAvx512.h
+        Author: agent, 2026
+
+Requires AVX-512F and AVX-512BW. Each access covers 32 pixels: two float
+vectors or one vector of 16-bit integers. The pixels are kept in order in
+the 16-bit vectors, and the partial accesses use mask registers.
+
+Only the formats and functions used by the AVX-512 code are implemented.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_ProxyRwAvx512_HEADER_INCLUDED)
+#define	fmtcl_ProxyRwAvx512_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fmtcl/Proxy.h"
+#include "fmtcl/SplFmt.h"
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+
+
+namespace fmtcl
+{
+
+
+
+template <SplFmt PT> class ProxyRwAvx512 {};
+
+
+
+template <>
+class ProxyRwAvx512 <SplFmt_FLOAT>
+{
+public:
+	typedef	Proxy::PtrFloat          Ptr;
+	typedef	Proxy::PtrFloatConst     PtrConst;
+	enum {         ALIGN_R =  4 };
+	enum {         ALIGN_W = 16 };
+	enum {         OFFSET  = 0  };
+	static fstb_FORCEINLINE void
+	               read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &zero);
+	static fstb_FORCEINLINE void
+	               read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &zero, int len);
+	static fstb_FORCEINLINE void
+	               write_flt (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &mask_lsb, const __m512i &sign_bit, const __m512 &offset);
+	static fstb_FORCEINLINE void
+	               write_flt_partial (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &mask_lsb, const __m512i &sign_bit, const __m512 &offset, int len);
+};
+
+template <>
+class ProxyRwAvx512 <SplFmt_INT8>
+{
+public:
+	typedef	Proxy::PtrInt8           Ptr;
+	typedef	Proxy::PtrInt8Const      PtrConst;
+	enum {         ALIGN_R =  1 };
+	enum {         ALIGN_W =  1 };
+	enum {         OFFSET  = -32768 };
+	static fstb_FORCEINLINE void
+	               read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/);
+	static fstb_FORCEINLINE void
+	               read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len);
+
+	template <bool CLIP_FLAG, bool SIGN_FLAG>
+	class S16
+	{
+	public:
+		static fstb_FORCEINLINE __m512i
+		               read (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &/*sign_bit*/);
+		static fstb_FORCEINLINE __m512i
+		               read_partial (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &/*sign_bit*/, int len);
+		static fstb_FORCEINLINE void
+		               write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit);
+		static fstb_FORCEINLINE void
+		               write_clip_partial (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, int len);
+	};
+private:
+	static fstb_FORCEINLINE void
+	               finish_read_flt (__m512 &src0, __m512 &src1, const __m256i &src256);
+};
+
+template <>
+class ProxyRwAvx512 <SplFmt_INT16>
+{
+public:
+	typedef	Proxy::PtrInt16          Ptr;
+	typedef	Proxy::PtrInt16Const     PtrConst;
+	enum {         ALIGN_R =  2 };
+	enum {         ALIGN_W =  2 };
+	enum {         OFFSET  = -32768 };
+	static fstb_FORCEINLINE void
+	               read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/);
+	static fstb_FORCEINLINE void
+	               read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len);
+	static fstb_FORCEINLINE void
+	               write_flt (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset);
+	static fstb_FORCEINLINE void
+	               write_flt_partial (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset, int len);
+
+	static fstb_FORCEINLINE void
+	               finish_read_flt (__m512 &src0, __m512 &src1, const __m512i &src);
+	static fstb_FORCEINLINE __m512i
+	               prepare_write_flt (const __m512 &src0, const __m512 &src1, const __m512i &sign_bit, const __m512 &offset);
+
+	template <bool CLIP_FLAG, bool SIGN_FLAG>
+	class S16
+	{
+	public:
+		static fstb_FORCEINLINE __m512i
+		               read (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit);
+		static fstb_FORCEINLINE __m512i
+		               read_partial (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit, int len);
+		static fstb_FORCEINLINE void
+		               write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit);
+		static fstb_FORCEINLINE void
+		               write_clip_partial (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, int len);
+
+		static fstb_FORCEINLINE __m512i
+		               prepare_write_clip (const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit);
+	};
+};
+
+template <>
+class ProxyRwAvx512 <SplFmt_STACK16>
+{
+public:
+	typedef	Proxy::PtrStack16        Ptr;
+	typedef	Proxy::PtrStack16Const   PtrConst;
+	enum {         ALIGN_R =  1 };
+	enum {         ALIGN_W =  1 };
+	enum {         OFFSET  = -32768 };
+	static fstb_FORCEINLINE void
+	               read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/);
+	static fstb_FORCEINLINE void
+	               read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len);
+	static fstb_FORCEINLINE void
+	               write_flt (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset);
+	static fstb_FORCEINLINE void
+	               write_flt_partial (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset, int len);
+
+	template <bool CLIP_FLAG, bool SIGN_FLAG>
+	class S16
+	{
+	public:
+		static fstb_FORCEINLINE __m512i
+		               read (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit);
+		static fstb_FORCEINLINE __m512i
+		               read_partial (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit, int len);
+		static fstb_FORCEINLINE void
+		               write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit);
+		static fstb_FORCEINLINE void
+		               write_clip_partial (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, int len);
+	};
+};
+
+
+
+}	// namespace fmtcl
+
+
+
+#include "fmtcl/ProxyRwAvx512.hpp"
+
+
+
+#endif	// fmtcl_ProxyRwAvx512_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
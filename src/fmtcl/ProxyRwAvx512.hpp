@@ -0,0 +1,353 @@
+/*****************************************************************************
+
+        ProxyRwAvx512.hpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_ProxyRwAvx512_CODEHEADER_INCLUDED)
+#define	fmtcl_ProxyRwAvx512_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/ToolsAvx512.h"
+
+#include <algorithm>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	ProxyRwAvx512 <SplFmt_FLOAT>::read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/)
+{
+	src0 = _mm512_loadu_ps (ptr     );
+	src1 = _mm512_loadu_ps (ptr + 16);
+}
+
+void	ProxyRwAvx512 <SplFmt_FLOAT>::read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len)
+{
+	const __mmask16   m0 = fstb::ToolsAvx512::make_mask16 (std::min (len     , 16));
+	const __mmask16   m1 = fstb::ToolsAvx512::make_mask16 (std::max (len - 16,  0));
+	src0 = _mm512_maskz_loadu_ps (m0, ptr     );
+	src1 = _mm512_maskz_loadu_ps (m1, ptr + 16);
+}
+
+void	ProxyRwAvx512 <SplFmt_FLOAT>::write_flt (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &/*sign_bit*/, const __m512 &/*offset*/)
+{
+	_mm512_storeu_ps (ptr     , src0);
+	_mm512_storeu_ps (ptr + 16, src1);
+}
+
+void	ProxyRwAvx512 <SplFmt_FLOAT>::write_flt_partial (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &/*sign_bit*/, const __m512 &/*offset*/, int len)
+{
+	const __mmask16   m0 = fstb::ToolsAvx512::make_mask16 (std::min (len     , 16));
+	const __mmask16   m1 = fstb::ToolsAvx512::make_mask16 (std::max (len - 16,  0));
+	_mm512_mask_storeu_ps (ptr     , m0, src0);
+	_mm512_mask_storeu_ps (ptr + 16, m1, src1);
+}
+
+
+
+void	ProxyRwAvx512 <SplFmt_INT8>::read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/)
+{
+	const __m256i  src256 =
+		_mm256_loadu_si256 (reinterpret_cast <const __m256i *> (ptr));
+	finish_read_flt (src0, src1, src256);
+}
+
+void	ProxyRwAvx512 <SplFmt_INT8>::read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len)
+{
+	const __m256i  src256 = _mm512_castsi512_si256 (_mm512_maskz_loadu_epi8 (
+		fstb::ToolsAvx512::make_mask64 (len), ptr
+	));
+	finish_read_flt (src0, src1, src256);
+}
+
+void	ProxyRwAvx512 <SplFmt_INT8>::finish_read_flt (__m512 &src0, __m512 &src1, const __m256i &src256)
+{
+	const __m512i  src_0015 =
+		_mm512_cvtepu8_epi32 (_mm256_castsi256_si128 (src256));
+	const __m512i  src_1631 =
+		_mm512_cvtepu8_epi32 (_mm256_extracti128_si256 (src256, 1));
+	src0 = _mm512_cvtepi32_ps (src_0015);
+	src1 = _mm512_cvtepi32_ps (src_1631);
+}
+
+
+
+// Sign is ignored here
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT8>::S16 <CLIP_FLAG, SIGN_FLAG>::read (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &/*sign_bit*/)
+{
+	return (fstb::ToolsAvx512::load_32_16l (ptr));
+}
+
+// Sign is ignored here
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT8>::S16 <CLIP_FLAG, SIGN_FLAG>::read_partial (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &/*sign_bit*/, int len)
+{
+	return (fstb::ToolsAvx512::load_32_16l_partial (ptr, len));
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_INT8>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit)
+{
+	const __m512i  val =
+		ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (
+			src, mi, ma, sign_bit
+		);
+	fstb::ToolsAvx512::store_32_16l (ptr, val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_INT8>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip_partial (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, int len)
+{
+	const __m512i  val =
+		ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (
+			src, mi, ma, sign_bit
+		);
+	fstb::ToolsAvx512::store_32_16l_partial (ptr, val, len);
+}
+
+
+
+void	ProxyRwAvx512 <SplFmt_INT16>::read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/)
+{
+	const __m512i  src = _mm512_loadu_si512 (ptr);
+	finish_read_flt (src0, src1, src);
+}
+
+void	ProxyRwAvx512 <SplFmt_INT16>::read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len)
+{
+	const __m512i  src = _mm512_maskz_loadu_epi16 (
+		fstb::ToolsAvx512::make_mask32 (len), ptr
+	);
+	finish_read_flt (src0, src1, src);
+}
+
+//	const __m512i	sign_bit = _mm512_set1_epi16 (-0x8000);
+//	const __m512	offset   = _mm512_set1_ps (-32768);
+void	ProxyRwAvx512 <SplFmt_INT16>::write_flt (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset)
+{
+	const __m512i  val = prepare_write_flt (src0, src1, sign_bit, offset);
+	_mm512_storeu_si512 (ptr, val);
+}
+
+void	ProxyRwAvx512 <SplFmt_INT16>::write_flt_partial (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset, int len)
+{
+	const __m512i  val = prepare_write_flt (src0, src1, sign_bit, offset);
+	_mm512_mask_storeu_epi16 (ptr, fstb::ToolsAvx512::make_mask32 (len), val);
+}
+
+void	ProxyRwAvx512 <SplFmt_INT16>::finish_read_flt (__m512 &src0, __m512 &src1, const __m512i &src)
+{
+	const __m512i  src_0015 =
+		_mm512_cvtepu16_epi32 (_mm512_castsi512_si256 (src));
+	const __m512i  src_1631 =
+		_mm512_cvtepu16_epi32 (_mm512_extracti64x4_epi64 (src, 1));
+	src0 = _mm512_cvtepi32_ps (src_0015);
+	src1 = _mm512_cvtepi32_ps (src_1631);
+}
+
+// Same saturation as _mm512_packs_epi32, but without lane interleaving.
+__m512i	ProxyRwAvx512 <SplFmt_INT16>::prepare_write_flt (const __m512 &src0, const __m512 &src1, const __m512i &sign_bit, const __m512 &offset)
+{
+	const __m512   val_0015_f = _mm512_add_ps (src0, offset);
+	const __m512   val_1631_f = _mm512_add_ps (src1, offset);
+
+	const __m512i  val_0015   = _mm512_cvtps_epi32 (val_0015_f);
+	const __m512i  val_1631   = _mm512_cvtps_epi32 (val_1631_f);
+
+	__m512i        val        = _mm512_inserti64x4 (
+		_mm512_castsi256_si512 (_mm512_cvtsepi32_epi16 (val_0015)),
+		_mm512_cvtsepi32_epi16 (val_1631),
+		1
+	);
+	val = _mm512_xor_si512 (val, sign_bit);
+
+	return (val);
+}
+
+
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::read (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit)
+{
+	__m512i        val = _mm512_loadu_si512 (ptr);
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::read_partial (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit, int len)
+{
+	__m512i        val = _mm512_maskz_loadu_epi16 (
+		fstb::ToolsAvx512::make_mask32 (len), ptr
+	);
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit)
+{
+	const __m512i  val = prepare_write_clip (src, mi, ma, sign_bit);
+	_mm512_storeu_si512 (ptr, val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip_partial (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, int len)
+{
+	const __m512i  val = prepare_write_clip (src, mi, ma, sign_bit);
+	_mm512_mask_storeu_epi16 (ptr, fstb::ToolsAvx512::make_mask32 (len), val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit)
+{
+	__m512i        val = src;
+	if (CLIP_FLAG)
+	{
+		val = _mm512_min_epi16 (val, ma);
+		val = _mm512_max_epi16 (val, mi);
+	}
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+
+
+void	ProxyRwAvx512 <SplFmt_STACK16>::read_flt (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/)
+{
+	const __m512i  src =
+		fstb::ToolsAvx512::load_32_16ml (ptr._msb_ptr, ptr._lsb_ptr);
+	ProxyRwAvx512 <SplFmt_INT16>::finish_read_flt (src0, src1, src);
+}
+
+void	ProxyRwAvx512 <SplFmt_STACK16>::read_flt_partial (const PtrConst::Type &ptr, __m512 &src0, __m512 &src1, const __m512i &/*zero*/, int len)
+{
+	const __m512i  src = fstb::ToolsAvx512::load_32_16ml_partial (
+		ptr._msb_ptr, ptr._lsb_ptr, len
+	);
+	ProxyRwAvx512 <SplFmt_INT16>::finish_read_flt (src0, src1, src);
+}
+
+void	ProxyRwAvx512 <SplFmt_STACK16>::write_flt (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset)
+{
+	const __m512i  val = ProxyRwAvx512 <SplFmt_INT16>::prepare_write_flt (
+		src0, src1, sign_bit, offset
+	);
+	fstb::ToolsAvx512::store_32_16ml (ptr._msb_ptr, ptr._lsb_ptr, val);
+}
+
+void	ProxyRwAvx512 <SplFmt_STACK16>::write_flt_partial (const Ptr::Type &ptr, const __m512 &src0, const __m512 &src1, const __m512i &/*mask_lsb*/, const __m512i &sign_bit, const __m512 &offset, int len)
+{
+	const __m512i  val = ProxyRwAvx512 <SplFmt_INT16>::prepare_write_flt (
+		src0, src1, sign_bit, offset
+	);
+	fstb::ToolsAvx512::store_32_16ml_partial (
+		ptr._msb_ptr, ptr._lsb_ptr, val, len
+	);
+}
+
+
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_STACK16>::S16 <CLIP_FLAG, SIGN_FLAG>::read (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit)
+{
+	__m512i        val =
+		fstb::ToolsAvx512::load_32_16ml (ptr._msb_ptr, ptr._lsb_ptr);
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_STACK16>::S16 <CLIP_FLAG, SIGN_FLAG>::read_partial (const PtrConst::Type &ptr, const __m512i &/*zero*/, const __m512i &sign_bit, int len)
+{
+	__m512i        val = fstb::ToolsAvx512::load_32_16ml_partial (
+		ptr._msb_ptr, ptr._lsb_ptr, len
+	);
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_STACK16>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit)
+{
+	const __m512i  val =
+		ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (
+			src, mi, ma, sign_bit
+		);
+	fstb::ToolsAvx512::store_32_16ml (ptr._msb_ptr, ptr._lsb_ptr, val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_STACK16>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip_partial (const Ptr::Type &ptr, const __m512i &src, const __m512i &/*mask_lsb*/, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, int len)
+{
+	const __m512i  val =
+		ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (
+			src, mi, ma, sign_bit
+		);
+	fstb::ToolsAvx512::store_32_16ml_partial (
+		ptr._msb_ptr, ptr._lsb_ptr, val, len
+	);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fmtcl
+
+
+
+#endif	// fmtcl_ProxyRwAvx512_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
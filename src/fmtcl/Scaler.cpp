@@ -41,9 +41,11 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #endif   // fstb_ARCHI_X86
 
 #include <algorithm>
+#include <map>
 
 #include <cassert>
 #include <climits>
+#include <cstring>
 
 
 
@@ -89,6 +91,8 @@ Integer path (SSE2):
 	them signed, lower bitdepth data remain unsigned.
 - Convolution products are done in 32 bits signed with signed input at its
 	natural depth and coefficients scaled to 12 bits (SHIFT_INT)
+- The AVX2 and AVX-512 versions process the taps by pairs with madd_epi16
+	and the interleaved coefficients of CoefArrInt. Results are identical.
 - The convolution is summed to _add_cst_int, then scaled down from
 	SHIFT_INT + the in/out bitdepth difference.
 - 16-bit data have their 15th bit flipped back to make them unsigned by the
@@ -96,7 +100,7 @@ Integer path (SSE2):
 	logical limits.
 */
 
-Scaler::Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag)
+Scaler::Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag, bool fma_flag)
 :	_src_height (src_height)
 ,	_dst_height (dst_height)
 ,	_win_top (win_top)
@@ -121,6 +125,13 @@ Scaler::Scaler (int src_height, int dst_height, double win_top, double win_heigh
 ,	_kernel_info_arr (dst_height)
 ,	_coef_flt_arr ()
 ,	_coef_int_arr ()
+,	_hori_tile_w (0)
+,	_hori_tile_arr ()
+,	_hori_grp_arr ()
+,	_hori_idx_arr ()
+,	_hori_coef_arr ()
+,	_hori_mask_arr ()
+,	_process_hori_flt_ptr (0)
 fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_CPP)
 fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_CPP)
 {
@@ -139,7 +150,12 @@ fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_CPP)
 		if (avx2_flag)
 		{
 			_coef_int_arr.set_avx2_mode (true);
-			setup_avx2 ();
+			setup_avx2 (fma_flag);
+
+			if (avx512_flag)
+			{
+				setup_avx512 (fma_flag);
+			}
 		}
 	}
 #endif
@@ -188,6 +204,49 @@ int	Scaler::get_fir_len () const
 
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+// Builds the tables for the horizontal processing. The destination is
+// split in tiles of tile_w pixels, the last one being possibly narrower.
+// The same grid must be used when calling process_plane_hori().
+void	Scaler::prepare_hori (int tile_w)
+{
+	assert (tile_w > 0);
+	assert (tile_w >= _dst_height || (tile_w % HORI_VECT_LEN) == 0);
+
+	_hori_tile_w = tile_w;
+	_hori_tile_arr.clear ();
+	_hori_grp_arr.clear ();
+	_hori_idx_arr.clear ();
+	_hori_coef_arr.clear ();
+	_hori_mask_arr.clear ();
+
+	for (int x_dst_beg = 0; x_dst_beg < _dst_height; x_dst_beg += tile_w)
+	{
+		const int      x_dst_end = std::min (x_dst_beg + tile_w, _dst_height);
+
+		HoriTile       tile;
+		int            x_src_end = 0;
+		get_src_boundaries (tile._src_beg, x_src_end, x_dst_beg, x_dst_end);
+		tile._src_len   = x_src_end - tile._src_beg;
+		tile._grp_beg   = int (_hori_grp_arr.size ());
+
+		for (int x = x_dst_beg; x < x_dst_end; x += HORI_VECT_LEN)
+		{
+			build_hori_group (
+				tile, x, std::min (x + HORI_VECT_LEN, x_dst_end)
+			);
+		}
+
+		tile._grp_end   = int (_hori_grp_arr.size ());
+		_hori_tile_arr.push_back (tile);
+	}
+}
+
+#endif   // fstb_ARCHI_X86
+
+
+
 // src_ptr is the top-left corner of the full source frame
 // dst_ptr is the top-left corner of the destination tile
 #define fmtcl_Scaler_DEFINE_F(DT, ST, DE, SE, FN) \
@@ -311,6 +370,24 @@ int	Scaler::eval_lower_bound_of_src_tile_height (int tile_height_dst, int dst_he
 
 
 
+// Same as get_fir_len(), without building the scaler.
+int	Scaler::eval_fir_len (int src_height, int dst_height, double win_height, ContFirInterface &kernel_fnc, double kernel_scale)
+{
+	assert (src_height > 0);
+	assert (dst_height > 0);
+	assert (win_height > 0);
+	assert (kernel_scale > 0);
+
+	const BasicInfo   bi (
+		src_height, dst_height, 0, win_height,
+		kernel_fnc, kernel_scale, 0, 0
+	);
+
+	return (bi._fir_len);
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -465,15 +542,18 @@ void	Scaler::process_plane_int_cpp (typename DST::Ptr::Type dst_ptr, typename SR
 
 
 
-template <class SRC, bool PF>
+// NT: number of taps known at compile time, or 0 to use kernel_size
+template <class SRC, bool PF, int NT>
 static fstb_FORCEINLINE void	Scaler_process_vect_flt_sse2 (__m128 &sum0, __m128 &sum1, int kernel_size, const float *coef_base_ptr, typename SRC::PtrConst::Type pix_ptr, const __m128i &zero, int src_stride, const __m128 &add_cst, int len)
 {
+	const int      nbr_taps = (NT > 0) ? NT : kernel_size;
+
 	// Possible optimization: initialize the sum with DST::OFFSET + _add_cst_flt
 	// and save the add in the write proxy.
 	sum0 = add_cst;
 	sum1 = add_cst;
 
-	for (int k = 0; k < kernel_size; ++k)
+	for (int k = 0; k < nbr_taps; ++k)
 	{
 		__m128         coef = _mm_load_ss (coef_base_ptr + k);
 		coef = _mm_shuffle_ps (coef, coef, 0);
@@ -491,6 +571,52 @@ static fstb_FORCEINLINE void	Scaler_process_vect_flt_sse2 (__m128 &sum0, __m128
 
 
 
+template <class DST, class SRC, int NT>
+static void	Scaler_process_line_flt_sse2 (typename DST::Ptr::Type col_dst_ptr, typename SRC::PtrConst::Type col_src_ptr, int src_stride, int width, int kernel_size, const float *coef_base_ptr, const __m128 &add_cst)
+{
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128   offset   = _mm_set1_ps (float (DST::OFFSET));
+
+	const int      w8 = width & -8;
+	const int      w7 = width - w8;
+
+	__m128         sum0;
+	__m128         sum1;
+
+	for (int x = 0; x < w8; x += 8)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		Scaler_process_vect_flt_sse2 <SRC, false, NT> (
+			sum0, sum1, kernel_size, coef_base_ptr,
+			pix_ptr, zero, src_stride, add_cst, 0
+		);
+		DST::write_flt (
+			col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset
+		);
+
+		DST::Ptr::jump (col_dst_ptr, 8);
+		SRC::PtrConst::jump (col_src_ptr, 8);
+	}
+
+	if (w7 > 0)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		Scaler_process_vect_flt_sse2 <SRC, true, NT> (
+			sum0, sum1, kernel_size, coef_base_ptr,
+			pix_ptr, zero, src_stride, add_cst, w7
+		);
+		DST::write_flt_partial (
+			col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset, w7
+		);
+	}
+}
+
+
+
 // DST and SRC are ProxyRwSse2 classes
 // Stride offsets in pixels
 // Source pointer may be unaligned.
@@ -516,15 +642,8 @@ void	Scaler::process_plane_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 	assert (width <= dst_stride);
 	assert (width <= src_stride);
 
-	const __m128i  zero     = _mm_setzero_si128 ();
-	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
-	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
-	const __m128   offset   = _mm_set1_ps (float (DST::OFFSET));
 	const __m128   add_cst  = _mm_set1_ps (float (_add_cst_flt));
 
-	const int      w8 = width & -8;
-	const int      w7 = width - w8;
-
 	for (int y = y_dst_beg; y < y_dst_end; ++y)
 	{
 		const KernelInfo& kernel_info   = _kernel_info_arr [y];
@@ -545,36 +664,26 @@ void	Scaler::process_plane_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 
 		else
 		{
-			__m128         sum0;
-			__m128         sum1;
-
-			for (int x = 0; x < w8; x += 8)
+			switch (kernel_size)
 			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+#define fmtcl_Scaler_CASE_NT(NT) \
+			case NT: \
+				Scaler_process_line_flt_sse2 <DST, SRC, NT> ( \
+					col_dst_ptr, col_src_ptr, src_stride, width, \
+					kernel_size, coef_base_ptr, add_cst \
+				); \
+				break;
 
-				Scaler_process_vect_flt_sse2 <SRC, false> (
-					sum0, sum1, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, add_cst, 0
-				);
-				DST::write_flt (
-					col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset
-				);
+			fmtcl_Scaler_SPAN_NT (fmtcl_Scaler_CASE_NT)
 
-				DST::Ptr::jump (col_dst_ptr, 8);
-				SRC::PtrConst::jump (col_src_ptr, 8);
-			}
+#undef fmtcl_Scaler_CASE_NT
 
-			if (w7 > 0)
-			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
-
-				Scaler_process_vect_flt_sse2 <SRC, true> (
-					sum0, sum1, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, add_cst, w7
-				);
-				DST::write_flt_partial (
-					col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset, w7
+			default:
+				Scaler_process_line_flt_sse2 <DST, SRC, 0> (
+					col_dst_ptr, col_src_ptr, src_stride, width,
+					kernel_size, coef_base_ptr, add_cst
 				);
+				break;
 			}
 		}
 
@@ -584,18 +693,21 @@ void	Scaler::process_plane_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 
 
 
-template <class DST, int DB, class SRC, int SB, bool PF>
+// NT: number of taps known at compile time, or 0 to use kernel_size
+template <class DST, int DB, class SRC, int SB, bool PF, int NT>
 static fstb_FORCEINLINE __m128i	Scaler_process_vect_int_sse2 (const __m128i &add_cst, int kernel_size, const __m128i coef_base_ptr [], typename SRC::PtrConst::Type pix_ptr, const __m128i &zero, int src_stride, const __m128i &sign_bit, int len)
 {
 	typedef typename SRC::template S16 <false, (SB == 16)> SrcS16R;
 
+	const int      nbr_taps = (NT > 0) ? NT : kernel_size;
+
 #if defined (fmtcl_Scaler_SSE2_16BITS)
 
 	static_assert ((DB >= SB), "Output bitdepth must be greater or equal to input.");
 
 	__m128i        val = add_cst;
 
-	for (int k = 0; k < kernel_size; ++k)
+	for (int k = 0; k < nbr_taps; ++k)
 	{
 		__m128i        coef = _mm_load_si128 (coef_base_ptr + k);
 		__m128i        src  = ReadWrapperInt <SRC, SrcS16R, PF>::read (
@@ -631,7 +743,7 @@ static fstb_FORCEINLINE __m128i	Scaler_process_vect_int_sse2 (const __m128i &add
 	__m128i        sum0 = add_cst;
 	__m128i        sum1 = add_cst;
 
-	for (int k = 0; k < kernel_size; ++k)
+	for (int k = 0; k < nbr_taps; ++k)
 	{
 		const __m128i  coef = _mm_load_si128 (coef_base_ptr + k);
 		const __m128i  src  = ReadWrapperInt <SRC, SrcS16R, PF>::read (
@@ -654,6 +766,68 @@ static fstb_FORCEINLINE __m128i	Scaler_process_vect_int_sse2 (const __m128i &add
 
 
 
+template <class DST, int DB, class SRC, int SB, int NT>
+static void	Scaler_process_line_int_sse2 (typename DST::Ptr::Type col_dst_ptr, typename SRC::PtrConst::Type col_src_ptr, int src_stride, int width, int kernel_size, const __m128i coef_base_ptr [], const __m128i &add_cst)
+{
+	typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
+
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128i  ma       = _mm_set1_epi16 (int16_t ((1 << DB) - 1));
+
+	const int      w8 = width & -8;
+	const int      w7 = width - w8;
+
+	for (int x = 0; x < w8; x += 8)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		const __m128i  val = Scaler_process_vect_int_sse2 <
+			DST, DB, SRC, SB, false, NT
+		> (
+			add_cst, kernel_size, coef_base_ptr,
+			pix_ptr, zero, src_stride, sign_bit, 0
+		);
+
+		DstS16W::write_clip (
+			col_dst_ptr,
+			val,
+			mask_lsb,
+			zero,
+			ma,
+			sign_bit
+		);
+
+		DST::Ptr::jump (col_dst_ptr, 8);
+		SRC::PtrConst::jump (col_src_ptr, 8);
+	}
+
+	if (w7 > 0)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		const __m128i  val = Scaler_process_vect_int_sse2 <
+			DST, DB, SRC, SB, true, NT
+		> (
+			add_cst, kernel_size, coef_base_ptr,
+			pix_ptr, zero, src_stride, sign_bit, w7
+		);
+
+		DstS16W::write_clip_partial (
+			col_dst_ptr,
+			val,
+			mask_lsb,
+			zero,
+			ma,
+			sign_bit,
+			w7
+		);
+	}
+}
+
+
+
 template <class DST, int DB, class SRC, int SB>
 void	Scaler::process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const
 {
@@ -685,19 +859,12 @@ void	Scaler::process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 #endif
 	const int      s_cst    = s_in + s_out;
 
-	const __m128i  zero     = _mm_setzero_si128 ();
-	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
-	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
-	const __m128i  ma       = _mm_set1_epi16 (int16_t ((1 << DB) - 1));
 #if defined (fmtcl_Scaler_SSE2_16BITS)
 	const __m128i  add_cst  = _mm_set1_epi16 (_add_cst_int + s_cst        );
 #else
 	const __m128i  add_cst  = _mm_set1_epi32 (_add_cst_int + s_cst + r_cst);
 #endif
 
-	const int      w8 = width & -8;
-	const int      w7 = width - w8;
-
 	for (int y = y_dst_beg; y < y_dst_end; ++y)
 	{
 		const KernelInfo&    kernel_info   = _kernel_info_arr [y];
@@ -720,57 +887,159 @@ void	Scaler::process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 
 		else
 		{
-			typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
-
-			for (int x = 0; x < w8; x += 8)
+			switch (kernel_size)
 			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+#define fmtcl_Scaler_CASE_NT(NT) \
+			case NT: \
+				Scaler_process_line_int_sse2 <DST, DB, SRC, SB, NT> ( \
+					col_dst_ptr, col_src_ptr, src_stride, width, \
+					kernel_size, coef_base_ptr, add_cst \
+				); \
+				break;
 
-				const __m128i  val = Scaler_process_vect_int_sse2 <
-					DST, DB, SRC, SB, false
-				> (
-					add_cst, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, sign_bit, 0
-				);
+			fmtcl_Scaler_SPAN_NT (fmtcl_Scaler_CASE_NT)
 
-				DstS16W::write_clip (
-					col_dst_ptr,
-					val,
-					mask_lsb,
-					zero,
-					ma,
-					sign_bit
-				);
+#undef fmtcl_Scaler_CASE_NT
 
-				DST::Ptr::jump (col_dst_ptr, 8);
-				SRC::PtrConst::jump (col_src_ptr, 8);
+			default:
+				Scaler_process_line_int_sse2 <DST, DB, SRC, SB, 0> (
+					col_dst_ptr, col_src_ptr, src_stride, width,
+					kernel_size, coef_base_ptr, add_cst
+				);
+				break;
 			}
+		}
+
+		DST::Ptr::jump (dst_ptr, dst_stride);
+	}
+}
 
-			if (w7 > 0)
-			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
 
-				const __m128i  val = Scaler_process_vect_int_sse2 <
-					DST, DB, SRC, SB, true
-				> (
-					add_cst, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, sign_bit, w7
-				);
 
-				DstS16W::write_clip_partial (
-					col_dst_ptr,
-					val,
-					mask_lsb,
-					zero,
-					ma,
-					sign_bit,
-					w7
+// Appends a group of destination pixels to the horizontal processing tables.
+// When the kernel positions in the group are close enough, the taps are
+// picked with permutations from a window sliding along the source row by one
+// pixel per tap: the index table holds the position of each kernel relative
+// to the window. Otherwise the index table holds the positions of the pixels
+// to gather, for each tap.
+// Shorter kernels are padded with null coefficients. Padding lanes at the
+// end of the tile repeat the last valid kernel with null coefficients.
+// When the kernel sizes differ or when some lines are copied, masks give the
+// taps to accumulate and the lanes to copy, so the padding taps do not
+// contribute, even with Inf or NaN sources, and the copied lines are exact
+// copies, like in the vertical path.
+void	Scaler::build_hori_group (const HoriTile &tile, int x_dst_beg, int x_dst_end)
+{
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end - x_dst_beg <= HORI_VECT_LEN);
+	assert (x_dst_end <= _dst_height);
+
+	const int      nbr_lanes = x_dst_end - x_dst_beg;
+
+	HoriGroup      grp;
+	grp._idx_index  = int (_hori_idx_arr.size ()) / HORI_VECT_LEN;
+	grp._coef_index = int (_hori_coef_arr.size ()) / HORI_VECT_LEN;
+	grp._mask_index = -1;
+	grp._nbr_taps   = 0;
+	grp._win_len    = 0;
+	grp._win_pos    = 0;
+
+	int            pos_min = INT_MAX;
+	int            pos_max = INT_MIN;
+	for (int lane = 0; lane < nbr_lanes; ++lane)
+	{
+		const KernelInfo &   info = _kernel_info_arr [x_dst_beg + lane];
+		const int      pos = info._start_line - tile._src_beg;
+		assert (pos >= 0);
+		assert (pos + info._kernel_size <= tile._src_len);
+		pos_min = std::min (pos_min, pos);
+		pos_max = std::max (pos_max, pos);
+		grp._nbr_taps = std::max (grp._nbr_taps, info._kernel_size);
+	}
+
+	// Finds the shortest window fitting in the tile
+	for (int win_len = HORI_VECT_LEN
+	;	win_len <= HORI_WIN_LEN && grp._win_len == 0
+	;	win_len += HORI_VECT_LEN)
+	{
+		const int      win_pos = std::min (
+			pos_min, tile._src_len - (grp._nbr_taps - 1) - win_len
+		);
+		if (win_pos >= 0 && pos_max - win_pos < win_len)
+		{
+			grp._win_len = win_len;
+			grp._win_pos = win_pos;
+		}
+	}
+
+	// Positions
+	const int      nbr_idx_vect = (grp._win_len > 0) ? 1 : grp._nbr_taps;
+	for (int k = 0; k < nbr_idx_vect; ++k)
+	{
+		for (int lane = 0; lane < HORI_VECT_LEN; ++lane)
+		{
+			const int      lane_src = std::min (lane, nbr_lanes - 1);
+			const KernelInfo &   info = _kernel_info_arr [x_dst_beg + lane_src];
+			const int      pos = info._start_line - tile._src_beg;
+			if (grp._win_len > 0)
+			{
+				_hori_idx_arr.push_back (pos - grp._win_pos);
+			}
+			else
+			{
+				_hori_idx_arr.push_back (
+					pos + std::min (k, info._kernel_size - 1)
 				);
 			}
 		}
+	}
 
-		DST::Ptr::jump (dst_ptr, dst_stride);
+	// Coefficients
+	for (int k = 0; k < grp._nbr_taps; ++k)
+	{
+		for (int lane = 0; lane < HORI_VECT_LEN; ++lane)
+		{
+			const int      lane_src = std::min (lane, nbr_lanes - 1);
+			const KernelInfo &   info = _kernel_info_arr [x_dst_beg + lane_src];
+			float          coef = 0;
+			if (lane == lane_src && k < info._kernel_size)
+			{
+				coef = _coef_flt_arr [info._coef_index + k];
+			}
+			_hori_coef_arr.push_back (coef);
+		}
 	}
+
+	// Masks
+	bool           mask_flag = false;
+	for (int lane = 0; lane < nbr_lanes; ++lane)
+	{
+		const KernelInfo &   info = _kernel_info_arr [x_dst_beg + lane];
+		mask_flag |= (info._kernel_size < grp._nbr_taps || info._copy_flt_flag);
+	}
+	if (mask_flag)
+	{
+		grp._mask_index = int (_hori_mask_arr.size ()) / HORI_VECT_LEN;
+		for (int k = 0; k <= grp._nbr_taps; ++k)
+		{
+			for (int lane = 0; lane < HORI_VECT_LEN; ++lane)
+			{
+				bool           set_flag = false;
+				if (lane < nbr_lanes)
+				{
+					const KernelInfo &   info = _kernel_info_arr [x_dst_beg + lane];
+					set_flag =
+						  (k < grp._nbr_taps)
+						? (k < info._kernel_size)
+						: info._copy_flt_flag;
+				}
+				_hori_mask_arr.push_back ((set_flag) ? -1 : 0);
+			}
+		}
+	}
+
+	_hori_grp_arr.push_back (grp);
 }
 
 
@@ -794,6 +1063,9 @@ void	Scaler::build_scale_data ()
 	std::vector <double>	coef_tmp;
 	const int      last_line = _src_height - 1;
 
+	// Kernel hash -> index of the first destination line using this kernel
+	std::multimap <int, int>	kernel_map;
+
 	for (int y = 0; y < _dst_height; ++y)
 	{
 		// First pass: collects the coefficients and compute their sum to
@@ -831,7 +1103,8 @@ void	Scaler::build_scale_data ()
 		KernelInfo &   info = _kernel_info_arr [y];
 		double         accu = 0;
 		info._kernel_size   = 0;
-		info._coef_index    = int (_coef_flt_arr.size ());
+		const int      coef_index_beg = int (_coef_flt_arr.size ());
+		info._coef_index    = coef_index_beg;
 		info._start_line    = fstb::limit (src_pos_beg, 0, last_line);
 		info._copy_flt_flag = false;
 		info._copy_int_flag = false;
@@ -941,6 +1214,47 @@ void	Scaler::build_scale_data ()
 			}
 		}
 
+		// Polyphase deduplication: with rational scale ratios, the same
+		// phases come again and again. If an identical kernel has already
+		// been stored, reuses it and drops the new coefficients. Otherwise,
+		// packs the kernel at the end of the tables, without the trimmed
+		// coefficients, and registers it.
+		const int      hash = compute_kernel_hash (info);
+		bool           found_flag = false;
+		const auto     range = kernel_map.equal_range (hash);
+		for (auto it = range.first; it != range.second && ! found_flag; ++it)
+		{
+			const KernelInfo &   ref = _kernel_info_arr [it->second];
+			if (is_same_kernel (ref, info))
+			{
+				info._coef_index = ref._coef_index;
+				found_flag = true;
+			}
+		}
+		if (found_flag)
+		{
+			resize_coef_tables (coef_index_beg);
+		}
+		else
+		{
+			if (info._coef_index != coef_index_beg)
+			{
+				for (int k = 0; k < info._kernel_size; ++k)
+				{
+					const int      pos_to   = coef_index_beg   + k;
+					const int      pos_from = info._coef_index + k;
+					_coef_flt_arr [pos_to] = _coef_flt_arr [pos_from];
+					if (_can_int_flag)
+					{
+						_coef_int_arr.copy_coef (pos_to, pos_from);
+					}
+				}
+				info._coef_index = coef_index_beg;
+			}
+			resize_coef_tables (coef_index_beg + info._kernel_size);
+			kernel_map.insert (std::make_pair (hash, y));
+		}
+
 		// Next line
 		bi._src_pos += bi._src_step;
 	}
@@ -948,6 +1262,75 @@ void	Scaler::build_scale_data ()
 
 
 
+// Hash of the kernel content, used to spot the duplicated phases quickly.
+int	Scaler::compute_kernel_hash (const KernelInfo &info) const
+{
+	uint32_t       hash = 2166136261U;   // FNV-1a
+	const int      len  = info._kernel_size;
+	for (int k = 0; k < len; ++k)
+	{
+		const int      pos = info._coef_index + k;
+		uint32_t       val = 0;
+		memcpy (&val, &_coef_flt_arr [pos], sizeof (val));
+		if (_can_int_flag)
+		{
+			val ^= uint32_t (_coef_int_arr.get_coef (pos)) << 16;
+		}
+		hash = (hash ^ val) * 16777619U;
+	}
+	hash = (hash ^ uint32_t (len)) * 16777619U;
+
+	return (int (hash));
+}
+
+
+
+// Bit-exact comparison, so sharing a kernel never changes the results.
+bool	Scaler::is_same_kernel (const KernelInfo &ref, const KernelInfo &info) const
+{
+	if (ref._kernel_size != info._kernel_size)
+	{
+		return (false);
+	}
+
+	const int      len = info._kernel_size;
+	if (memcmp (
+		&_coef_flt_arr [ref._coef_index],
+		&_coef_flt_arr [info._coef_index],
+		len * sizeof (_coef_flt_arr [0])
+	) != 0)
+	{
+		return (false);
+	}
+
+	if (_can_int_flag)
+	{
+		for (int k = 0; k < len; ++k)
+		{
+			if (   _coef_int_arr.get_coef (ref._coef_index  + k)
+			    != _coef_int_arr.get_coef (info._coef_index + k))
+			{
+				return (false);
+			}
+		}
+	}
+
+	return (true);
+}
+
+
+
+void	Scaler::resize_coef_tables (int size)
+{
+	_coef_flt_arr.resize (size);
+	if (_can_int_flag)
+	{
+		_coef_int_arr.resize (size);
+	}
+}
+
+
+
 void	Scaler::push_back_int_coef (double coef)
 {
 	const double   cintsc   = double ((uint64_t (1)) << SHIFT_INT);
@@ -91,6 +91,15 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 	MC (Int16  , Int8   , INT16  , INT8   , 16,  8, i16_i08) \
 	MC (Stack16, Int8   , STACK16, INT8   , 16,  8, s16_i08)
 
+// Kernel sizes with a dedicated, fully unrolled line function: bilinear,
+// bicubic, spline36 or lanczos3, spline64 or lanczos4.
+// Other sizes are handled by the generic loop.
+#define fmtcl_Scaler_SPAN_NT(MC) \
+	MC (2) \
+	MC (4) \
+	MC (6) \
+	MC (8)
+
 
 
 namespace fmtcl
@@ -117,12 +126,19 @@ public:
 	static const int  SHIFT_INT   = 12; // Number of bits for the fractional part
 #endif   // fmtcl_Scaler_SSE2_16BITS
 
-	explicit       Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag);
+	explicit       Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag, bool fma_flag);
 	virtual        ~Scaler () {}
 
 	void           get_src_boundaries (int &y_src_beg, int &y_src_end, int y_dst_beg, int y_dst_end) const;
 	int            get_fir_len () const;
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	// Horizontal processing of float data, without transposition. Requires
+	// AVX2.
+	void           prepare_hori (int tile_w);
+	void           process_plane_hori (float *dst_ptr, const float *src_ptr, int dst_stride, int src_stride, int height, int x_dst_beg, int x_dst_end) const;
+#endif
+
 #define fmtcl_Scaler_DECLARE_F(DT, ST, DE, SE, FN) \
 	void           process_plane_flt (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
@@ -138,6 +154,7 @@ public:
 	static void    eval_req_src_area (int &work_top, int &work_height, int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, double center_pos_src, double center_pos_dst);
 	static int     eval_lower_bound_of_dst_tile_height (int tile_height_src, int dst_height, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, int src_height);
 	static int     eval_lower_bound_of_src_tile_height (int tile_height_dst, int dst_height, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, int src_height);
+	static int     eval_fir_len (int src_height, int dst_height, double win_height, ContFirInterface &kernel_fnc, double kernel_scale);
 
 
 
@@ -151,6 +168,10 @@ protected:
 
 private:
 
+	static const int  HORI_VECT_LEN = 8;   // Destination pixels per group, for the horizontal processing
+	static const int  HORI_WIN_LEN  = 16;  // Maximum spread of the kernel positions in a group to use sliding windows instead of gathers
+	static const int  HORI_NBR_ROWS = 4;   // Rows processed together, sharing the group setup
+
 	class BasicInfo
 	{
 	public:
@@ -174,8 +195,29 @@ private:
 		bool           _copy_int_flag;
 	};
 
+	class HoriTile
+	{
+	public:
+		int            _src_beg;         // Column of the first source pixel of the tile
+		int            _src_len;
+		int            _grp_beg;         // First group of the tile in _hori_grp_arr
+		int            _grp_end;
+	};
+
+	class HoriGroup
+	{
+	public:
+		int            _idx_index;       // First vector in _hori_idx_arr
+		int            _coef_index;      // First vector in _hori_coef_arr
+		int            _mask_index;      // First vector in _hori_mask_arr, -1 if the masks are not needed
+		int            _nbr_taps;
+		int            _win_len;         // HORI_VECT_LEN or HORI_WIN_LEN for sliding windows, 0 if the pixels are gathered
+		int            _win_pos;         // Position of the first window, relative to the tile
+	};
+
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-	void           setup_avx2 ();
+	void           setup_avx2 (bool fma_flag);
+	void           setup_avx512 (bool fma_flag);
 #endif
 
 	template <class DST, class SRC>
@@ -192,16 +234,30 @@ private:
 	template <class DST, int DB, class SRC, int SB>
 	void           process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
-	template <class DST, class SRC>
+	template <class DST, class SRC, bool FMA_FLAG>
 	void           process_plane_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
 	template <class DST, int DB, class SRC, int SB>
 	void           process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
+	template <class DST, class SRC, bool FMA_FLAG>
+	void           process_plane_flt_avx512 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
+
+	template <class DST, int DB, class SRC, int SB>
+	void           process_plane_int_avx512 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
+
+	void           build_hori_group (const HoriTile &tile, int x_dst_beg, int x_dst_end);
+
+	template <bool FMA_FLAG>
+	void           process_hori_flt_avx2 (float *dst_ptr, const float *src_ptr, int dst_stride, int src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
 #endif   // fstb_ARCHI_X86
 
 	void           build_scale_data ();
 	void           push_back_int_coef (double coef);
+	int            compute_kernel_hash (const KernelInfo &info) const;
+	bool           is_same_kernel (const KernelInfo &ref, const KernelInfo &info) const;
+	void           resize_coef_tables (int size);
 
 	int            _src_height;
 	int            _dst_height;
@@ -223,9 +279,24 @@ private:
 	std::vector <KernelInfo>            // For each destination line
 	               _kernel_info_arr;
 	std::vector <float, fstb::AllocAlign <float, 16> > // All kernel coefs, for all lines.
-	               _coef_flt_arr;       // Beware, kernels may not be contiguous.
+	               _coef_flt_arr;       // Unique kernels only, shared by the lines with the same phase.
 	CoefArrInt     _coef_int_arr;       // Same here
 
+	// Horizontal processing. The tables are built for a fixed tile grid.
+	int            _hori_tile_w;        // Destination pixels. 0 = not prepared
+	std::vector <HoriTile>
+	               _hori_tile_arr;
+	std::vector <HoriGroup>             // Groups of HORI_VECT_LEN destination pixels
+	               _hori_grp_arr;
+	std::vector <int32_t, fstb::AllocAlign <int32_t, 32> > // Source positions, by vectors of HORI_VECT_LEN. One vector per group for the sliding windows, one per tap otherwise.
+	               _hori_idx_arr;
+	std::vector <float, fstb::AllocAlign <float, 32> >
+	               _hori_coef_arr;
+	std::vector <int32_t, fstb::AllocAlign <int32_t, 32> > // Lane masks, by vectors of HORI_VECT_LEN. One vector per tap for the lanes using it, then one for the copied lanes.
+	               _hori_mask_arr;
+	void (ThisType::*
+	               _process_hori_flt_ptr) (float *dst_ptr, const float *src_ptr, int dst_stride, int src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
 #define fmtcl_Scaler_FNCPTR_F(DT, ST, DE, SE, FN) \
 	void (ThisType::* \
 	               _process_plane_flt_##FN##_ptr) (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const;
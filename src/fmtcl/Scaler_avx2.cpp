@@ -32,6 +32,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/Scaler.h"
 #include "fmtcl/ScalerCopy.h"
 #include "fstb/fnc.h"
+#include "fstb/ToolsAvx2.h"
 #include "fstb/ToolsSse2.h"
 
 #include <algorithm>
@@ -50,6 +51,20 @@ namespace fmtcl
 
 
 
+// src_ptr is the top-left corner of the source tile, at the first column
+// given by get_src_boundaries() for this tile. dst_ptr is the top-left
+// corner of the destination tile. Strides are in pixels.
+void	Scaler::process_plane_hori (float *dst_ptr, const float *src_ptr, int dst_stride, int src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (_process_hori_flt_ptr != 0);
+
+	(this->*_process_hori_flt_ptr) (
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end
+	);
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -59,42 +74,66 @@ namespace fmtcl
 
 
 #define fmtcl_Scaler_INIT_F_AVX2(DT, ST, DE, SE, FN) \
-	_process_plane_flt_##FN##_ptr = &ThisType::process_plane_flt_avx2 <ProxyRwAvx2 <SplFmt_##DE>, ProxyRwAvx2 <SplFmt_##SE> >;
+	_process_plane_flt_##FN##_ptr = &ThisType::process_plane_flt_avx2 <ProxyRwAvx2 <SplFmt_##DE>, ProxyRwAvx2 <SplFmt_##SE>, false>;
+
+#define fmtcl_Scaler_INIT_F_AVX2_FMA(DT, ST, DE, SE, FN) \
+	_process_plane_flt_##FN##_ptr = &ThisType::process_plane_flt_avx2 <ProxyRwAvx2 <SplFmt_##DE>, ProxyRwAvx2 <SplFmt_##SE>, true>;
 
 #define fmtcl_Scaler_INIT_I_AVX2(DT, ST, DE, SE, DB, SB, FN) \
 	_process_plane_int_##FN##_ptr = &ThisType::process_plane_int_avx2 <ProxyRwAvx2 <SplFmt_##DE>, DB, ProxyRwAvx2 <SplFmt_##SE>, SB>;
 
-void  Scaler::setup_avx2 ()
+void  Scaler::setup_avx2 (bool fma_flag)
 {
-	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_AVX2)
+	if (fma_flag)
+	{
+		fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_AVX2_FMA)
+		_process_hori_flt_ptr = &ThisType::process_hori_flt_avx2 <true>;
+	}
+	else
+	{
+		fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_AVX2)
+		_process_hori_flt_ptr = &ThisType::process_hori_flt_avx2 <false>;
+	}
 #if ! defined (fmtcl_Scaler_SSE2_16BITS)
 	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_AVX2)
 #endif
 }
 
 #undef fmtcl_Scaler_INIT_F_AVX2
+#undef fmtcl_Scaler_INIT_F_AVX2_FMA
 #undef fmtcl_Scaler_INIT_I_AVX2
 
 
 
-template <class SRC, bool PF>
+// NT: number of taps known at compile time, or 0 to use kernel_size
+template <class SRC, bool PF, bool FMA_FLAG, int NT>
 static fstb_FORCEINLINE void	Scaler_process_vect_flt_avx2 (__m256 &sum0, __m256 &sum1, int kernel_size, const float *coef_base_ptr, typename SRC::PtrConst::Type pix_ptr, const __m256i &zero, int src_stride, const __m256 &add_cst, int len)
 {
+	const int      nbr_taps = (NT > 0) ? NT : kernel_size;
+
 	// Possible optimization: initialize the sum with DST::OFFSET + _add_cst_flt
 	// and save the add in the write proxy.
 	sum0 = add_cst;
 	sum1 = add_cst;
 
-	for (int k = 0; k < kernel_size; ++k)
+	for (int k = 0; k < nbr_taps; ++k)
 	{
 		__m256         coef = _mm256_set1_ps (coef_base_ptr [k]);
 		__m256         src0;
 		__m256         src1;
 		ReadWrapperFlt <SRC, PF>::read (pix_ptr, src0, src1, zero, len);
-		const __m256   val0 = _mm256_mul_ps (src0, coef);
-		const __m256   val1 = _mm256_mul_ps (src1, coef);
-		sum0 = _mm256_add_ps (sum0, val0);
-		sum1 = _mm256_add_ps (sum1, val1);
+		if (FMA_FLAG)
+		{
+			sum0 = _mm256_fmadd_ps (src0, coef, sum0);
+			sum1 = _mm256_fmadd_ps (src1, coef, sum1);
+		}
+		else
+		{
+			const __m256   val0 = _mm256_mul_ps (src0, coef);
+			const __m256   val1 = _mm256_mul_ps (src1, coef);
+			sum0 = _mm256_add_ps (sum0, val0);
+			sum1 = _mm256_add_ps (sum1, val1);
+		}
 
 		SRC::PtrConst::jump (pix_ptr, src_stride);
 	}
@@ -102,10 +141,56 @@ static fstb_FORCEINLINE void	Scaler_process_vect_flt_avx2 (__m256 &sum0, __m256
 
 
 
+template <class DST, class SRC, bool FMA_FLAG, int NT>
+static void	Scaler_process_line_flt_avx2 (typename DST::Ptr::Type col_dst_ptr, typename SRC::PtrConst::Type col_src_ptr, int src_stride, int width, int kernel_size, const float *coef_base_ptr, const __m256 &add_cst)
+{
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256   offset   = _mm256_set1_ps (float (DST::OFFSET));
+
+	const int      w16 = width & -16;
+	const int      w15 = width - w16;
+
+	__m256         sum0;
+	__m256         sum1;
+
+	for (int x = 0; x < w16; x += 16)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		Scaler_process_vect_flt_avx2 <SRC, false, FMA_FLAG, NT> (
+			sum0, sum1, kernel_size, coef_base_ptr,
+			pix_ptr, zero, src_stride, add_cst, 0
+		);
+		DST::write_flt (
+			col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset
+		);
+
+		DST::Ptr::jump (col_dst_ptr, 16);
+		SRC::PtrConst::jump (col_src_ptr, 16);
+	}
+
+	if (w15 > 0)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		Scaler_process_vect_flt_avx2 <SRC, true, FMA_FLAG, NT> (
+			sum0, sum1, kernel_size, coef_base_ptr,
+			pix_ptr, zero, src_stride, add_cst, w15
+		);
+		DST::write_flt_partial (
+			col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset, w15
+		);
+	}
+}
+
+
+
 // DST and SRC are ProxyRwAvx2 classes
 // Stride offsets in pixels
 // Source pointer may be unaligned.
-template <class DST, class SRC>
+template <class DST, class SRC, bool FMA_FLAG>
 void	Scaler::process_plane_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const
 {
 	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
@@ -127,15 +212,8 @@ void	Scaler::process_plane_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 	assert (width <= dst_stride);
 	assert (width <= src_stride);
 
-	const __m256i  zero     = _mm256_setzero_si256 ();
-	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
-	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
-	const __m256   offset   = _mm256_set1_ps (float (DST::OFFSET));
 	const __m256   add_cst  = _mm256_set1_ps (float (_add_cst_flt));
 
-	const int      w16 = width & -16;
-	const int      w15 = width - w16;
-
 	for (int y = y_dst_beg; y < y_dst_end; ++y)
 	{
 		const KernelInfo& kernel_info   = _kernel_info_arr [y];
@@ -156,36 +234,26 @@ void	Scaler::process_plane_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 
 		else
 		{
-			__m256         sum0;
-			__m256         sum1;
-
-			for (int x = 0; x < w16; x += 16)
-			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
-
-				Scaler_process_vect_flt_avx2 <SRC, false> (
-					sum0, sum1, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, add_cst, 0
-				);
-				DST::write_flt (
-					col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset
-				);
-
-				DST::Ptr::jump (col_dst_ptr, 16);
-				SRC::PtrConst::jump (col_src_ptr, 16);
-			}
-
-			if (w15 > 0)
+			switch (kernel_size)
 			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
-
-				Scaler_process_vect_flt_avx2 <SRC, true> (
-					sum0, sum1, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, add_cst, w15
-				);
-				DST::write_flt_partial (
-					col_dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset, w15
+#define fmtcl_Scaler_CASE_NT(NT) \
+			case NT: \
+				Scaler_process_line_flt_avx2 <DST, SRC, FMA_FLAG, NT> ( \
+					col_dst_ptr, col_src_ptr, src_stride, width, \
+					kernel_size, coef_base_ptr, add_cst \
+				); \
+				break;
+
+			fmtcl_Scaler_SPAN_NT (fmtcl_Scaler_CASE_NT)
+
+#undef fmtcl_Scaler_CASE_NT
+
+			default:
+				Scaler_process_line_flt_avx2 <DST, SRC, FMA_FLAG, 0> (
+					col_dst_ptr, col_src_ptr, src_stride, width,
+					kernel_size, coef_base_ptr, add_cst
 				);
+				break;
 			}
 		}
 
@@ -197,15 +265,35 @@ void	Scaler::process_plane_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 
 
 
-template <class DST, int DB, class SRC, int SB, bool PF>
-static fstb_FORCEINLINE __m256i	Scaler_process_vect_int_avx2 (const __m256i &add_cst, int kernel_size, const __m256i coef_base_ptr [], typename SRC::PtrConst::Type pix_ptr, const __m256i &zero, int src_stride, const __m256i &sign_bit, int len)
+// NT: number of taps known at compile time, or 0 to use kernel_size
+template <class DST, int DB, class SRC, int SB, bool PF, int NT>
+static fstb_FORCEINLINE __m256i	Scaler_process_vect_int_avx2 (const __m256i &add_cst, int kernel_size, const __m256i coef_base_ptr [], const __m256i coef_pair_ptr [], typename SRC::PtrConst::Type pix_ptr, const __m256i &zero, int src_stride, const __m256i &sign_bit, int len)
 {
 	typedef typename SRC::template S16 <false, (SB == 16)> SrcS16R;
 
+	const int      nbr_taps = (NT > 0) ? NT : kernel_size;
+
 	__m256i        sum0 = add_cst;
 	__m256i        sum1 = add_cst;
 
-	for (int k = 0; k < kernel_size; ++k)
+	// Taps are processed by pairs with _mm256_madd_epi16
+	int            k = 0;
+	for ( ; k < nbr_taps - 1; k += 2)
+	{
+		const __m256i  coef = _mm256_load_si256 (coef_pair_ptr + k);
+		const __m256i  src0 = ReadWrapperInt <SRC, SrcS16R, PF>::read (
+			pix_ptr, zero, sign_bit, len
+		);
+		SRC::PtrConst::jump (pix_ptr, src_stride);
+		const __m256i  src1 = ReadWrapperInt <SRC, SrcS16R, PF>::read (
+			pix_ptr, zero, sign_bit, len
+		);
+		SRC::PtrConst::jump (pix_ptr, src_stride);
+
+		fstb::ToolsAvx2::mac2_s16_s16_s32 (sum0, sum1, src0, src1, coef);
+	}
+
+	if (k < nbr_taps)
 	{
 		const __m256i  coef = _mm256_load_si256 (coef_base_ptr + k);
 		const __m256i  src  = ReadWrapperInt <SRC, SrcS16R, PF>::read (
@@ -213,8 +301,6 @@ static fstb_FORCEINLINE __m256i	Scaler_process_vect_int_avx2 (const __m256i &add
 		);
 
 		fstb::ToolsAvx2::mac_s16_s16_s32 (sum0, sum1, src, coef);
-
-		SRC::PtrConst::jump (pix_ptr, src_stride);
 	}
 
 	sum0 = _mm256_srai_epi32 (sum0, Scaler::SHIFT_INT + SB - DB);
@@ -227,6 +313,68 @@ static fstb_FORCEINLINE __m256i	Scaler_process_vect_int_avx2 (const __m256i &add
 
 
 
+template <class DST, int DB, class SRC, int SB, int NT>
+static void	Scaler_process_line_int_avx2 (typename DST::Ptr::Type col_dst_ptr, typename SRC::PtrConst::Type col_src_ptr, int src_stride, int width, int kernel_size, const __m256i coef_base_ptr [], const __m256i coef_pair_ptr [], const __m256i &add_cst)
+{
+	typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
+
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256i  ma       = _mm256_set1_epi16 (int16_t ((1 << DB) - 1));
+
+	const int      w16 = width & -16;
+	const int      w15 = width - w16;
+
+	for (int x = 0; x < w16; x += 16)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		const __m256i  val = Scaler_process_vect_int_avx2 <
+			DST, DB, SRC, SB, false, NT
+		> (
+			add_cst, kernel_size, coef_base_ptr, coef_pair_ptr,
+			pix_ptr, zero, src_stride, sign_bit, 0
+		);
+
+		DstS16W::write_clip (
+			col_dst_ptr,
+			val,
+			mask_lsb,
+			zero,
+			ma,
+			sign_bit
+		);
+
+		DST::Ptr::jump (col_dst_ptr, 16);
+		SRC::PtrConst::jump (col_src_ptr, 16);
+	}
+
+	if (w15 > 0)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
+
+		const __m256i  val = Scaler_process_vect_int_avx2 <
+			DST, DB, SRC, SB, true, NT
+		> (
+			add_cst, kernel_size, coef_base_ptr, coef_pair_ptr,
+			pix_ptr, zero, src_stride, sign_bit, w15
+		);
+
+		DstS16W::write_clip_partial (
+			col_dst_ptr,
+			val,
+			mask_lsb,
+			zero,
+			ma,
+			sign_bit,
+			w15
+		);
+	}
+}
+
+
+
 template <class DST, int DB, class SRC, int SB>
 void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int dst_stride, int src_stride, int width, int y_dst_beg, int y_dst_end) const
 {
@@ -251,15 +399,8 @@ void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 	const int      s_out    = (DB < 16) ?   0x8000 << (SHIFT_INT + SB - DB)  : 0;
 	const int      s_cst    = s_in + s_out;
 
-	const __m256i  zero     = _mm256_setzero_si256 ();
-	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
-	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
-	const __m256i  ma       = _mm256_set1_epi16 (int16_t ((1 << DB) - 1));
 	const __m256i  add_cst  = _mm256_set1_epi32 (_add_cst_int + s_cst + r_cst);
 
-	const int      w16 = width & -16;
-	const int      w15 = width - w16;
-
 	for (int y = y_dst_beg; y < y_dst_end; ++y)
 	{
 		const KernelInfo&    kernel_info   = _kernel_info_arr [y];
@@ -268,6 +409,9 @@ void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 		const __m256i *      coef_base_ptr = reinterpret_cast <const __m256i *> (
 			_coef_int_arr.use_vect_avx2 (kernel_info._coef_index)
 		);
+		const __m256i *      coef_pair_ptr = reinterpret_cast <const __m256i *> (
+			_coef_int_arr.use_vect_pair_avx2 (kernel_info._coef_index)
+		);
 
 		typename SRC::PtrConst::Type  col_src_ptr = src_ptr;
 		SRC::PtrConst::jump (col_src_ptr, src_stride * ofs_y);
@@ -282,57 +426,274 @@ void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 
 		else
 		{
-			typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
-
-			for (int x = 0; x < w16; x += 16)
+			switch (kernel_size)
 			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
-
-				const __m256i  val = Scaler_process_vect_int_avx2 <
-					DST, DB, SRC, SB, false
-				> (
-					add_cst, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, sign_bit, 0
+#define fmtcl_Scaler_CASE_NT(NT) \
+			case NT: \
+				Scaler_process_line_int_avx2 <DST, DB, SRC, SB, NT> ( \
+					col_dst_ptr, col_src_ptr, src_stride, width, \
+					kernel_size, coef_base_ptr, coef_pair_ptr, add_cst \
+				); \
+				break;
+
+			fmtcl_Scaler_SPAN_NT (fmtcl_Scaler_CASE_NT)
+
+#undef fmtcl_Scaler_CASE_NT
+
+			default:
+				Scaler_process_line_int_avx2 <DST, DB, SRC, SB, 0> (
+					col_dst_ptr, col_src_ptr, src_stride, width,
+					kernel_size, coef_base_ptr, coef_pair_ptr, add_cst
 				);
+				break;
+			}
+		}
 
-				DstS16W::write_clip (
-					col_dst_ptr,
-					val,
-					mask_lsb,
-					zero,
-					ma,
-					sign_bit
-				);
+		DST::Ptr::jump (dst_ptr, dst_stride);
+	}
+}
 
-				DST::Ptr::jump (col_dst_ptr, 16);
-				SRC::PtrConst::jump (col_src_ptr, 16);
-			}
 
-			if (w15 > 0)
-			{
-				typename SRC::PtrConst::Type  pix_ptr = col_src_ptr;
 
-				const __m256i  val = Scaler_process_vect_int_avx2 <
-					DST, DB, SRC, SB, true
-				> (
-					add_cst, kernel_size, coef_base_ptr,
-					pix_ptr, zero, src_stride, sign_bit, w15
-				);
+template <bool FMA_FLAG>
+static fstb_FORCEINLINE __m256	Scaler_mac_flt_avx2 (const __m256 &sum, const __m256 &src, const __m256 &coef)
+{
+	if (FMA_FLAG)
+	{
+		return (_mm256_fmadd_ps (src, coef, sum));
+	}
+
+	return (_mm256_add_ps (sum, _mm256_mul_ps (src, coef)));
+}
+
+
+
+// With MASK_FLAG, the source pixels of the lanes not using the tap are
+// cleared. Their coefficient is null too, so their sum is left unchanged,
+// whatever the source value (Inf or NaN). The source pixels of the first tap
+// are kept for the copied lanes.
+template <bool FMA_FLAG, bool MASK_FLAG>
+static fstb_FORCEINLINE void	Scaler_mac_hori_flt_avx2 (__m256 &sum, __m256 &src_0, __m256 src, const __m256 &coef, const __m256 *mask_ptr, int k)
+{
+	if (MASK_FLAG)
+	{
+		if (k == 0)
+		{
+			src_0 = src;
+		}
+		src = _mm256_and_ps (src, mask_ptr [k]);
+	}
+	sum = Scaler_mac_flt_avx2 <FMA_FLAG> (sum, src, coef);
+}
 
-				DstS16W::write_clip_partial (
-					col_dst_ptr,
-					val,
-					mask_lsb,
-					zero,
-					ma,
-					sign_bit,
-					w15
+
+
+// Convolves a group of 8 horizontally adjacent destination pixels on NR
+// consecutive rows. win_ptr points on the window of the first row (or on the
+// row itself when gathering). The rows share the indexes and coefficients.
+// With MASK_FLAG, mask_ptr holds a lane mask for each tap, then the mask of
+// the lanes to copy from the source.
+template <bool FMA_FLAG, bool MASK_FLAG, int NR>
+static fstb_FORCEINLINE void	Scaler_conv_hori_flt_avx2 (__m256 sum_arr [NR], const float *win_ptr, int src_stride, int win_len, const __m256i *idx_ptr, const __m256 *coef_ptr, const __m256 *mask_ptr, int nbr_taps, const __m256 &add_cst)
+{
+	__m256         src_0_arr [NR];
+	for (int r = 0; r < NR; ++r)
+	{
+		sum_arr [r]   = add_cst;
+		src_0_arr [r] = add_cst;
+	}
+
+	if (win_len == 8)
+	{
+		const __m256i  idx = idx_ptr [0];
+		for (int k = 0; k < nbr_taps; ++k)
+		{
+			const __m256   coef = coef_ptr [k];
+			for (int r = 0; r < NR; ++r)
+			{
+				const __m256   src = _mm256_permutevar8x32_ps (
+					_mm256_loadu_ps (win_ptr + r * src_stride + k), idx
+				);
+				Scaler_mac_hori_flt_avx2 <FMA_FLAG, MASK_FLAG> (
+					sum_arr [r], src_0_arr [r], src, coef, mask_ptr, k
 				);
 			}
 		}
+	}
+	else if (win_len > 0)
+	{
+		const __m256i  idx = idx_ptr [0];
+		// Bit 3 of the position selects the window half
+		const __m256   sel =
+			_mm256_castsi256_ps (_mm256_slli_epi32 (idx, 31 - 3));
+		for (int k = 0; k < nbr_taps; ++k)
+		{
+			const __m256   coef = coef_ptr [k];
+			for (int r = 0; r < NR; ++r)
+			{
+				const float *  row_ptr = win_ptr + r * src_stride + k;
+				const __m256   src0    = _mm256_permutevar8x32_ps (
+					_mm256_loadu_ps (row_ptr    ), idx
+				);
+				const __m256   src1    = _mm256_permutevar8x32_ps (
+					_mm256_loadu_ps (row_ptr + 8), idx
+				);
+				const __m256   src     = _mm256_blendv_ps (src0, src1, sel);
+				Scaler_mac_hori_flt_avx2 <FMA_FLAG, MASK_FLAG> (
+					sum_arr [r], src_0_arr [r], src, coef, mask_ptr, k
+				);
+			}
+		}
+	}
+	else
+	{
+		for (int k = 0; k < nbr_taps; ++k)
+		{
+			const __m256i  idx  = idx_ptr [k];
+			const __m256   coef = coef_ptr [k];
+			for (int r = 0; r < NR; ++r)
+			{
+				const __m256   src = _mm256_i32gather_ps (
+					win_ptr + r * src_stride, idx, sizeof (*win_ptr)
+				);
+				Scaler_mac_hori_flt_avx2 <FMA_FLAG, MASK_FLAG> (
+					sum_arr [r], src_0_arr [r], src, coef, mask_ptr, k
+				);
+			}
+		}
+	}
 
-		DST::Ptr::jump (dst_ptr, dst_stride);
+	if (MASK_FLAG)
+	{
+		const __m256   copy_mask = mask_ptr [nbr_taps];
+		for (int r = 0; r < NR; ++r)
+		{
+			sum_arr [r] = _mm256_blendv_ps (sum_arr [r], src_0_arr [r], copy_mask);
+		}
+	}
+}
+
+
+
+// mask_ptr is 0 when all the lanes use all the taps and none is copied
+template <bool FMA_FLAG, int NR>
+static fstb_FORCEINLINE void	Scaler_conv_hori_flt_avx2 (__m256 sum_arr [NR], const float *win_ptr, int src_stride, int win_len, const __m256i *idx_ptr, const __m256 *coef_ptr, const __m256 *mask_ptr, int nbr_taps, const __m256 &add_cst)
+{
+	if (mask_ptr == 0)
+	{
+		Scaler_conv_hori_flt_avx2 <FMA_FLAG, false, NR> (
+			sum_arr, win_ptr, src_stride, win_len,
+			idx_ptr, coef_ptr, mask_ptr, nbr_taps, add_cst
+		);
 	}
+	else
+	{
+		Scaler_conv_hori_flt_avx2 <FMA_FLAG, true, NR> (
+			sum_arr, win_ptr, src_stride, win_len,
+			idx_ptr, coef_ptr, mask_ptr, nbr_taps, add_cst
+		);
+	}
+}
+
+
+
+template <int NR>
+static fstb_FORCEINLINE void	Scaler_store_hori_flt_avx2 (float *dst_ptr, int dst_stride, const __m256 sum_arr [NR], int len)
+{
+	for (int r = 0; r < NR; ++r)
+	{
+		if (len >= 8)
+		{
+			_mm256_storeu_ps (dst_ptr + r * dst_stride, sum_arr [r]);
+		}
+		else
+		{
+			fstb::ToolsAvx2::store_ps_partial (
+				dst_ptr + r * dst_stride, sum_arr [r], len
+			);
+		}
+	}
+}
+
+
+
+// Horizontal convolution, straight on the source rows. For each tap, a group
+// of 8 destination pixels picks its source pixels with a permutation of a
+// window sliding along the row, or with a gather when the kernels are too
+// far apart. Rows are processed by blocks sharing the group setup. Taps are
+// summed in the same order as in the vertical path and the copied lines are
+// copied, so the results are identical, Inf and NaN included.
+template <bool FMA_FLAG>
+void	Scaler::process_hori_flt_avx2 (float *dst_ptr, const float *src_ptr, int dst_stride, int src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (height > 0);
+	assert (_hori_tile_w > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg % _hori_tile_w == 0);
+	assert (x_dst_end == std::min (x_dst_beg + _hori_tile_w, _dst_height));
+
+	const HoriTile &  tile = _hori_tile_arr [x_dst_beg / _hori_tile_w];
+	assert (tile._src_len <= src_stride);
+
+	const int      width     = x_dst_end - x_dst_beg;
+	const __m256   add_cst   = _mm256_set1_ps (float (_add_cst_flt));
+	const __m256i *idx_base  =
+		reinterpret_cast <const __m256i *> (&_hori_idx_arr [0]);
+	const __m256 * coef_base =
+		reinterpret_cast <const __m256 *> (&_hori_coef_arr [0]);
+	const __m256 * mask_base =
+		reinterpret_cast <const __m256 *> (_hori_mask_arr.data ());
+
+	int            y = 0;
+	for ( ; y + HORI_NBR_ROWS <= height; y += HORI_NBR_ROWS)
+	{
+		int            x = 0;
+		for (int g = tile._grp_beg; g < tile._grp_end; ++g)
+		{
+			const HoriGroup & grp = _hori_grp_arr [g];
+			const __m256 * mask_ptr =
+				(grp._mask_index >= 0) ? mask_base + grp._mask_index : 0;
+			__m256         sum_arr [HORI_NBR_ROWS];
+			Scaler_conv_hori_flt_avx2 <FMA_FLAG, HORI_NBR_ROWS> (
+				sum_arr, src_ptr + grp._win_pos, src_stride, grp._win_len,
+				idx_base + grp._idx_index, coef_base + grp._coef_index,
+				mask_ptr, grp._nbr_taps, add_cst
+			);
+			Scaler_store_hori_flt_avx2 <HORI_NBR_ROWS> (
+				dst_ptr + x, dst_stride, sum_arr, width - x
+			);
+			x += HORI_VECT_LEN;
+		}
+
+		src_ptr += src_stride * HORI_NBR_ROWS;
+		dst_ptr += dst_stride * HORI_NBR_ROWS;
+	}
+
+	for ( ; y < height; ++y)
+	{
+		int            x = 0;
+		for (int g = tile._grp_beg; g < tile._grp_end; ++g)
+		{
+			const HoriGroup & grp = _hori_grp_arr [g];
+			const __m256 * mask_ptr =
+				(grp._mask_index >= 0) ? mask_base + grp._mask_index : 0;
+			__m256         sum_arr [1];
+			Scaler_conv_hori_flt_avx2 <FMA_FLAG, 1> (
+				sum_arr, src_ptr + grp._win_pos, src_stride, grp._win_len,
+				idx_base + grp._idx_index, coef_base + grp._coef_index,
+				mask_ptr, grp._nbr_taps, add_cst
+			);
+			Scaler_store_hori_flt_avx2 <1> (dst_ptr + x, dst_stride, sum_arr, width - x);
+			x += HORI_VECT_LEN;
+		}
+
+		src_ptr += src_stride;
+		dst_ptr += dst_stride;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
 }
 
 
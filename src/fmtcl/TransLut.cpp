@@ -388,16 +388,21 @@ void	TransLut::generate_lut (const TransOpInterface &curve)
 	else
 	{
 		int            range = 1 << _src_bits;
-		if (_src_bits <= 8)
+		if (_dst_fmt == SplFmt_FLOAT)
 		{
-			_lut.set_type <uint8_t> ();
-			_lut.resize (1 << 8);
+			_lut.set_type <float> ();
 		}
-		else
+		else if (_dst_bits > 8)
 		{
 			_lut.set_type <uint16_t> ();
-			_lut.resize (1 << 16);
 		}
+		else
+		{
+			_lut.set_type <uint8_t> ();
+		}
+		// The padding makes the 32-bit gathers of the last entries safe.
+		const int      lut_size = (_src_bits <= 8) ? 1 << 8 : 1 << 16;
+		_lut.resize (lut_size + LUT_PAD);
 		const int      sb16  = (_src_full_flag) ? 0      :  16 << 8;
 		const int      sw16  = (_src_full_flag) ? 0xFFFF : 235 << 8;
 		int            sbn   = sb16 >> (16 - _src_bits);
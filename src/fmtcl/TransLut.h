@@ -66,6 +66,8 @@ public:
 	static const int  LOGLUT_HSIZE   = ((LOGLUT_MAX_L2 - LOGLUT_MIN_L2) << LOGLUT_RES_L2) + 1; // Table made of half-open segments (and whitout x=0) + 1 more value for LOGLUT_MAX, closing the last segment.
 	static const int  LOGLUT_SIZE    = 2 * LOGLUT_HSIZE + 1;   // Negative + 0 + positive
 
+	static const int  LUT_PAD        = 3;  // Extra elements at the end of the integer-input tables
+
 	union FloatIntMix
 	{
 		float          _f;
@@ -141,6 +143,8 @@ private:
 	void           process_plane_flt_any_sse2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h);
 	template <class TD, class M>
 	void           process_plane_flt_any_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h);
+	template <class TS, class TD>
+	void           process_plane_int_any_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h);
 #endif
 
 	bool           _loglut_flag;
@@ -159,7 +163,7 @@ private:
 	void (ThisType:: *
 	               _process_plane_ptr) (uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h);
 
-	ArrayMultiType _lut;            // Opaque array, contains uint8_t, uint16_t or float depending on the output datatype. Table size is always 256, 65536 or 65536*3+1 (float input, covering -1 to +2 range).
+	ArrayMultiType _lut;            // Opaque array, contains uint8_t, uint16_t or float depending on the output datatype. Table size is always 256 or 65536 (+ LUT_PAD) for integer input, LINLUT_SIZE_F or LOGLUT_SIZE for float input.
 
 
 
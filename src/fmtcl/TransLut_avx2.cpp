@@ -182,6 +182,64 @@ static fstb_FORCEINLINE void	TransLut_store_avx2 (float *dst_ptr, __m256 val)
 
 
 
+// Converts 16 source pixels into two vectors of 32-bit LUT indexes
+static fstb_FORCEINLINE void	TransLut_load_index_avx2 (const uint8_t *src_ptr, __m256i &idx_0, __m256i &idx_1)
+{
+	const __m128i  s = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr));
+	idx_0 = _mm256_cvtepu8_epi32 (s);
+	idx_1 = _mm256_cvtepu8_epi32 (_mm_srli_si128 (s, 8));
+}
+
+static fstb_FORCEINLINE void	TransLut_load_index_avx2 (const uint16_t *src_ptr, __m256i &idx_0, __m256i &idx_1)
+{
+	const __m256i  s = _mm256_loadu_si256 (reinterpret_cast <const __m256i *> (src_ptr));
+	idx_0 = _mm256_cvtepu16_epi32 (_mm256_castsi256_si128 (s));
+	idx_1 = _mm256_cvtepu16_epi32 (_mm256_extracti128_si256 (s, 1));
+}
+
+
+
+// Looks up and stores 16 destination pixels. The integer tables are read
+// with 32-bit gathers, the unwanted upper bytes are masked out. Reading
+// past the last entry is covered by TransLut::LUT_PAD.
+static fstb_FORCEINLINE void	TransLut_lookup_store_avx2 (uint8_t *dst_ptr, const uint8_t *lut_ptr, __m256i idx_0, __m256i idx_1)
+{
+	const __m256i  mask  = _mm256_set1_epi32 (0xFF);
+	const int *    l_ptr = reinterpret_cast <const int *> (lut_ptr);
+	__m256i        v_0   = _mm256_i32gather_epi32 (l_ptr, idx_0, 1);
+	__m256i        v_1   = _mm256_i32gather_epi32 (l_ptr, idx_1, 1);
+	v_0 = _mm256_and_si256 (v_0, mask);
+	v_1 = _mm256_and_si256 (v_1, mask);
+	__m256i        v     = _mm256_packus_epi32 (v_0, v_1);
+	v = _mm256_permute4x64_epi64 (v, (0<<0) + (2<<2) + (1<<4) + (3<<6));
+	const __m128i  v8    = _mm_packus_epi16 (
+		_mm256_castsi256_si128 (v),
+		_mm256_extracti128_si256 (v, 1)
+	);
+	_mm_storeu_si128 (reinterpret_cast <__m128i *> (dst_ptr), v8);
+}
+
+static fstb_FORCEINLINE void	TransLut_lookup_store_avx2 (uint16_t *dst_ptr, const uint16_t *lut_ptr, __m256i idx_0, __m256i idx_1)
+{
+	const __m256i  mask  = _mm256_set1_epi32 (0xFFFF);
+	const int *    l_ptr = reinterpret_cast <const int *> (lut_ptr);
+	__m256i        v_0   = _mm256_i32gather_epi32 (l_ptr, idx_0, 2);
+	__m256i        v_1   = _mm256_i32gather_epi32 (l_ptr, idx_1, 2);
+	v_0 = _mm256_and_si256 (v_0, mask);
+	v_1 = _mm256_and_si256 (v_1, mask);
+	__m256i        v     = _mm256_packus_epi32 (v_0, v_1);
+	v = _mm256_permute4x64_epi64 (v, (0<<0) + (2<<2) + (1<<4) + (3<<6));
+	_mm256_storeu_si256 (reinterpret_cast <__m256i *> (dst_ptr), v);
+}
+
+static fstb_FORCEINLINE void	TransLut_lookup_store_avx2 (float *dst_ptr, const float *lut_ptr, __m256i idx_0, __m256i idx_1)
+{
+	_mm256_storeu_ps (dst_ptr    , _mm256_i32gather_ps (lut_ptr, idx_0, 4));
+	_mm256_storeu_ps (dst_ptr + 8, _mm256_i32gather_ps (lut_ptr, idx_1, 4));
+}
+
+
+
 /*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -202,10 +260,16 @@ void	TransLut::init_proc_fnc_avx2 (int selector)
 		{
 		case 0*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <float   , MapperLog>; break;
 		case 0*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <float   , MapperLin>; break;
+		case 0*4+2:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint16_t, float    >; break;
+		case 0*4+3:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint8_t , float    >; break;
 		case 1*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint16_t, MapperLog>; break;
 		case 1*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint16_t, MapperLin>; break;
+		case 1*4+2:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint16_t, uint16_t >; break;
+		case 1*4+3:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint8_t , uint16_t >; break;
 		case 2*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint8_t , MapperLog>; break;
 		case 2*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint8_t , MapperLin>; break;
+		case 2*4+2:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint16_t, uint8_t  >; break;
+		case 2*4+3:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint8_t , uint8_t  >; break;
 
 		default:
 			// Nothing
@@ -286,6 +350,51 @@ void	TransLut::process_plane_flt_any_avx2 (uint8_t *dst_ptr, const uint8_t *src_
 
 
 
+template <class TS, class TD>
+void	TransLut::process_plane_int_any_avx2 (uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h)
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (stride_dst != 0 || h == 1);
+	assert (stride_src != 0 || h == 1);
+	assert (w > 0);
+	assert (h > 0);
+
+	const TD *     lut_ptr = &_lut.use <TD> (0);
+
+	// The groups of 16 pixels would write up to 64 bytes past the end of the
+	// line with a float output, more than the frame padding. The remaining
+	// pixels are processed one by one.
+	const int      w16 = w & -16;
+
+	for (int y = 0; y < h; ++y)
+	{
+		const TS *     s_ptr = reinterpret_cast <const TS *> (src_ptr);
+		TD *           d_ptr = reinterpret_cast <      TD *> (dst_ptr);
+
+		for (int x = 0; x < w16; x += 16)
+		{
+			__m256i        idx_0;
+			__m256i        idx_1;
+			TransLut_load_index_avx2 (s_ptr + x, idx_0, idx_1);
+			TransLut_lookup_store_avx2 (d_ptr + x, lut_ptr, idx_0, idx_1);
+		}
+
+		for (int x = w16; x < w; ++x)
+		{
+			const int          index = s_ptr [x];
+			d_ptr [x] = lut_ptr [index];
+		}
+
+		src_ptr += stride_src;
+		dst_ptr += stride_dst;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
 }	// namespace fmtcl
 
 
@@ -31,6 +31,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #endif
 
 #include <cassert>
+#include <cstdint>
 
 
 
@@ -55,21 +56,22 @@ CpuId::CpuId ()
 	// Basic features
 	call_cpuid (0x00000001, eax, ebx, ecx, edx);
 
-	_mmx_flag     = ((edx & (1L << 23)) != 0);
-	_sse_flag     = ((edx & (1L << 25)) != 0);
-	_sse2_flag    = ((edx & (1L << 26)) != 0);
-	_sse3_flag    = ((ecx & (1L <<  0)) != 0);
-	_ssse3_flag   = ((ecx & (1L <<  9)) != 0);
-	_cx16_flag    = ((ecx & (1L << 13)) != 0);
-	_fma3_flag    = ((ecx & (1L << 16)) != 0);
-	_sse41_flag   = ((ecx & (1L << 19)) != 0);
-	_sse42_flag   = ((ecx & (1L << 20)) != 0);
-	_avx_flag     = ((ecx & (1L << 28)) != 0);
-	_f16c_flag    = ((ecx & (1L << 29)) != 0);
+	_mmx_flag      = ((edx & (1L << 23)) != 0);
+	_sse_flag      = ((edx & (1L << 25)) != 0);
+	_sse2_flag     = ((edx & (1L << 26)) != 0);
+	_sse3_flag     = ((ecx & (1L <<  0)) != 0);
+	_ssse3_flag    = ((ecx & (1L <<  9)) != 0);
+	_cx16_flag     = ((ecx & (1L << 13)) != 0);
+	_fma3_flag     = ((ecx & (1L << 16)) != 0);
+	_sse41_flag    = ((ecx & (1L << 19)) != 0);
+	_sse42_flag    = ((ecx & (1L << 20)) != 0);
+	_avx_flag      = ((ecx & (1L << 28)) != 0);
+	_f16c_flag     = ((ecx & (1L << 29)) != 0);
 
 	call_cpuid (0x00000007, eax, ebx, ecx, edx);
-	_avx2_flag    = ((ebx & (1L <<  5)) != 0);
-	_avx512f_flag = ((ebx & (1L << 16)) != 0);
+	_avx2_flag     = ((ebx & (1L <<  5)) != 0);
+	_avx512f_flag  = ((ebx & (1L << 16)) != 0);
+	_avx512bw_flag = ((ebx & (1L << 30)) != 0);
 
 	// Extended features
 	call_cpuid (0x80000000, eax, ebx, ecx, edx);
@@ -81,6 +83,8 @@ CpuId::CpuId ()
 		_fma4_flag    = ((ecx & (1L << 16)) != 0);
 	}
 
+	detect_caches ();
+
 #endif
 }
 
@@ -89,6 +93,14 @@ CpuId::CpuId ()
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 
 void	CpuId::call_cpuid (unsigned int fnc_nbr, unsigned int &v_eax, unsigned int &v_ebx, unsigned int &v_ecx, unsigned int &v_edx)
+{
+	call_cpuid (fnc_nbr, 0, v_eax, v_ebx, v_ecx, v_edx);
+}
+
+
+
+// subfnc_nbr is the value of ecx for the functions having sub-leaves
+void	CpuId::call_cpuid (unsigned int fnc_nbr, unsigned int subfnc_nbr, unsigned int &v_eax, unsigned int &v_ebx, unsigned int &v_ecx, unsigned int &v_edx)
 {
 #if defined (__GNUC__)
 	
@@ -105,7 +117,7 @@ void	CpuId::call_cpuid (unsigned int fnc_nbr, unsigned int &v_eax, unsigned int
 		"mov %%rbx, %1   \n\t" /* save what cpuid just put in %rbx */
 		"pop %%rbx       \n\t" /* restore the old %rbx */
 	  : "=a"(r_eax), "=r"(r_ebx), "=c"(r_ecx), "=d"(r_edx)
-	  : "a"(fnc_nbr)
+	  : "a"(fnc_nbr), "c"(subfnc_nbr)
 	  : "cc");
 
 	#else
@@ -116,7 +128,7 @@ void	CpuId::call_cpuid (unsigned int fnc_nbr, unsigned int &v_eax, unsigned int
 		"movl %%ebx, %1   \n\t" /* save what cpuid just put in %ebx */
 		"popl %%ebx       \n\t" /* restore the old %ebx */
 	  : "=a"(r_eax), "=r"(r_ebx), "=c"(r_ecx), "=d"(r_edx)
-	  : "a"(fnc_nbr)
+	  : "a"(fnc_nbr), "c"(subfnc_nbr)
 	  : "cc");
 
 	#endif
@@ -129,7 +141,7 @@ void	CpuId::call_cpuid (unsigned int fnc_nbr, unsigned int &v_eax, unsigned int
 #elif (_MSC_VER)
 
 	int            cpu_info [4];
-	__cpuid (cpu_info, fnc_nbr);
+	__cpuidex (cpu_info, fnc_nbr, subfnc_nbr);
 	v_eax = cpu_info [0];
 	v_ebx = cpu_info [1];
 	v_ecx = cpu_info [2];
@@ -154,6 +166,70 @@ void	CpuId::call_cpuid (unsigned int fnc_nbr, unsigned int &v_eax, unsigned int
 
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+// Intel processors describe their caches with function 4 (deterministic
+// cache parameters). AMD processors use the extended function 0x80000006,
+// which is also available on Intel for the L2 only.
+void	CpuId::detect_caches ()
+{
+	unsigned int   eax;
+	unsigned int   ebx;
+	unsigned int   ecx;
+	unsigned int   edx;
+
+	call_cpuid (0x00000000, eax, ebx, ecx, edx);
+	const unsigned int   max_fnc = eax;
+	if (max_fnc >= 0x00000004)
+	{
+		bool           cont_flag = true;
+		for (unsigned int index = 0; index < 16 && cont_flag; ++index)
+		{
+			call_cpuid (0x00000004, index, eax, ebx, ecx, edx);
+			const int      type  = eax & 0x1F;
+			cont_flag = (type != 0);
+			if (type == 2 || type == 3)   // Unified or data cache
+			{
+				const int      level = (eax >> 5) & 0x07;
+				const int64_t  ways  = ((ebx >> 22) & 0x3FF) + 1;
+				const int64_t  part  = ((ebx >> 12) & 0x3FF) + 1;
+				const int64_t  line  = ( ebx        & 0xFFF) + 1;
+				const int64_t  sets  = int64_t (ecx) + 1;
+				const int64_t  size  = ways * part * line * sets;
+				if (size < (int64_t (1) << 31))
+				{
+					if (level == 2)
+					{
+						_l2_size = int (size);
+					}
+					else if (level == 3)
+					{
+						_l3_size = int (size);
+					}
+				}
+			}
+		}
+	}
+
+	call_cpuid (0x80000000, eax, ebx, ecx, edx);
+	if (eax >= 0x80000006)
+	{
+		call_cpuid (0x80000006, eax, ebx, ecx, edx);
+		if (_l2_size == 0)
+		{
+			_l2_size = int ((ecx >> 16) & 0xFFFF) << 10;
+		}
+		if (_l3_size == 0 && ((edx >> 18) & 0x3FFF) < 0x1000)
+		{
+			_l3_size = int ((edx >> 18) & 0x3FFF) << 19;
+		}
+	}
+}
+
+#endif
+
+
+
 }	// namespace fstb
 
 
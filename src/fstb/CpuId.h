@@ -51,24 +51,30 @@ public:
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	static void		call_cpuid (unsigned int fnc_nbr, unsigned int &v_eax, unsigned int &v_ebx, unsigned int &v_ecx, unsigned int &v_edx);
+	static void		call_cpuid (unsigned int fnc_nbr, unsigned int subfnc_nbr, unsigned int &v_eax, unsigned int &v_ebx, unsigned int &v_ecx, unsigned int &v_edx);
 #endif
 
-	bool           _mmx_flag     = false;
-	bool           _isse_flag    = false;
-	bool           _sse_flag     = false;
-	bool           _sse2_flag    = false;
-	bool           _sse3_flag    = false;
-	bool           _ssse3_flag   = false;
-	bool           _sse41_flag   = false;
-	bool           _sse42_flag   = false;
-	bool           _sse4a_flag   = false;
-	bool           _fma3_flag    = false;
-	bool           _fma4_flag    = false;
-	bool           _avx_flag     = false;
-	bool           _avx2_flag    = false;
-	bool           _avx512f_flag = false;
-	bool           _f16c_flag    = false;  // Half-precision FP
-	bool           _cx16_flag    = false;  // CMPXCHG16B
+	bool           _mmx_flag      = false;
+	bool           _isse_flag     = false;
+	bool           _sse_flag      = false;
+	bool           _sse2_flag     = false;
+	bool           _sse3_flag     = false;
+	bool           _ssse3_flag    = false;
+	bool           _sse41_flag    = false;
+	bool           _sse42_flag    = false;
+	bool           _sse4a_flag    = false;
+	bool           _fma3_flag     = false;
+	bool           _fma4_flag     = false;
+	bool           _avx_flag      = false;
+	bool           _avx2_flag     = false;
+	bool           _avx512f_flag  = false;
+	bool           _avx512bw_flag = false;  // Byte and word instructions
+	bool           _f16c_flag     = false;  // Half-precision FP
+	bool           _cx16_flag     = false;  // CMPXCHG16B
+
+	// Cache sizes in bytes, 0 if unknown
+	int            _l2_size      = 0;      // Per core
+	int            _l3_size      = 0;      // Whole package, generally shared
 
 
 
@@ -82,6 +88,10 @@ protected:
 
 private:
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	void           detect_caches ();
+#endif
+
 
 
 /*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
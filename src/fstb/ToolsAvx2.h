@@ -91,6 +91,8 @@ public:
 
 	static fstb_FORCEINLINE void
 	               mac_s16_s16_s32 (__m256i &dst0, __m256i &dst1, __m256i src, __m256i coef);
+	static fstb_FORCEINLINE void
+	               mac2_s16_s16_s32 (__m256i &dst0, __m256i &dst1, __m256i src0, __m256i src1, __m256i coef01);
 	static fstb_FORCEINLINE __m256i
 	               mullo_epi32 (const __m256i &a, const __m256i &b);
 	static fstb_FORCEINLINE __m256i
@@ -437,6 +437,23 @@ void	ToolsAvx2::mac_s16_s16_s32 (__m256i &dst0, __m256i &dst1, __m256i src, __m2
 
 
 
+// Same as two calls to mac_s16_s16_s32(), with coef01 containing the
+// coefficients of src0 and src1 interleaved. The results are identical,
+// including the 32-bit wrap-around.
+void	ToolsAvx2::mac2_s16_s16_s32 (__m256i &dst0, __m256i &dst1, __m256i src0, __m256i src1, __m256i coef01)
+{
+	const __m256i  s01_0 = _mm256_unpacklo_epi16 (src0, src1);
+	const __m256i  s01_1 = _mm256_unpackhi_epi16 (src0, src1);
+
+	const __m256i  res0  = _mm256_madd_epi16 (s01_0, coef01);
+	const __m256i  res1  = _mm256_madd_epi16 (s01_1, coef01);
+
+	dst0 = _mm256_add_epi32 (dst0, res0);
+	dst1 = _mm256_add_epi32 (dst1, res1);
+}
+
+
+
 __m256i	ToolsAvx2::mullo_epi32 (const __m256i &a, const __m256i &b)
 {	                                                                // For each 128-bit lane:
 	const __m256i  a13    = _mm256_shuffle_epi32 (a, 0xF5);         // (-,a3,-,a1)
@@ -0,0 +1,123 @@
+/*****************************************************************************
+
+        ToolsAvx512.h
+        Author: agent, 2026
+
+Requires AVX-512F and AVX-512BW. Partial loads and stores are done with
+mask registers, so they never access memory beyond the requested length.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fstb_ToolsAvx512_HEADER_INCLUDED)
+#define	fstb_ToolsAvx512_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+
+
+namespace fstb
+{
+
+
+
+class ToolsAvx512
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static fstb_FORCEINLINE __mmask16
+	               make_mask16 (int len);
+	static fstb_FORCEINLINE __mmask32
+	               make_mask32 (int len);
+	static fstb_FORCEINLINE __mmask64
+	               make_mask64 (int len);
+
+	static fstb_FORCEINLINE __m512i
+	               load_32_16ml (const void *msb_ptr, const void *lsb_ptr);
+	static fstb_FORCEINLINE __m512i
+	               load_32_16l (const void *lsb_ptr);
+	static fstb_FORCEINLINE __m512i
+	               load_32_16ml_partial (const void *msb_ptr, const void *lsb_ptr, int len);
+	static fstb_FORCEINLINE __m512i
+	               load_32_16l_partial (const void *lsb_ptr, int len);
+	static fstb_FORCEINLINE void
+	               store_32_16ml (void *msb_ptr, void *lsb_ptr, __m512i val);
+	static fstb_FORCEINLINE void
+	               store_32_16ml_partial (void *msb_ptr, void *lsb_ptr, __m512i val, int len);
+	static fstb_FORCEINLINE void
+	               store_32_16l (void *lsb_ptr, __m512i val);
+	static fstb_FORCEINLINE void
+	               store_32_16l_partial (void *lsb_ptr, __m512i val, int len);
+
+	static fstb_FORCEINLINE void
+	               mac_s16_s16_s32 (__m512i &dst0, __m512i &dst1, __m512i src, __m512i coef);
+	static fstb_FORCEINLINE void
+	               mac2_s16_s16_s32 (__m512i &dst0, __m512i &dst1, __m512i src0, __m512i src1, __m512i coef01);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               ToolsAvx512 ()                               = delete;
+	               ToolsAvx512 (const ToolsAvx512 &other)       = delete;
+	virtual        ~ToolsAvx512 ()                              = delete;
+	ToolsAvx512 &  operator = (const ToolsAvx512 &other)        = delete;
+	bool           operator == (const ToolsAvx512 &other) const = delete;
+	bool           operator != (const ToolsAvx512 &other) const = delete;
+
+};	// class ToolsAvx512
+
+
+
+}	// namespace fstb
+
+
+
+#include "fstb/ToolsAvx512.hpp"
+
+
+
+#endif	// fstb_ToolsAvx512_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
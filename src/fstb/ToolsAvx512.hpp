@@ -0,0 +1,227 @@
+/*****************************************************************************
+
+        ToolsAvx512.hpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fstb_ToolsAvx512_CODEHEADER_INCLUDED)
+#define	fstb_ToolsAvx512_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+
+
+
+namespace fstb
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// len in [0 ; 16]
+__mmask16	ToolsAvx512::make_mask16 (int len)
+{
+	assert (len >= 0);
+	assert (len <= 16);
+
+	return (__mmask16 ((uint32_t (1) << len) - 1));
+}
+
+
+
+// len in [0 ; 32]
+__mmask32	ToolsAvx512::make_mask32 (int len)
+{
+	assert (len >= 0);
+	assert (len <= 32);
+
+	return (__mmask32 ((uint64_t (1) << len) - 1));
+}
+
+
+
+// len in [0 ; 64]
+__mmask64	ToolsAvx512::make_mask64 (int len)
+{
+	assert (len >= 0);
+	assert (len <= 64);
+
+	return (__mmask64 ((len >= 64) ? ~uint64_t (0) : (uint64_t (1) << len) - 1));
+}
+
+
+
+__m512i	ToolsAvx512::load_32_16ml (const void *msb_ptr, const void *lsb_ptr)
+{
+	assert (msb_ptr != 0);
+	assert (lsb_ptr != 0);
+
+	const __m512i  val_msb = load_32_16l (msb_ptr);
+	const __m512i  val_lsb = load_32_16l (lsb_ptr);
+	const __m512i  val     =
+		_mm512_or_si512 (_mm512_slli_epi16 (val_msb, 8), val_lsb);
+
+	return (val);
+}
+
+
+
+__m512i	ToolsAvx512::load_32_16l (const void *lsb_ptr)
+{
+	assert (lsb_ptr != 0);
+
+	return (_mm512_cvtepu8_epi16 (_mm256_loadu_si256 (
+		reinterpret_cast <const __m256i *> (lsb_ptr)
+	)));
+}
+
+
+
+__m512i	ToolsAvx512::load_32_16ml_partial (const void *msb_ptr, const void *lsb_ptr, int len)
+{
+	assert (msb_ptr != 0);
+	assert (lsb_ptr != 0);
+	assert (len >= 0);
+	assert (len <= 32);
+
+	const __m512i  val_msb = load_32_16l_partial (msb_ptr, len);
+	const __m512i  val_lsb = load_32_16l_partial (lsb_ptr, len);
+	const __m512i  val     =
+		_mm512_or_si512 (_mm512_slli_epi16 (val_msb, 8), val_lsb);
+
+	return (val);
+}
+
+
+
+__m512i	ToolsAvx512::load_32_16l_partial (const void *lsb_ptr, int len)
+{
+	assert (lsb_ptr != 0);
+	assert (len >= 0);
+	assert (len <= 32);
+
+	const __m512i  val_8 = _mm512_maskz_loadu_epi8 (make_mask64 (len), lsb_ptr);
+
+	return (_mm512_cvtepu8_epi16 (_mm512_castsi512_si256 (val_8)));
+}
+
+
+
+void	ToolsAvx512::store_32_16ml (void *msb_ptr, void *lsb_ptr, __m512i val)
+{
+	assert (msb_ptr != 0);
+	assert (lsb_ptr != 0);
+
+	const __m256i  lsb = _mm512_cvtepi16_epi8 (val);
+	const __m256i  msb = _mm512_cvtepi16_epi8 (_mm512_srli_epi16 (val, 8));
+	_mm256_storeu_si256 (reinterpret_cast <__m256i *> (msb_ptr), msb);
+	_mm256_storeu_si256 (reinterpret_cast <__m256i *> (lsb_ptr), lsb);
+}
+
+
+
+void	ToolsAvx512::store_32_16ml_partial (void *msb_ptr, void *lsb_ptr, __m512i val, int len)
+{
+	assert (msb_ptr != 0);
+	assert (lsb_ptr != 0);
+	assert (len >= 0);
+	assert (len <= 32);
+
+	const __mmask32   mask = make_mask32 (len);
+	_mm512_mask_cvtepi16_storeu_epi8 (
+		msb_ptr, mask, _mm512_srli_epi16 (val, 8)
+	);
+	_mm512_mask_cvtepi16_storeu_epi8 (lsb_ptr, mask, val);
+}
+
+
+
+// Stores only the LSBs, the MSBs are ignored.
+void	ToolsAvx512::store_32_16l (void *lsb_ptr, __m512i val)
+{
+	assert (lsb_ptr != 0);
+
+	_mm256_storeu_si256 (
+		reinterpret_cast <__m256i *> (lsb_ptr),
+		_mm512_cvtepi16_epi8 (val)
+	);
+}
+
+
+
+void	ToolsAvx512::store_32_16l_partial (void *lsb_ptr, __m512i val, int len)
+{
+	assert (lsb_ptr != 0);
+	assert (len >= 0);
+	assert (len <= 32);
+
+	_mm512_mask_cvtepi16_storeu_epi8 (lsb_ptr, make_mask32 (len), val);
+}
+
+
+
+// The results are interleaved within each 128-bit lane, like the AVX2
+// version. _mm512_packs_epi32 (dst0, dst1) restores the original order.
+void	ToolsAvx512::mac_s16_s16_s32 (__m512i &dst0, __m512i &dst1, __m512i src, __m512i coef)
+{
+	const __m512i  hi = _mm512_mulhi_epi16 (src, coef);
+	const __m512i  lo = _mm512_mullo_epi16 (src, coef);
+
+	const __m512i  res0 = _mm512_unpacklo_epi16 (lo, hi);
+	const __m512i  res1 = _mm512_unpackhi_epi16 (lo, hi);
+
+	dst0 = _mm512_add_epi32 (dst0, res0);
+	dst1 = _mm512_add_epi32 (dst1, res1);
+}
+
+
+
+// Same as two calls to mac_s16_s16_s32(), like the AVX2 version.
+void	ToolsAvx512::mac2_s16_s16_s32 (__m512i &dst0, __m512i &dst1, __m512i src0, __m512i src1, __m512i coef01)
+{
+	const __m512i  s01_0 = _mm512_unpacklo_epi16 (src0, src1);
+	const __m512i  s01_1 = _mm512_unpackhi_epi16 (src0, src1);
+
+	const __m512i  res0  = _mm512_madd_epi16 (s01_0, coef01);
+	const __m512i  res1  = _mm512_madd_epi16 (s01_1, coef01);
+
+	dst0 = _mm512_add_epi32 (dst0, res0);
+	dst1 = _mm512_add_epi32 (dst1, res1);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fstb
+
+
+
+#endif	// fstb_ToolsAvx512_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
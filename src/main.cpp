@@ -505,6 +505,10 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit (::VSConfigPlugin config_fnc, ::VSR
 		"tffd:int:opt;"
 		"flt:int:opt;"
 		"cpuopt:int:opt;"
+		"mtplanes:int:opt;"
+		"tilesize:int:opt;"
+		"taskstats:int:opt;"
+		"fma:int:opt;"
 		, &vsutl::Redirect <fmtc::Resample>::create, 0, plugin_ptr
 	);
 
@@ -521,6 +525,7 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit (::VSConfigPlugin config_fnc, ::VSR
 		"bits:int:opt;"
 		"singleout:int:opt;"
 		"cpuopt:int:opt;"
+		"fma:int:opt;"
 		, &vsutl::Redirect <fmtc::Matrix>::create, 0, plugin_ptr
 	);
 
@@ -548,6 +553,8 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit (::VSConfigPlugin config_fnc, ::VSR
 		"staticnoise:int:opt;"
 		"cpuopt:int:opt;"
 		"patsize:int:opt;"
+		"mtplanes:int:opt;"
+		"fma:int:opt;"
 		, &vsutl::Redirect <fmtc::Bitdepth>::create, 0, plugin_ptr
 	);
 
@@ -563,6 +570,7 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit (::VSConfigPlugin config_fnc, ::VSR
 		"fulld:int:opt;"
 		"cpuopt:int:opt;"
 		"blacklvl:float:opt;"
+		"mtplanes:int:opt;"
 		, &vsutl::Redirect <fmtc::Transfer>::create, 0, plugin_ptr
 	);
 
@@ -579,6 +587,7 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit (::VSConfigPlugin config_fnc, ::VSR
 		"prims:data:opt;"
 		"primd:data:opt;"
 		"cpuopt:int:opt;"
+		"fma:int:opt;"
 		, &vsutl::Redirect <fmtc::Primaries>::create, 0, plugin_ptr
 	);
 
@@ -664,11 +673,13 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit (::VSConfigPlugin config_fnc, ::VSR
 
 	register_fnc ("stack16tonative",
 		"clip:clip;"
+		"cpuopt:int:opt;"
 		, &vsutl::Redirect <fmtc::Stack16ToNative>::create, 0, plugin_ptr
 	);
 
 	register_fnc ("nativetostack16",
 		"clip:clip;"
+		"cpuopt:int:opt;"
 		, &vsutl::Redirect <fmtc::NativeToStack16>::create, 0, plugin_ptr
 	);
 
@@ -159,6 +159,13 @@ bool	CpuOpt::has_avx512f () const
 
 
 
+bool	CpuOpt::has_avx512bw () const
+{
+	return (_cpu._avx512bw_flag && _level >= Level_AVX512F);
+}
+
+
+
 bool	CpuOpt::has_f16c () const
 {
 	return (_cpu._f16c_flag && _level >= Level_F16C);
@@ -26,6 +26,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fstb/fnc.h"
 #include "vsutl/FilterBase.h"
+#include "AvstpWrapper.h"
 
 #include <algorithm>
 #include <stdexcept>
@@ -51,6 +52,17 @@ FilterBase::FilterBase (const ::VSAPI &vsapi, const char name_0 [], ::VSFilterMo
 ,	_filter_flags (flags)
 {
 	assert (name_0 != 0);
+
+	// Keeps the thread pool running as long as there are filters. It is
+	// stopped when the last filter is freed.
+	AvstpWrapper::use_instance ().add_user ();
+}
+
+
+
+FilterBase::~FilterBase ()
+{
+	AvstpWrapper::use_instance ().remove_user ();
 }
 
 
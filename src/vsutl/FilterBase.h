@@ -50,7 +50,7 @@ public:
 	               _max_error_buf_len = 4096;
 
 	explicit       FilterBase (const ::VSAPI &vsapi, const char name_0 [], ::VSFilterMode filter_mode, int /* ::NodeFlags */ flags);
-	virtual        ~FilterBase () = default;
+	virtual        ~FilterBase ();
 
 	const std::string &
 	               use_filter_name () const;
@@ -59,6 +59,17 @@ int	PlaneProcCbInterface::process_plane (::VSFrameRef &dst, int n, int plane_ind
 
 
 
+int	PlaneProcCbInterface::process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void *frame_data_ptr)
+{
+	assert (buf._dst_ptr != 0);
+	assert (n >= 0);
+	assert (plane_index >= 0);
+
+	return (do_process_plane_buf (buf, n, plane_index, frame_data_ptr));
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -29,6 +29,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "vsutl/NodeRefSPtr.h"
 
+#include <cstdint>
+
 
 
 struct VSCore;
@@ -49,9 +51,25 @@ class PlaneProcCbInterface
 
 public:
 
+	// Plane data fetched from the frames by the calling thread
+	class PlaneBuf
+	{
+	public:
+		uint8_t *      _dst_ptr;
+		int            _dst_stride;   // Bytes
+		int            _dst_w;
+		int            _dst_h;
+		const uint8_t *               // From the first source clip
+		               _src_ptr;
+		int            _src_stride;   // Bytes
+		int            _src_w;
+		int            _src_h;
+	};
+
 	virtual        ~PlaneProcCbInterface () = default;
 
 	int            process_plane (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const NodeRefSPtr &src_node1_sptr, const NodeRefSPtr &src_node2_sptr, const NodeRefSPtr &src_node3_sptr);
+	int            process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void *frame_data_ptr);
 
 
 
@@ -61,6 +79,10 @@ protected:
 
 	virtual int    do_process_plane (::VSFrameRef &dst, int n, int plane_index, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const NodeRefSPtr &src_node1_sptr, const NodeRefSPtr &src_node2_sptr, const NodeRefSPtr &src_node3_sptr) = 0;
 
+	// Called from any thread, without access to the VapourSynth API.
+	// Errors are reported by throwing an exception.
+	virtual int    do_process_plane_buf (const PlaneBuf &buf, int n, int plane_index, void *frame_data_ptr) = 0;
+
 
 
 };	// class PlaneProcCbInterface
@@ -28,9 +28,12 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "vsutl/PlaneProcCbInterface.h"
 #include "vsutl/PlaneProcessor.h"
 #include "vsutl/PlaneProcMode.h"
+#include "AvstpScopedDispatcher.h"
+#include "AvstpWrapper.h"
 #include "VapourSynth.h"
 
 #include <algorithm>
+#include <exception>
 
 #include <cassert>
 #include <cstdint>
@@ -61,6 +64,7 @@ PlaneProcessor::PlaneProcessor (const ::VSAPI &vsapi, PlaneProcCbInterface &cb,
 ,	_manual_flag (manual_flag)
 ,	_input_flag (false)
 ,	_blank_frame_sptr ()
+,	_mt_flag (false)
 {
 	assert (filter_name_0 != 0);
 }
@@ -201,6 +205,17 @@ void	PlaneProcessor::set_filter (const ::VSMap &in, ::VSMap &out, const ::VSVide
 
 
 
+// When enabled, the planes to be processed are dispatched as concurrent
+// tasks to reduce the latency of a single frame. The tasks are run through
+// PlaneProcCbInterface::do_process_plane_buf(), which must be thread-safe.
+// Copied and filled planes are still handled by the calling thread.
+void	PlaneProcessor::set_mt_planes (bool mt_flag)
+{
+	_mt_flag = mt_flag;
+}
+
+
+
 // To be called in arInitial mode, but not in manual mode
 // Returns 0 if input frames are needed.
 const ::VSFrameRef *	PlaneProcessor::try_initial (::VSCore &core)
@@ -255,46 +270,43 @@ int	PlaneProcessor::process_frame (::VSFrameRef &dst, int n, void *frame_data_pt
 
 	int            ret_val = 0;
 
-	for (int plane_index = 0
-	;	plane_index < _nbr_planes && ret_val == 0
-	;	++plane_index)
+	if (_mt_flag)
 	{
-		const double   mode   = _proc_mode_arr [plane_index];
-		const int      mode_i = fstb::round_int (mode);
+		ret_val = process_frame_mt (
+			dst, n, frame_data_ptr, frame_ctx, core,
+			src_node1_sptr, src_node2_sptr, src_node3_sptr
+		);
+	}
 
-		if (_manual_flag || mode_i == PlaneProcMode_PROCESS)
-		{
-			ret_val = _cb.process_plane (
-				dst,
-				n,
-				plane_index,
-				frame_data_ptr,
-				frame_ctx,
-				core,
-				src_node1_sptr,
-				src_node2_sptr,
-				src_node3_sptr
-			);
-		}
-		else if (mode_i >= PlaneProcMode_COPY1 && mode_i <= PlaneProcMode_COPY3)
+	else
+	{
+		for (int plane_index = 0
+		;	plane_index < _nbr_planes && ret_val == 0
+		;	++plane_index)
 		{
-			NodeRefSPtr    src_clip_sptr (
-				  (mode_i == PlaneProcMode_COPY3) ? src_node3_sptr
-				: (mode_i == PlaneProcMode_COPY2) ? src_node2_sptr
-				:                                   src_node1_sptr);
-			if (src_clip_sptr.get () != 0)
+			const int      mode_i = fstb::round_int (_proc_mode_arr [plane_index]);
+
+			if (_manual_flag || mode_i == PlaneProcMode_PROCESS)
 			{
-				FrameRefSPtr   src_sptr (
-					_vsapi.getFrameFilter (n, src_clip_sptr.get (), &frame_ctx),
-					_vsapi
+				ret_val = _cb.process_plane (
+					dst,
+					n,
+					plane_index,
+					frame_data_ptr,
+					frame_ctx,
+					core,
+					src_node1_sptr,
+					src_node2_sptr,
+					src_node3_sptr
+				);
+			}
+			else
+			{
+				copy_or_fill_plane (
+					dst, n, plane_index, frame_ctx,
+					src_node1_sptr, src_node2_sptr, src_node3_sptr
 				);
-
-				copy_plane (dst, *src_sptr, plane_index);
 			}
-		}
-		else if (mode < PlaneProcMode_COPY1)
-		{
-			fill_plane (dst, -mode, plane_index);
 		}
 	}
 
@@ -422,6 +434,35 @@ void	PlaneProcessor::copy_plane (::VSFrameRef &dst, const ::VSFrameRef &src, int
 
 
 
+// src_ptr may be 0, the source fields are cleared in this case.
+void	PlaneProcessor::get_plane_buf (PlaneProcCbInterface::PlaneBuf &buf, ::VSFrameRef &dst, const ::VSFrameRef *src_ptr, int plane_index) const
+{
+	assert (plane_index >= 0);
+	assert (plane_index < _nbr_planes);
+
+	buf._dst_ptr    = _vsapi.getWritePtr (&dst, plane_index);
+	buf._dst_stride = _vsapi.getStride (&dst, plane_index);
+	buf._dst_w      = _vsapi.getFrameWidth (&dst, plane_index);
+	buf._dst_h      = _vsapi.getFrameHeight (&dst, plane_index);
+
+	if (src_ptr != 0)
+	{
+		buf._src_ptr    = _vsapi.getReadPtr (src_ptr, plane_index);
+		buf._src_stride = _vsapi.getStride (src_ptr, plane_index);
+		buf._src_w      = _vsapi.getFrameWidth (src_ptr, plane_index);
+		buf._src_h      = _vsapi.getFrameHeight (src_ptr, plane_index);
+	}
+	else
+	{
+		buf._src_ptr    = 0;
+		buf._src_stride = 0;
+		buf._src_w      = 0;
+		buf._src_h      = 0;
+	}
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -430,6 +471,187 @@ void	PlaneProcessor::copy_plane (::VSFrameRef &dst, const ::VSFrameRef &src, int
 
 
 
+// The planes to process are enqueued first, so the copies and fills can be
+// done by the calling thread in the meantime. The frames and the plane
+// pointers are fetched beforehand on the calling thread, the tasks never
+// access the VapourSynth API.
+// Returns 0 if all the planes were processed successfully, otherwise the
+// error code of the first failing plane.
+int	PlaneProcessor::process_frame_mt (::VSFrameRef &dst, int n, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const NodeRefSPtr &src_node1_sptr, const NodeRefSPtr &src_node2_sptr, const NodeRefSPtr &src_node3_sptr)
+{
+	FrameTask      ft;
+	ft._this_ptr       = this;
+	ft._n              = n;
+	ft._frame_data_ptr = frame_data_ptr;
+
+	FrameRefSPtr   src_sptr;
+	PlaneTask      task_arr [MAX_NBR_PLANES];
+	int            nbr_tasks = 0;
+	for (int plane_index = 0; plane_index < _nbr_planes; ++plane_index)
+	{
+		const int      mode_i = fstb::round_int (_proc_mode_arr [plane_index]);
+		if (mode_i == PlaneProcMode_PROCESS)
+		{
+			if (src_sptr.get () == 0 && src_node1_sptr.get () != 0)
+			{
+				src_sptr = FrameRefSPtr (
+					_vsapi.getFrameFilter (n, src_node1_sptr.get (), &frame_ctx),
+					_vsapi
+				);
+			}
+
+			PlaneTask &    task = task_arr [nbr_tasks];
+			task._frame_task_ptr = &ft;
+			task._plane_index    = plane_index;
+			task._ret_val        = 0;
+			get_plane_buf (task._buf, dst, src_sptr.get (), plane_index);
+			++ nbr_tasks;
+		}
+	}
+
+	// A single plane doesn't need to go through the dispatcher
+	AvstpWrapper & avstp = AvstpWrapper::use_instance ();
+	AvstpScopedDispatcher   task_dispatcher (avstp);
+	if (nbr_tasks > 1)
+	{
+		for (int task_cnt = 0; task_cnt < nbr_tasks; ++task_cnt)
+		{
+			const int      ret_val_enq = avstp.enqueue_task (
+				task_dispatcher.get_ptr (),
+				&redirect_task_plane,
+				&task_arr [task_cnt]
+			);
+			if (ret_val_enq != avstp_Err_OK)
+			{
+				// Not fatal, the plane is processed on the calling thread.
+				process_plane_task (task_arr [task_cnt]);
+			}
+		}
+	}
+
+	// In manual mode, the callback handles the copies and fills itself.
+	int            ret_val_cb = 0;
+	for (int plane_index = 0; plane_index < _nbr_planes; ++plane_index)
+	{
+		const int      mode_i = fstb::round_int (_proc_mode_arr [plane_index]);
+		if (mode_i != PlaneProcMode_PROCESS)
+		{
+			if (_manual_flag)
+			{
+				const int      ret_val_plane = _cb.process_plane (
+					dst,
+					n,
+					plane_index,
+					frame_data_ptr,
+					frame_ctx,
+					core,
+					src_node1_sptr,
+					src_node2_sptr,
+					src_node3_sptr
+				);
+				if (ret_val_cb == 0)
+				{
+					ret_val_cb = ret_val_plane;
+				}
+			}
+			else
+			{
+				copy_or_fill_plane (
+					dst, n, plane_index, frame_ctx,
+					src_node1_sptr, src_node2_sptr, src_node3_sptr
+				);
+			}
+		}
+	}
+
+	if (nbr_tasks > 1)
+	{
+		avstp.wait_completion (task_dispatcher.get_ptr ());
+	}
+	else if (nbr_tasks == 1)
+	{
+		process_plane_task (task_arr [0]);
+	}
+
+	int            ret_val = 0;
+	for (int task_cnt = 0; task_cnt < nbr_tasks && ret_val == 0; ++task_cnt)
+	{
+		const PlaneTask & task = task_arr [task_cnt];
+		ret_val = task._ret_val;
+		if (! task._err_msg.empty ())
+		{
+			_vsapi.setFilterError (task._err_msg.c_str (), &frame_ctx);
+		}
+	}
+	if (ret_val == 0)
+	{
+		ret_val = ret_val_cb;
+	}
+
+	return (ret_val);
+}
+
+
+
+void	PlaneProcessor::copy_or_fill_plane (::VSFrameRef &dst, int n, int plane_index, ::VSFrameContext &frame_ctx, const NodeRefSPtr &src_node1_sptr, const NodeRefSPtr &src_node2_sptr, const NodeRefSPtr &src_node3_sptr)
+{
+	const double   mode   = _proc_mode_arr [plane_index];
+	const int      mode_i = fstb::round_int (mode);
+
+	if (mode_i >= PlaneProcMode_COPY1 && mode_i <= PlaneProcMode_COPY3)
+	{
+		const NodeRefSPtr &  src_clip_sptr (
+			  (mode_i == PlaneProcMode_COPY3) ? src_node3_sptr
+			: (mode_i == PlaneProcMode_COPY2) ? src_node2_sptr
+			:                                   src_node1_sptr);
+		if (src_clip_sptr.get () != 0)
+		{
+			FrameRefSPtr   src_sptr (
+				_vsapi.getFrameFilter (n, src_clip_sptr.get (), &frame_ctx),
+				_vsapi
+			);
+
+			copy_plane (dst, *src_sptr, plane_index);
+		}
+	}
+	else if (mode < PlaneProcMode_COPY1)
+	{
+		fill_plane (dst, -mode, plane_index);
+	}
+}
+
+
+
+// Exceptions must not escape the task: some dispatcher implementations
+// cannot report them to the waiting thread. The error message is kept for
+// the calling thread, which is the only one allowed to report it.
+void	PlaneProcessor::process_plane_task (PlaneTask &task)
+{
+	const FrameTask & ft = *task._frame_task_ptr;
+
+	try
+	{
+		task._ret_val = _cb.process_plane_buf (
+			task._buf,
+			ft._n,
+			task._plane_index,
+			ft._frame_data_ptr
+		);
+	}
+	catch (std::exception &e)
+	{
+		task._err_msg = e.what ();
+		task._ret_val = -1;
+	}
+	catch (...)
+	{
+		task._err_msg = _filter_name + ": exception.";
+		task._ret_val = -1;
+	}
+}
+
+
+
 template <class T>
 void	PlaneProcessor::fill_plane (void *ptr, T val, int stride, int w, int h)
 {
@@ -468,6 +690,16 @@ void	PlaneProcessor::fill_plane (void *ptr, T val, int stride, int w, int h)
 
 
 
+void	PlaneProcessor::redirect_task_plane (avstp_TaskDispatcher * /*dispatcher_ptr*/, void *data_ptr)
+{
+	PlaneTask *    task_ptr = reinterpret_cast <PlaneTask *> (data_ptr);
+	PlaneProcessor *  this_ptr = task_ptr->_frame_task_ptr->_this_ptr;
+
+	this_ptr->process_plane_task (*task_ptr);
+}
+
+
+
 }	// namespace vsutl
 
 
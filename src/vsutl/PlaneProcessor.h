@@ -42,7 +42,9 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "vsutl/NodeRefSPtr.h"
 #include "vsutl/FrameRefSPtr.h"
+#include "vsutl/PlaneProcCbInterface.h"
 #include "vsutl/PlaneProcMode.h"
+#include "avstp.h"
 
 #include <string>
 
@@ -62,8 +64,6 @@ namespace vsutl
 
 
 
-class PlaneProcCbInterface;
-
 class PlaneProcessor
 {
 
@@ -78,6 +78,7 @@ public:
 	virtual        ~PlaneProcessor () {}
 
 	void           set_filter (const ::VSMap &in, ::VSMap &out, const ::VSVideoInfo &vi_out, bool simple_flag = false, int max_def_planes = 3, const char *prop_name_0 = "planes", const char *clip_name_0 = "clip");
+	void           set_mt_planes (bool mt_flag);
 
 	const ::VSFrameRef *
 	               try_initial (::VSCore &core);
@@ -90,6 +91,7 @@ public:
 
 	void           fill_plane (::VSFrameRef &dst, double val, int plane_index);
 	void           copy_plane (::VSFrameRef &dst, const ::VSFrameRef &src, int plane_index);
+	void           get_plane_buf (PlaneProcCbInterface::PlaneBuf &buf, ::VSFrameRef &dst, const ::VSFrameRef *src_ptr, int plane_index) const;
 
 
 
@@ -103,9 +105,38 @@ protected:
 
 private:
 
+	// Data shared by all the plane tasks of a frame
+	class FrameTask
+	{
+	public:
+		PlaneProcessor *
+		               _this_ptr;
+		int            _n;
+		void *         _frame_data_ptr;
+	};
+
+	// The tasks only get raw plane pointers, they never call the API.
+	class PlaneTask
+	{
+	public:
+		const FrameTask *
+		               _frame_task_ptr;
+		int            _plane_index;
+		PlaneProcCbInterface::PlaneBuf
+		               _buf;
+		int            _ret_val;
+		std::string    _err_msg;      // Reported by the calling thread
+	};
+
+	int            process_frame_mt (::VSFrameRef &dst, int n, void *frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core, const NodeRefSPtr &src_node1_sptr, const NodeRefSPtr &src_node2_sptr, const NodeRefSPtr &src_node3_sptr);
+	void           copy_or_fill_plane (::VSFrameRef &dst, int n, int plane_index, ::VSFrameContext &frame_ctx, const NodeRefSPtr &src_node1_sptr, const NodeRefSPtr &src_node2_sptr, const NodeRefSPtr &src_node3_sptr);
+	void           process_plane_task (PlaneTask &task);
+
 	template <class T>
 	void           fill_plane (void *ptr, T val, int stride, int w, int h);
 
+	static void    redirect_task_plane (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr);
+
 
 	const ::VSAPI& _vsapi;
 	const std::string
@@ -118,6 +149,7 @@ private:
 	bool           _manual_flag;
 	bool				_input_flag;  // Indicates that we need an input (at least one copy or process)
 	FrameRefSPtr   _blank_frame_sptr;
+	bool           _mt_flag;     // Planes to process are dispatched concurrently
 
 
 
@@ -0,0 +1,158 @@
+/*****************************************************************************
+
+        StripeScheduler.cpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "vsutl/StripeScheduler.h"
+#include "AvstpScopedDispatcher.h"
+#include "AvstpWrapper.h"
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace vsutl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+StripeScheduler::StripeScheduler ()
+:	_avstp (AvstpWrapper::use_instance ())
+,	_task_pool ()
+{
+	_task_pool.expand_to (256);
+}
+
+
+
+// row_bytes: source and destination data size for a single row, all planes
+// included.
+// Returns h if the frame should not be split.
+int	StripeScheduler::compute_stripe_height (int h, int row_bytes) const
+{
+	assert (h > 0);
+	assert (row_bytes >= 0);
+
+	const int      nbr_threads = _avstp.get_nbr_threads ();
+	int            stripe_h    = h;
+	if (nbr_threads > 1)
+	{
+		const int      h_cache  = STRIPE_BYTES / std::max (row_bytes, 1);
+		const int      h_thread = (h + nbr_threads - 1) / nbr_threads;
+		stripe_h = std::min (h_cache, h_thread);
+		stripe_h = std::max (stripe_h, int (MIN_STRIPE_H));
+		stripe_h = std::min (stripe_h, h);
+	}
+
+	return (stripe_h);
+}
+
+
+
+void	StripeScheduler::process (ProcPtr proc_ptr, void *user_data_ptr, int h, int row_bytes)
+{
+	assert (proc_ptr != 0);
+	assert (h > 0);
+	assert (row_bytes >= 0);
+
+	const int      stripe_h = compute_stripe_height (h, row_bytes);
+	if (stripe_h >= h)
+	{
+		proc_ptr (user_data_ptr, 0, h);
+	}
+
+	else
+	{
+		AvstpScopedDispatcher   task_dispatcher (_avstp);
+
+		for (int y_beg = 0; y_beg < h; y_beg += stripe_h)
+		{
+			const int      y_end = std::min (y_beg + stripe_h, h);
+
+			// The cell will be returned to the pool by the task.
+			TaskCell *     cell_ptr = _task_pool.take_cell (true);
+			if (cell_ptr == 0)
+			{
+				// Not fatal, we just lose some parallelism.
+				proc_ptr (user_data_ptr, y_beg, y_end);
+			}
+			else
+			{
+				Task &         task = cell_ptr->_val;
+				task._this_ptr      = this;
+				task._proc_ptr      = proc_ptr;
+				task._user_data_ptr = user_data_ptr;
+				task._y_beg         = y_beg;
+				task._y_end         = y_end;
+
+				const int      ret_val = _avstp.enqueue_task (
+					task_dispatcher.get_ptr (),
+					&redirect_task,
+					cell_ptr
+				);
+				if (ret_val != avstp_Err_OK)
+				{
+					// Same as above
+					_task_pool.return_cell (*cell_ptr);
+					proc_ptr (user_data_ptr, y_beg, y_end);
+				}
+			}
+		}
+
+		_avstp.wait_completion (task_dispatcher.get_ptr ());
+	}
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	StripeScheduler::redirect_task (avstp_TaskDispatcher * /*dispatcher_ptr*/, void *data_ptr)
+{
+	TaskCell *     cell_ptr = reinterpret_cast <TaskCell *> (data_ptr);
+	const Task     task     = cell_ptr->_val;
+	task._this_ptr->_task_pool.return_cell (*cell_ptr);
+
+	task._proc_ptr (task._user_data_ptr, task._y_beg, task._y_end);
+}
+
+
+
+}	// namespace vsutl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
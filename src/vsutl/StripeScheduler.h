@@ -0,0 +1,172 @@
+/*****************************************************************************
+
+        StripeScheduler.h
+        Author: agent, 2026
+
+Splits a frame-wide point operation into horizontal stripes and runs them
+as tasks on the AVSTP dispatcher.
+
+The stripe height is chosen so the data read and written by a stripe fits
+in the cache, while giving at least one stripe per thread. Small frames are
+processed in a single call, without going through the dispatcher.
+
+The processing function receives the row range it has to handle. Because
+the stripes are processed independently, it cannot be used with Stack16
+formats, whose lsb part location depends on the full frame height.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (vsutl_StripeScheduler_HEADER_INCLUDED)
+#define	vsutl_StripeScheduler_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma once
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "conc/CellPool.h"
+#include "avstp.h"
+
+#include <cstdint>
+
+
+
+class AvstpWrapper;
+
+namespace vsutl
+{
+
+
+
+class StripeScheduler
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	// Processes rows [y_beg ; y_end[
+	typedef void (*ProcPtr) (void *user_data_ptr, int y_beg, int y_end);
+
+	static const int  STRIPE_BYTES = 256 * 1024; // Target source + destination data size for a stripe
+	static const int  MIN_STRIPE_H = 8;          // Rows
+
+	               StripeScheduler ();
+	virtual        ~StripeScheduler () {}
+
+	int            compute_stripe_height (int h, int row_bytes) const;
+	void           process (ProcPtr proc_ptr, void *user_data_ptr, int h, int row_bytes);
+
+	// Helpers for the fmtcl processors.
+	// All stride values are in bytes.
+	template <class P>
+	void           process_planes (const P &proc, uint8_t * const dst_ptr_arr [P::NBR_PLANES], const int dst_str_arr [P::NBR_PLANES], const uint8_t * const src_ptr_arr [P::NBR_PLANES], const int src_str_arr [P::NBR_PLANES], int w, int h);
+	template <class P>
+	void           process_plane (P &proc, uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	class Task
+	{
+	public:
+		StripeScheduler *
+		               _this_ptr;
+		ProcPtr        _proc_ptr;
+		void *         _user_data_ptr;
+		int            _y_beg;
+		int            _y_end;
+	};
+
+	typedef conc::CellPool <Task> TaskPool;
+	typedef TaskPool::CellType TaskCell;
+
+	template <class P>
+	class CtxPlanes
+	{
+	public:
+		const P *      _proc_ptr;
+		uint8_t * const *
+		               _dst_ptr_arr;
+		const int *    _dst_str_arr;
+		const uint8_t * const *
+		               _src_ptr_arr;
+		const int *    _src_str_arr;
+		int            _w;
+	};
+
+	template <class P>
+	class CtxPlane
+	{
+	public:
+		P *            _proc_ptr;
+		uint8_t *      _dst_ptr;
+		const uint8_t *
+		               _src_ptr;
+		int            _stride_dst;
+		int            _stride_src;
+		int            _w;
+	};
+
+	template <class P>
+	static void    redirect_planes (void *user_data_ptr, int y_beg, int y_end);
+	template <class P>
+	static void    redirect_plane (void *user_data_ptr, int y_beg, int y_end);
+
+	static void    redirect_task (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr);
+
+	AvstpWrapper & _avstp;
+	TaskPool       _task_pool;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               StripeScheduler (const StripeScheduler &other)   = delete;
+	StripeScheduler &
+	               operator = (const StripeScheduler &other)        = delete;
+	bool           operator == (const StripeScheduler &other) const = delete;
+	bool           operator != (const StripeScheduler &other) const = delete;
+
+};	// class StripeScheduler
+
+
+
+}	// namespace vsutl
+
+
+
+#include "vsutl/StripeScheduler.hpp"
+
+
+
+#endif	// vsutl_StripeScheduler_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
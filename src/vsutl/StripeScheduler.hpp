@@ -0,0 +1,158 @@
+/*****************************************************************************
+
+        StripeScheduler.hpp
+        Author: agent, 2026
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (vsutl_StripeScheduler_CODEHEADER_INCLUDED)
+#define	vsutl_StripeScheduler_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+#include <cstdlib>
+
+
+
+namespace vsutl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// P should provide:
+// void process (uint8_t * const dst_ptr_arr [NBR_PLANES], const int dst_str_arr [NBR_PLANES], const uint8_t * const src_ptr_arr [NBR_PLANES], const int src_str_arr [NBR_PLANES], int w, int h) const;
+// Null plane pointers are left as they are.
+template <class P>
+void	StripeScheduler::process_planes (const P &proc, uint8_t * const dst_ptr_arr [P::NBR_PLANES], const int dst_str_arr [P::NBR_PLANES], const uint8_t * const src_ptr_arr [P::NBR_PLANES], const int src_str_arr [P::NBR_PLANES], int w, int h)
+{
+	assert (dst_ptr_arr != 0);
+	assert (dst_str_arr != 0);
+	assert (src_ptr_arr != 0);
+	assert (src_str_arr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	int            row_bytes = 0;
+	for (int p = 0; p < P::NBR_PLANES; ++p)
+	{
+		row_bytes += std::abs (dst_str_arr [p]) + std::abs (src_str_arr [p]);
+	}
+
+	CtxPlanes <P>  ctx;
+	ctx._proc_ptr    = &proc;
+	ctx._dst_ptr_arr = dst_ptr_arr;
+	ctx._dst_str_arr = dst_str_arr;
+	ctx._src_ptr_arr = src_ptr_arr;
+	ctx._src_str_arr = src_str_arr;
+	ctx._w           = w;
+
+	process (&redirect_planes <P>, &ctx, h, row_bytes);
+}
+
+
+
+// P should provide:
+// void process_plane (uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h);
+template <class P>
+void	StripeScheduler::process_plane (P &proc, uint8_t *dst_ptr, const uint8_t *src_ptr, int stride_dst, int stride_src, int w, int h)
+{
+	assert (dst_ptr != 0);
+	assert (src_ptr != 0);
+	assert (w > 0);
+	assert (h > 0);
+
+	CtxPlane <P>   ctx;
+	ctx._proc_ptr   = &proc;
+	ctx._dst_ptr    = dst_ptr;
+	ctx._src_ptr    = src_ptr;
+	ctx._stride_dst = stride_dst;
+	ctx._stride_src = stride_src;
+	ctx._w          = w;
+
+	const int      row_bytes = std::abs (stride_dst) + std::abs (stride_src);
+	process (&redirect_plane <P>, &ctx, h, row_bytes);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+template <class P>
+void	StripeScheduler::redirect_planes (void *user_data_ptr, int y_beg, int y_end)
+{
+	const CtxPlanes <P> &   ctx =
+		*reinterpret_cast <const CtxPlanes <P> *> (user_data_ptr);
+
+	uint8_t *      dst_ptr_arr [P::NBR_PLANES];
+	const uint8_t* src_ptr_arr [P::NBR_PLANES];
+	for (int p = 0; p < P::NBR_PLANES; ++p)
+	{
+		dst_ptr_arr [p] =
+			  (ctx._dst_ptr_arr [p] == 0)
+			? 0
+			: ctx._dst_ptr_arr [p] + y_beg * ctx._dst_str_arr [p];
+		src_ptr_arr [p] =
+			  (ctx._src_ptr_arr [p] == 0)
+			? 0
+			: ctx._src_ptr_arr [p] + y_beg * ctx._src_str_arr [p];
+	}
+
+	ctx._proc_ptr->process (
+		dst_ptr_arr, ctx._dst_str_arr,
+		src_ptr_arr, ctx._src_str_arr,
+		ctx._w, y_end - y_beg
+	);
+}
+
+
+
+template <class P>
+void	StripeScheduler::redirect_plane (void *user_data_ptr, int y_beg, int y_end)
+{
+	const CtxPlane <P> & ctx =
+		*reinterpret_cast <const CtxPlane <P> *> (user_data_ptr);
+
+	ctx._proc_ptr->process_plane (
+		ctx._dst_ptr + y_beg * ctx._stride_dst,
+		ctx._src_ptr + y_beg * ctx._stride_src,
+		ctx._stride_dst,
+		ctx._stride_src,
+		ctx._w,
+		y_end - y_beg
+	);
+}
+
+
+
+}	// namespace vsutl
+
+
+
+#endif	// vsutl_StripeScheduler_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/